@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Ubpa::UFG {
+	// compile frozen snapshots of frame graphs on a background thread.
+	// the frame loop keeps using the last published snapshot (Acquire) until a newer one is ready,
+	// a submission supersedes the older ones, the stale ones are cancelled and never published
+	class AsyncCompiler {
+	public:
+		struct Snapshot {
+			FrameGraph fg;
+			Compiler::Result result;
+			uint64_t generation;
+		};
+
+		// nullptr : cancelled
+		using Future = std::shared_future<std::shared_ptr<const Snapshot>>;
+		// called on the background thread after publishing, before the future is ready.
+		// if it throws, the future rethrows the exception (the snapshot stays published)
+		using Callback = std::function<void(const std::shared_ptr<const Snapshot>&)>;
+
+		AsyncCompiler(Compiler compiler = {});
+		~AsyncCompiler();
+
+		AsyncCompiler(const AsyncCompiler&) = delete;
+		AsyncCompiler& operator=(const AsyncCompiler&) = delete;
+
+		// the future throws std::logic_error when the compilation fails, the published snapshot is kept
+		Future Submit(FrameGraph fg, Callback callback = {});
+		// compiled with the options (e.g. the pass costs of the last frames, see PassCostModel)
+		Future Submit(FrameGraph fg, Compiler::Options options, Callback callback = {});
+
+		// cancel the pending and the running compilations
+		void Cancel();
+
+		// the last published snapshot, nullptr before the first one, doesn't wait for the compilation
+		std::shared_ptr<const Snapshot> Acquire() const { return published.load(std::memory_order_acquire); }
+
+	private:
+		struct Request {
+			std::unique_ptr<FrameGraph> fg;
+			Compiler::Options options;
+			Callback callback;
+			uint64_t generation;
+			std::promise<std::shared_ptr<const Snapshot>> promise;
+		};
+
+		void Run();
+
+		Compiler compiler;
+
+		std::mutex m;
+		std::condition_variable cv;
+		std::unique_ptr<Request> pending;
+		bool shutdown{ false };
+
+		std::atomic<uint64_t> latestGeneration{ 0 }; // submitted or cancelled
+		std::atomic<std::shared_ptr<const Snapshot>> published;
+
+		std::thread worker;
+	};
+}
@@ -2,13 +2,87 @@
 
 #include "FrameGraph.hpp"
 
+#include <array>
+#include <chrono>
 #include <unordered_map>
 #include <set>
 #include <optional>
+#include <span>
+#include <cstdint>
 
 namespace Ubpa::UFG {
 	class Compiler {
 	public:
+		struct Options {
+			// budget of the peak live bytes of the sized transient resources (see ResourceNode::GetSize), 0 : unlimited.
+			// when they may exceed it, independent passes are serialized in a memory-aware order
+			size_t memory_budget{ 0 };
+
+			// passNodeIdx -> estimated cost (e.g. PassCostModel::GetCosts), empty : unknown.
+			// with the costs, sorted_passes is a list schedule by priority (longest cost path to the sinks first)
+			std::vector<double> pass_costs;
+			// with the costs, assign the passes to the workers by static list scheduling (see Result::ListSchedule), 0 : none
+			size_t worker_num{ 0 };
+		};
+
+		// profiling counters of a compilation, accumulated over the compilations it is passed to
+		struct CompileStats {
+			enum Phase : size_t {
+				Analyze,      // accessors of the resources (dependency discovery)
+				MoveCopyMaps, // move and copy maps
+				MovePruning,  // continuous moves without reading and writing
+				Edges,        // pass graph edges
+				TopoSort,
+				MemoryBudget, // see Options::memory_budget
+				Schedule,     // see Options::pass_costs
+				Lifetimes,    // first, last and the pass infos
+				PhaseNum
+			};
+			static constexpr std::array<const char*, PhaseNum> phase_names{
+				"Analyze", "MoveCopyMaps", "MovePruning", "Edges", "TopoSort", "MemoryBudget", "Schedule", "Lifetimes"
+			};
+
+			std::array<std::chrono::nanoseconds, PhaseNum> phase_times{};
+
+			size_t compile_num{ 0 };
+			size_t pass_num{ 0 };
+			size_t resource_num{ 0 };
+			size_t move_num{ 0 };
+			size_t copy_num{ 0 };
+			size_t edge_num{ 0 };
+
+			// allocations made by the compiling thread in each phase, counted by CountAllocation.
+			// opt-in : 0 unless the application's global operator new calls CountAllocation
+			std::array<size_t, PhaseNum> phase_allocation_nums{};
+			std::array<size_t, PhaseNum> phase_allocated_bytes{};
+
+			// bytes held by the containers of the results (nodes, buckets and arrays), estimated
+			size_t result_bytes{ 0 };
+
+			// call it from the global operator new to count the allocations of the compilations (see the compile benchmark),
+			// the allocations of the calling thread are charged to its current compilation phase
+			static void CountAllocation(size_t size) noexcept;
+
+			std::chrono::nanoseconds GetTotalTime() const noexcept {
+				std::chrono::nanoseconds total{ 0 };
+				for (auto time : phase_times)
+					total += time;
+				return total;
+			}
+			size_t GetAllocationNum() const noexcept {
+				size_t total = 0;
+				for (auto num : phase_allocation_nums)
+					total += num;
+				return total;
+			}
+			size_t GetAllocatedBytes() const noexcept {
+				size_t total = 0;
+				for (auto bytes : phase_allocated_bytes)
+					total += bytes;
+				return total;
+			}
+		};
+
 		struct Result {
 			struct RsrcInfo {
 				size_t first{ static_cast<size_t>(-1) }; // index in sorted_passes
@@ -43,9 +117,84 @@ namespace Ubpa::UFG {
 			std::unordered_map<size_t, size_t> moves_dst2src;
 			std::unordered_map<size_t, size_t> copys_src2dst;
 			std::unordered_map<size_t, size_t> copys_dst2src;
+
+			// sized transient resources in sorted_passes, a chain of moves is one allocation
+			struct MemoryInfo {
+				size_t peak_bytes{ 0 };
+				// ordering edges added to the pass graph to meet the memory budget
+				size_t serialized_edge_num{ 0 };
+				// longest path (in passes) of the pass graph before and after the serialization
+				size_t level_num_before{ 0 };
+				size_t level_num{ 0 };
+			};
+			MemoryInfo memory;
+
+			// passNodeIdx -> longest cost path from the pass to the sinks (the pass included), empty without Options::pass_costs
+			std::vector<double> pass2priority;
+
+			// static list schedule with Options::pass_costs on Options::worker_num workers,
+			// a worker runs its passes in the order, waiting for the predecessors of each pass in the pass graph
+			struct ListSchedule {
+				std::vector<std::vector<size_t>> worker2passes;
+				std::vector<size_t> pass2worker; // passNodeIdx -> worker
+				double makespan{ 0 }; // estimated with the costs
+			};
+			ListSchedule list_schedule;
+
+			// live bytes of the sized transient resources (see ResourceNode::GetSize), a chain of moves is one allocation
+			struct MemoryReport {
+				std::vector<size_t> live_bytes; // index in sorted_passes -> live bytes during the pass
+				size_t peak_bytes{ 0 };
+				size_t peak_pass{ static_cast<size_t>(-1) };
+				std::vector<size_t> peak_resources; // live at the peak, the current holder of each allocation
+				size_t naive_bytes{ 0 }; // every allocation alive through the frame (no aliasing)
+
+				// aliased (peak) / naive total, 1 without sized resources
+				double GetAliasingRatio() const noexcept {
+					return naive_bytes == 0 ? 1. : static_cast<double>(peak_bytes) / static_cast<double>(naive_bytes);
+				}
+			};
+			MemoryReport GetMemoryReport(const FrameGraph& fg) const;
+
+			// Gantt-style chart of the resource lifetimes over sorted_passes and the live bytes below it
+			std::string ToLifetimeSVG(const FrameGraph& fg) const;
+		};
+
+		// precompiled results of a frame graph with conditional passes
+		struct VariantTable {
+			// bits used by the conditions of the passes, masks are reduced by it
+			uint64_t condition_mask{ 0 };
+			std::vector<Result> results;
+			std::unordered_map<uint64_t, size_t> mask2result; // reduced mask -> index in results
+
+			bool Contains(uint64_t mask) const { return mask2result.contains(mask & condition_mask); }
+			// throw std::out_of_range when the mask is not compiled
+			const Result& Select(uint64_t mask) const { return results[mask2result.at(mask & condition_mask)]; }
 		};
 
-		// throw std::logic_error when compilation failing
+		// throw std::logic_error when compilation failing,
+		// or no order meets the memory budget (the message lists the resources live at the peak)
 		Result Compile(const FrameGraph& fg);
+		// stats is optional
+		Result Compile(const FrameGraph& fg, const Options& options, CompileStats* stats = nullptr);
+
+		// the minimal schedule producing the requested resources, derived from the compiled result crst.
+		// it keeps the passes in the backward cone of the requested resources (in the order of crst)
+		// and recomputes the lifetimes and the memory peak for them, the resources out of the cone are not constructed.
+		// with options.pass_costs, pass2priority and list_schedule are recomputed for the cone (as in Compile),
+		// the order of crst is kept and options.memory_budget is ignored (a part of crst's order doesn't need more memory).
+		// the cost is proportional to the cone except the dense per node arrays of the result
+		Result Prune(const FrameGraph& fg, const Result& crst, std::span<const size_t> requested_resources);
+		Result Prune(const FrameGraph& fg, const Result& crst, std::span<const size_t> requested_resources, const Options& options);
+		// prunes into rst, a previous pruned result of the frame graph (or empty) : its per node arrays are kept
+		// and only the entries of its cone are cleared, so repeated prunes don't pay for the nodes out of the cones
+		void Prune(const FrameGraph& fg, const Result& crst, std::span<const size_t> requested_resources, const Options& options, Result& rst);
+
+		// compile one result per distinct (reduced) mask with the options, the analysis of the frame graph is shared.
+		// a conditional pass is enabled iff its condition bit is set in the mask,
+		// the resources only accessed by disabled passes are culled (no construction).
+		// throw std::logic_error when compilation failing or there are more than max_variants distinct masks
+		VariantTable CompileVariants(const FrameGraph& fg, std::span<const uint64_t> masks, size_t max_variants = 64);
+		VariantTable CompileVariants(const FrameGraph& fg, std::span<const uint64_t> masks, const Options& options, size_t max_variants = 64);
 	};
 }
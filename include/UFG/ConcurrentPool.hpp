@@ -0,0 +1,120 @@
+#pragma once
+
+#include "TransientPool.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Ubpa::UFG {
+	// thread-safe front of a TransientPool, worker threads acquire and release transient allocations where passes run.
+	// released blocks are cached in lock-free stacks (tagged indices against ABA) per block size,
+	// each size has shard_num stacks and a thread uses its own stack first to avoid contention.
+	// a miss falls back to the TransientPool under a mutex.
+	// blocks unused for more than max_age frames are returned to the TransientPool in NextFrame.
+	// a block still referenced by in-flight work is retired with a fence and cached when the fence completes
+	class ConcurrentPool {
+	public:
+		using Desc = TransientPool::Desc;
+
+		struct Handle {
+			uint32_t index{ static_cast<uint32_t>(-1) };
+			bool IsValid() const noexcept { return index != static_cast<uint32_t>(-1); }
+		};
+
+		struct Stats {
+			size_t hit_num{ 0 };
+			size_t miss_num{ 0 };
+			size_t cached_num{ 0 };
+		};
+
+		ConcurrentPool();
+		ConcurrentPool(TransientPool::Config config, size_t shard_num = 8);
+		~ConcurrentPool();
+
+		ConcurrentPool(const ConcurrentPool&) = delete;
+		ConcurrentPool& operator=(const ConcurrentPool&) = delete;
+
+		// thread-safe
+
+		Handle Acquire(const Desc& desc);
+		void Release(Handle handle);
+
+		// defer the release until the fence (e.g. the frame index) completes
+		void Retire(Handle handle, uint64_t fence);
+		// release the retired blocks with fence <= completedFence
+		void Reclaim(uint64_t completedFence);
+
+		void* GetData(Handle handle) const noexcept { return GetNode(handle.index).data; }
+		const Desc& GetDesc(Handle handle) const noexcept { return GetNode(handle.index).desc; }
+
+		// not thread-safe, call between frames
+
+		Stats GetStats() const noexcept;
+
+		// advance the frame, return the blocks unused for more than max_age frames to the TransientPool
+		void NextFrame();
+		// return all cached blocks to the TransientPool and clear it, the retired ones are kept
+		void Clear();
+
+		const TransientPool& GetTransientPool() const noexcept { return pool; }
+		uint64_t GetFrame() const noexcept { return frame.load(std::memory_order_relaxed); }
+
+	private:
+		static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+		static constexpr size_t chunk_size = 1024;
+		static constexpr size_t max_chunk_num = 4096;
+		static constexpr size_t bucket_num = 256;
+
+		struct Node {
+			Desc desc{ 0 };
+			void* data{ nullptr };
+			size_t size{ 0 }; // block size
+			TransientPool::Handle handle;
+			uint64_t frame{ 0 }; // release frame
+			uint64_t fence{ 0 }; // retire fence
+			std::atomic<uint32_t> next{ npos };
+		};
+
+		// head : tag << 32 | index
+		struct alignas(64) Stack {
+			std::atomic<uint64_t> head{ npos };
+		};
+
+		struct alignas(64) Shard {
+			std::atomic<size_t> hit_num{ 0 };
+			std::atomic<size_t> miss_num{ 0 };
+		};
+
+		Node& GetNode(uint32_t index) const noexcept {
+			return chunks[index / chunk_size].load(std::memory_order_acquire)[index % chunk_size];
+		}
+
+		size_t GetShard() const noexcept;
+		// npos : full or not found
+		size_t FindBucket(size_t size, bool insert) noexcept;
+		void Push(Stack& stack, uint32_t index) noexcept;
+		uint32_t Pop(Stack& stack) noexcept;
+
+		// with the mutex
+		uint32_t NewNode();
+		void Return(uint32_t index);
+
+		const size_t shard_num;
+
+		std::atomic<uint64_t> frame{ 0 };
+
+		std::array<std::atomic<Node*>, max_chunk_num> chunks{};
+		std::unique_ptr<std::atomic<size_t>[]> bucket_sizes; // 0 : empty
+		std::unique_ptr<Stack[]> stacks; // bucket_num * shard_num
+		Stack retireds;
+		std::unique_ptr<Shard[]> shards;
+
+		std::mutex mutex;
+		TransientPool pool;
+		std::vector<uint32_t> freeNodes;
+		size_t node_num{ 0 };
+	};
+}
@@ -6,14 +6,19 @@
 
 #include <UGraphviz/UGraphviz.hpp>
 
-#include <map>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+#include <initializer_list>
+#include <array>
 #include <span>
 
 namespace Ubpa::UFG {
 	// 1. Add all resource nodes first, then add pass nodes
 	// 2. write means (read + write)
 	// 3. resource lifecycle: move in -> write -> reads & copy out -> copy in -> move out
+	// 4. history resource: persistent, previous versions are read by its previous nodes
 	class FrameGraph {
 	public:
 		FrameGraph(std::string name) : name{ std::move(name) } {}
@@ -24,6 +29,16 @@ namespace Ubpa::UFG {
 		std::span<const PassNode> GetPassNodes() const noexcept { return passNodes; }
 		std::span<const MoveNode> GetMoveNodes() const noexcept { return moveNodes; }
 
+		// the edges of a pass node of this frame graph, invalidated by the next pass node registration
+		std::span<const uint32_t> GetPassNodeInputs(const PassNode& passNode) const noexcept {
+			return { passEdges.data() + passNode.offset, passNode.input_num };
+		}
+		std::span<const uint32_t> GetPassNodeOutputs(const PassNode& passNode) const noexcept {
+			return { passEdges.data() + passNode.offset + passNode.input_num, passNode.output_num };
+		}
+		std::span<const uint32_t> GetPassNodeInputs(size_t passNodeIdx) const noexcept { return GetPassNodeInputs(passNodes[passNodeIdx]); }
+		std::span<const uint32_t> GetPassNodeOutputs(size_t passNodeIdx) const noexcept { return GetPassNodeOutputs(passNodes[passNodeIdx]); }
+
 		bool IsRegisteredResourceNode(std::string_view name) const;
 		bool IsRegisteredPassNode(std::string_view name) const;
 		bool IsRegisteredMoveNode(size_t dst, size_t src) const;
@@ -37,46 +52,76 @@ namespace Ubpa::UFG {
 		size_t GetMoveDestinationNodeIndex(size_t src) const;
 
 		size_t RegisterResourceNode(ResourceNode node);
-		size_t RegisterResourceNode(std::string node);
-		size_t RegisterPassNode(PassNode node);
+		size_t RegisterResourceNode(std::string_view name);
+
+		/** Persistent resource with versions (>= 2) physical versions rotated between frames. */
+		size_t RegisterHistoryResourceNode(std::string_view name, size_t versions = 2);
+
+		/**
+		 * Read-only version of the history resource age (in [1, versions)) frames before.
+		 * The name is "<name>#Prev<age>".
+		 */
+		size_t RegisterPreviousResourceNode(size_t historyRsrcNodeIdx, size_t age = 1);
+
+		// the indices are packed into 32 bits
+		size_t RegisterPassNode(
+			PassNode::Type type,
+			std::string_view name,
+			std::span<const size_t> inputs,
+			std::span<const size_t> outputs);
 
 		size_t RegisterPassNode(
 			PassNode::Type type,
-			std::string name,
-			std::vector<size_t> inputs,
-			std::vector<size_t> outputs);
+			std::string_view name,
+			std::initializer_list<size_t> inputs,
+			std::initializer_list<size_t> outputs);
+
+		size_t RegisterGeneralPassNode(
+			std::string_view name,
+			std::span<const size_t> inputs,
+			std::span<const size_t> outputs);
 
 		size_t RegisterGeneralPassNode(
-			std::string name,
-			std::vector<size_t> inputs,
-			std::vector<size_t> outputs);
+			std::string_view name,
+			std::initializer_list<size_t> inputs,
+			std::initializer_list<size_t> outputs);
 
 		size_t RegisterCopyPassNode(
-			std::string name,
-			std::vector<size_t> inputs,
-			std::vector<size_t> outputs);
+			std::string_view name,
+			std::span<const size_t> inputs,
+			std::span<const size_t> outputs);
+
+		size_t RegisterCopyPassNode(
+			std::string_view name,
+			std::initializer_list<size_t> inputs,
+			std::initializer_list<size_t> outputs);
+
+		/** The name is "Copy#<ID>". */
+		size_t RegisterCopyPassNode(
+			std::span<const size_t> inputs,
+			std::span<const size_t> outputs);
 
 		/** The name is "Copy#<ID>". */
 		size_t RegisterCopyPassNode(
-			std::vector<size_t> inputs,
-			std::vector<size_t> outputs);
+			std::initializer_list<size_t> inputs,
+			std::initializer_list<size_t> outputs);
 
 		template<size_t N, size_t M>
 		size_t RegisterPassNode(
 			PassNode::Type type,
-			std::string name,
+			std::string_view name,
 			const std::array<std::string_view, N>& inputs_str,
 			const std::array<std::string_view, M>& outputs_str);
 
 		template<size_t N, size_t M>
 		size_t RegisterGeneralPassNode(
-			std::string name,
+			std::string_view name,
 			const std::array<std::string_view, N>& inputs_str,
 			const std::array<std::string_view, M>& outputs_str);
 
 		template<size_t N>
 		size_t RegisterCopyPassNode(
-			std::string name,
+			std::string_view name,
 			const std::array<std::string_view, N>& inputs_str,
 			const std::array<std::string_view, N>& outputs_str);
 
@@ -89,6 +134,18 @@ namespace Ubpa::UFG {
 		size_t RegisterMoveNode(MoveNode node);
 		size_t RegisterMoveNode(size_t dst, size_t src);
 
+		/**
+		 * The pass is enabled iff the bit is set in the variant mask (see Compiler::CompileVariants).
+		 * Throw std::out_of_range when bit >= 64.
+		 */
+		void SetPassNodeCondition(size_t passNodeIdx, size_t bit);
+
+		/** The outputs of a pure pass can be memoized across frames (see IncrementalCache). */
+		void SetPassNodePure(size_t passNodeIdx, bool pure = true);
+
+		/** Size hint in bytes of a transient resource, 0 : unknown or imported (see Compiler::Options). */
+		void SetResourceNodeSize(size_t rsrcNodeIdx, size_t size);
+
 		void Clear() noexcept;
 
 		UGraphviz::Graph ToGraphvizGraph() const;
@@ -100,9 +157,10 @@ namespace Ubpa::UFG {
 		std::string name;
 		std::vector<ResourceNode> resourceNodes;
 		std::vector<PassNode> passNodes;
+		std::vector<uint32_t> passEdges; // [inputs..., outputs...] of the passes in order
 		std::vector<MoveNode> moveNodes;
-		std::map<std::string, size_t, std::less<>> name2rsrcNodeIdx;
-		std::map<std::string, size_t, std::less<>> name2passNodeIdx;
+		NameIndex name2rsrcNodeIdx;
+		NameIndex name2passNodeIdx;
 		std::unordered_map<size_t, size_t> srcRsrcNodeIdx2moveNodeIdx;
 		std::unordered_map<size_t, size_t> dstRsrcNodeIdx2moveNodeIdx;
 	};
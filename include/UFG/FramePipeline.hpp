@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+namespace Ubpa::UFG {
+	// cross-frame hazards for executing frames in flight.
+	// transient resources live in per-frame pools (GetSlot), so only the resources shared by frames
+	// conflict: the imported resources (same physical resource every frame) and the history resources
+	// (a physical version is shared by the frames with the same slot, see HistoryRing).
+	// a pass of frame f must wait for its waits { pass, distance } of the frame f - distance,
+	// a frame starts after the frame GetFramesInFlight() before completes, so distance < GetFramesInFlight()
+	class FramePipeline {
+	public:
+		struct Wait {
+			size_t pass;
+			size_t distance; // >= 1
+		};
+
+		// throw std::logic_error when framesInFlight is 0
+		FramePipeline(
+			const FrameGraph& fg,
+			const Compiler::Result& crst,
+			std::span<const size_t> importedRsrcs,
+			size_t framesInFlight);
+
+		size_t GetFramesInFlight() const noexcept { return framesInFlight; }
+
+		// index of the per-frame resource pool
+		size_t GetSlot(uint64_t frame) const noexcept { return static_cast<size_t>(frame % framesInFlight); }
+
+		// passes of the previous frames the pass waits for
+		std::span<const Wait> GetWaits(size_t pass) const noexcept {
+			return { waits.data() + pass2waitOffset[pass], waits.data() + pass2waitOffset[pass + 1] };
+		}
+
+		// passes of the next frames waiting for the pass (inverse of GetWaits)
+		std::span<const Wait> GetDependents(size_t pass) const noexcept {
+			return { dependents.data() + pass2dependentOffset[pass], dependents.data() + pass2dependentOffset[pass + 1] };
+		}
+
+	private:
+		size_t framesInFlight;
+		std::vector<size_t> pass2waitOffset;
+		std::vector<Wait> waits;
+		std::vector<size_t> pass2dependentOffset;
+		std::vector<Wait> dependents;
+	};
+}
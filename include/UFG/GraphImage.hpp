@@ -0,0 +1,178 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Ubpa::UFG {
+	// versioned binary image of a frame graph and its compiled result, position-independent (offsets only).
+	// layout : Header, then the sections in the order of Section, each 8-byte aligned.
+	// indices are 32-bit with npos for static_cast<size_t>(-1), the lists of the nodes and the result are flattened
+	// into (offset, num) ranges of shared arrays, so a mapped file is read in place through the views below.
+	// the image is in the byte order of the writer, an image of another byte order or version is rejected
+	class GraphImage {
+	public:
+		static constexpr uint32_t magic = 0x42474655; // "UFGB"
+		static constexpr uint32_t version = 2;
+		static constexpr uint32_t byte_order = 0x01020304;
+		static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+		enum Section : uint32_t {
+			Strings,         // char, the names
+			Resources,       // ResourceRecord
+			Passes,          // PassRecord
+			PassResources,   // uint32_t, inputs and outputs of the passes
+			Moves,           // MoveRecord
+			SortedPasses,    // uint32_t
+			PassOrders,      // uint32_t, passNodeIdx -> index in SortedPasses
+			RsrcInfos,       // RsrcInfoRecord
+			Readers,         // uint32_t
+			SuccessorRanges, // Range, passNodeIdx -> successors in the pass graph
+			Successors,      // uint32_t
+			PassInfos,       // PassInfoRecord
+			PassInfoRsrcs,   // uint32_t
+			ResultMoves,     // MoveRecord, moves_src2dst
+			ResultCopies,    // MoveRecord, copys_src2dst
+			Priorities,      // double, Result::pass2priority
+			Workers,         // uint32_t, Result::list_schedule.pass2worker
+			SectionNum
+		};
+
+		struct Range {
+			uint32_t offset;
+			uint32_t num;
+		};
+
+		struct SectionRange {
+			uint64_t offset; // from the begin of the image
+			uint64_t num; // elements
+		};
+
+		struct Header {
+			uint32_t magic;
+			uint32_t version;
+			uint32_t byte_order;
+			uint32_t section_num;
+			uint64_t size; // bytes of the image
+			uint64_t checksum; // FNV-1a of the 64-bit words of the image with this field zeroed
+			Range name; // in Strings
+			uint32_t worker_num; // Result::list_schedule
+			uint32_t padding;
+
+			// Compiler::Result::MemoryInfo
+			uint64_t peak_bytes;
+			uint64_t serialized_edge_num;
+			uint64_t level_num_before;
+			uint64_t level_num;
+			double makespan; // Result::list_schedule
+
+			SectionRange sections[SectionNum];
+		};
+
+		struct ResourceRecord {
+			Range name;
+			uint64_t size;
+			uint32_t versions;
+			uint32_t history;
+			uint32_t age;
+			uint32_t padding;
+		};
+
+		struct PassRecord {
+			Range name;
+			Range inputs; // in PassResources
+			Range outputs; // in PassResources
+			uint32_t type; // PassNode::Type
+			uint32_t condition;
+			uint32_t pure;
+			uint32_t padding;
+		};
+
+		struct MoveRecord {
+			uint32_t dst;
+			uint32_t src;
+		};
+
+		struct RsrcInfoRecord {
+			uint32_t first;
+			uint32_t last;
+			uint32_t writer;
+			uint32_t copy_in;
+			Range readers; // in Readers
+		};
+
+		struct PassInfoRecord {
+			uint32_t pass; // npos : before any pass
+			Range construct_resources; // in PassInfoRsrcs
+			Range destruct_resources; // in PassInfoRsrcs
+			Range move_resources; // in PassInfoRsrcs
+		};
+
+#ifndef UFG_STRIP_NAMES
+		// the image identifies the nodes by their names, so there is no writer with UFG_STRIP_NAMES (the reader remains).
+		// throw std::logic_error when an index doesn't fit in 32 bits
+		static std::vector<std::byte> Serialize(const FrameGraph& fg, const Compiler::Result& crst);
+		static bool Save(const FrameGraph& fg, const Compiler::Result& crst, const std::string& path);
+#endif
+
+		// maps the file read-only, nullopt and the reason in error when the file can't be mapped or is invalid
+		// (out of bounds, or a graph the frame graph rejects : duplicate names, copy passes of unequal inputs and outputs...).
+		// the checksum is O(size), without it the header and the bounds of the sections are still validated
+		static std::optional<GraphImage> Open(const std::string& path, bool verify_checksum = true, std::string* error = nullptr);
+		// views the bytes (8-byte aligned) without copying, they must outlive the image
+		static std::optional<GraphImage> View(std::span<const std::byte> bytes, bool verify_checksum = true, std::string* error = nullptr);
+
+		GraphImage(GraphImage&& other) noexcept;
+		GraphImage& operator=(GraphImage&& other) noexcept;
+		~GraphImage();
+
+		std::span<const std::byte> GetBytes() const noexcept { return bytes; }
+		const Header& GetHeader() const noexcept { return *reinterpret_cast<const Header*>(bytes.data()); }
+
+		std::string_view Name() const noexcept { return GetString(GetHeader().name); }
+		std::string_view GetString(Range range) const noexcept { return { GetSection<char>(Strings).data() + range.offset, range.num }; }
+
+		std::span<const ResourceRecord> GetResourceRecords() const noexcept { return GetSection<ResourceRecord>(Resources); }
+		std::span<const PassRecord> GetPassRecords() const noexcept { return GetSection<PassRecord>(Passes); }
+		std::span<const uint32_t> GetPassResources(Range range) const noexcept { return GetSection<uint32_t>(PassResources).subspan(range.offset, range.num); }
+		std::span<const MoveRecord> GetMoveRecords() const noexcept { return GetSection<MoveRecord>(Moves); }
+
+		std::span<const uint32_t> GetSortedPasses() const noexcept { return GetSection<uint32_t>(SortedPasses); }
+		std::span<const uint32_t> GetPassOrders() const noexcept { return GetSection<uint32_t>(PassOrders); }
+		std::span<const RsrcInfoRecord> GetRsrcInfoRecords() const noexcept { return GetSection<RsrcInfoRecord>(RsrcInfos); }
+		std::span<const uint32_t> GetReaders(Range range) const noexcept { return GetSection<uint32_t>(Readers).subspan(range.offset, range.num); }
+		std::span<const uint32_t> GetSuccessors(size_t passNodeIdx) const noexcept {
+			auto range = GetSection<Range>(SuccessorRanges)[passNodeIdx];
+			return GetSection<uint32_t>(Successors).subspan(range.offset, range.num);
+		}
+		std::span<const PassInfoRecord> GetPassInfoRecords() const noexcept { return GetSection<PassInfoRecord>(PassInfos); }
+		std::span<const uint32_t> GetPassInfoResources(Range range) const noexcept { return GetSection<uint32_t>(PassInfoRsrcs).subspan(range.offset, range.num); }
+
+		// the frame graph and the compiled result in memory, no compilation
+		FrameGraph ToFrameGraph() const;
+		Compiler::Result ToResult() const;
+
+		// FNV-1a of the 64-bit words
+		static uint64_t Checksum(std::span<const std::byte> bytes) noexcept;
+
+	private:
+		GraphImage(std::span<const std::byte> bytes, void* mapping) noexcept : bytes{ bytes }, mapping{ mapping } {}
+
+		static std::optional<GraphImage> Validate(GraphImage image, bool verify_checksum, std::string* error);
+
+		template<typename T>
+		std::span<const T> GetSection(Section section) const noexcept {
+			const auto& range = GetHeader().sections[section];
+			return { reinterpret_cast<const T*>(bytes.data() + range.offset), static_cast<size_t>(range.num) };
+		}
+
+		std::span<const std::byte> bytes;
+		void* mapping{ nullptr }; // platform handle of the mapped file, nullptr for a view
+	};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "FrameGraph.hpp"
+
+#include <cstdint>
+
+namespace Ubpa::UFG {
+	// rotation of the physical versions of the history resources between frames.
+	// the executor keeps GetHistoryVersions() physical resources per history resource,
+	// at frame f the current version is the slot f % versions and the previous node of age a
+	// reads the slot (f - a) % versions, so the version read as previous is the one written a frames before.
+	// the slots of one frame are distinct, so the current version is never aliased with a previous one
+	class HistoryRing {
+	public:
+		HistoryRing(const FrameGraph& fg) : fg{ fg } {}
+
+		void NextFrame() noexcept { ++frame; }
+
+		// invalidate the previous versions (e.g. camera cut or resize)
+		void Reset() noexcept { validFrame = frame; }
+
+		uint64_t GetFrame() const noexcept { return frame; }
+
+		// rsrcNodeIdx is a history node or a previous node
+		size_t GetSlot(size_t rsrcNodeIdx) const noexcept;
+
+		// the history node corresponding to the physical resource
+		size_t GetHistoryNodeIndex(size_t rsrcNodeIdx) const noexcept;
+
+		// a previous version is valid iff it has been written after the last Reset
+		bool IsValid(size_t rsrcNodeIdx) const noexcept;
+
+	private:
+		const FrameGraph& fg;
+		uint64_t frame{ 0 };
+		uint64_t validFrame{ 0 };
+	};
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace Ubpa::UFG {
+	// build-system style memoization of pure passes across frames
+	// 1. every resource carries a version, an imported resource gets it by SetVersion,
+	//    a resource without version (e.g. a transient input without writer) changes every frame,
+	//    a copy target gets the version of its source at the copy (its readers see it at the next frame)
+	// 2. a pure pass is skipped when the versions of its inputs equal the ones of its last execution,
+	//    then its outputs keep their versions and the downstream pure passes may be skipped too
+	// 3. the outputs of pure passes and the copy targets are persistent, the executor keeps them alive across frames
+	//    instead of constructing and destructing them with the compiled lifetimes
+	class IncrementalCache {
+	public:
+		// throw std::logic_error when an output of a pure pass is moved or copied in
+		IncrementalCache(const FrameGraph& fg, const Compiler::Result& crst);
+
+		// version < 2^63, call it before NextFrame
+		void SetVersion(size_t rsrcNodeIdx, uint64_t version);
+
+		// propagate the versions along the sorted passes and decide the skipped passes
+		void NextFrame();
+
+		// drop all memoized outputs, every pass runs at the next frame
+		void Invalidate() noexcept;
+
+		bool IsSkipped(size_t passNodeIdx) const noexcept { return skipped[passNodeIdx]; }
+		bool IsPersistent(size_t rsrcNodeIdx) const noexcept { return persistent[rsrcNodeIdx]; }
+		uint64_t GetVersion(size_t rsrcNodeIdx) const noexcept { return versions[rsrcNodeIdx]; }
+		size_t GetSkippedPassNum() const noexcept { return skippedNum; }
+
+	private:
+		uint64_t GenVolatileVersion() noexcept { return volatileVersion++ | (uint64_t{ 1 } << 63); }
+
+		const FrameGraph& fg;
+		const Compiler::Result& crst;
+
+		std::vector<uint64_t> versions; // rsrcNodeIdx -> version
+		std::vector<bool> versioned; // rsrcNodeIdx -> set by SetVersion
+		std::vector<bool> persistent; // rsrcNodeIdx -> output of a pure pass or copy target
+		std::vector<bool> skipped; // passNodeIdx -> skipped at current frame
+
+		// input versions of the last execution of the pure passes, flattened
+		std::vector<size_t> pass2keyOffset; // passNodeIdx -> offset in keys
+		std::vector<uint64_t> keys;
+		std::vector<bool> cached; // passNodeIdx -> keys are valid
+
+		uint64_t volatileVersion{ 0 };
+		size_t skippedNum{ 0 };
+	};
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Ubpa::UFG {
+	// process-wide table of interned names, a name is stored once and the nodes refer to it by a compact ID.
+	// the hash of a name is computed once at interning, the lookups compare the hashes before the strings.
+	// with UFG_STRIP_NAMES only the hashes are kept (GetName returns an empty name, GetLabel #<hash>), to save memory in release builds,
+	// a second independent hash identifies the name and Intern throws on a collision of both.
+	// thread-safe, GetName and GetHash are lock-free.
+	// the names are never freed (the IDs stay valid for the process), the table holds every distinct name interned so far,
+	// at most max_name_num. generated names (e.g. Copy#<ID>) are bounded by the largest graph,
+	// don't put unbounded counters (e.g. frame numbers) in the node names
+	class NameTable {
+	public:
+		using ID = uint32_t;
+		static constexpr ID invalid_id = static_cast<ID>(-1);
+		static constexpr size_t max_name_num = 4096 * 4096;
+
+		static NameTable& Instance();
+
+		// FNV-1a, Hash(a + b) == Hash(b, Hash(a))
+		static constexpr uint64_t Hash(std::string_view name, uint64_t hash = 0xcbf29ce484222325ull) noexcept {
+			for (char c : name)
+				hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+			return hash;
+		}
+
+		// independent of Hash, Check(a + b) == Check(b, Check(a))
+		static constexpr uint64_t Check(std::string_view name, uint64_t check = 0x84222325cbf29ce4ull) noexcept {
+			for (char c : name) {
+				check = (check + static_cast<uint8_t>(c) + 1) * 0x9e3779b97f4a7c15ull;
+				check ^= check >> 32;
+			}
+			return check;
+		}
+
+		// identity of a name in the table
+		struct Key {
+			uint64_t hash;
+#ifdef UFG_STRIP_NAMES
+			uint64_t check;
+#else
+			std::string_view name;
+#endif
+			static Key Make(std::string_view name) noexcept {
+#ifdef UFG_STRIP_NAMES
+				return { Hash(name), Check(name) };
+#else
+				return { Hash(name), name };
+#endif
+			}
+		};
+
+		// throw std::logic_error on a hash collision (UFG_STRIP_NAMES), std::length_error past max_name_num names
+		ID Intern(std::string_view name);
+		// the name of prefix followed by suffix, doesn't need the name of prefix (UFG_STRIP_NAMES)
+		ID Intern(ID prefix, std::string_view suffix);
+		// invalid_id if the name isn't interned
+		ID Find(std::string_view name) const;
+
+		std::string_view GetName(ID id) const noexcept {
+#ifdef UFG_STRIP_NAMES
+			(void)id;
+			return {};
+#else
+			const auto& entry = GetEntry(id);
+			return { entry.str, entry.size };
+#endif
+		}
+		// the name, or #<hash> in hex with UFG_STRIP_NAMES (unique, Intern rejects the hash collisions)
+		std::string GetLabel(ID id) const;
+		uint64_t GetHash(ID id) const noexcept { return GetEntry(id).hash; }
+
+		bool Equal(ID id, const Key& key) const noexcept {
+			const auto& entry = GetEntry(id);
+#ifdef UFG_STRIP_NAMES
+			return entry.hash == key.hash && entry.check == key.check;
+#else
+			return entry.hash == key.hash && std::string_view{ entry.str, entry.size } == key.name;
+#endif
+		}
+
+		struct Stats {
+			size_t name_num{ 0 };
+			size_t string_bytes{ 0 }; // 0 with UFG_STRIP_NAMES
+			size_t table_bytes{ 0 }; // entries and index
+		};
+		Stats GetStats() const;
+
+	private:
+		NameTable();
+		~NameTable();
+
+		struct Entry {
+			uint64_t hash;
+#ifdef UFG_STRIP_NAMES
+			uint64_t check;
+#else
+			const char* str;
+			uint32_t size;
+#endif
+		};
+
+		const Entry& GetEntry(ID id) const noexcept {
+			return chunks[id / chunk_size].load(std::memory_order_acquire)[id % chunk_size];
+		}
+
+		// slot of the name in the index, or the empty slot to insert it.
+		// collision : another name of the same hash is in the index (UFG_STRIP_NAMES), optional
+		size_t Probe(const Key& key, bool* collision = nullptr) const noexcept;
+		ID Insert(const Key& key);
+		void Grow();
+		const char* Store(std::string_view name);
+
+		static constexpr size_t chunk_size = 4096;
+		static constexpr size_t max_chunk_num = max_name_num / chunk_size;
+		static constexpr size_t block_size = 64 * 1024;
+
+		mutable std::shared_mutex mutex;
+		std::atomic<Entry*> chunks[max_chunk_num];
+		size_t name_num{ 0 };
+		std::vector<ID> slots; // open addressing, power of two, invalid_id : empty
+		std::vector<std::unique_ptr<char[]>> blocks; // the strings
+		char* block{ nullptr }; // current block
+		size_t block_used{ block_size };
+		size_t string_bytes{ 0 };
+	};
+
+	// open addressing map from the names to the node indices of a frame graph, keyed by the interned IDs.
+	// the lookup by name hashes it once and doesn't touch the locked part of NameTable
+	class NameIndex {
+	public:
+		static constexpr size_t npos = static_cast<size_t>(-1);
+
+		// npos if absent
+		size_t Find(std::string_view name) const noexcept;
+		size_t Find(NameTable::ID id) const noexcept;
+
+		// false if the ID is already in the index
+		bool Insert(NameTable::ID id, size_t value);
+
+		size_t Size() const noexcept { return size; }
+		void Clear() noexcept;
+
+	private:
+		struct Slot {
+			uint64_t hash;
+			NameTable::ID id{ NameTable::invalid_id };
+			uint32_t value;
+		};
+
+		void Grow();
+
+		std::vector<Slot> slots; // power of two
+		size_t size{ 0 };
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "FrameGraph.hpp"
+
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Ubpa::UFG {
+	// measured pass durations, an exponentially weighted moving average per pass name (interned, see NameTable)
+	// so the costs follow the content across frames and graph rebuilds.
+	// the executor measures the passes of a frame into a dense array (one slot per pass, no sharing between threads)
+	// and records it after the frame, the costs feed Compiler::Options::pass_costs at the next compilation
+	class PassCostModel {
+	public:
+		struct Config {
+			double alpha{ 0.2 }; // weight of a new sample, the first sample is taken as is
+			double default_cost{ 0 }; // cost of an unknown pass, 0 : mean of the known passes (1 if none)
+		};
+
+		PassCostModel() : PassCostModel(Config{}) {}
+		explicit PassCostModel(Config config) : config{ config } {}
+
+		const Config& GetConfig() const noexcept { return config; }
+
+		void Record(std::string_view passName, double duration);
+		// durations : passNodeIdx -> measured duration, negative : not executed (e.g. a disabled pass)
+		void Record(const FrameGraph& fg, std::span<const double> durations);
+
+		bool Contains(std::string_view passName) const;
+		// the default cost if unknown
+		double GetCost(std::string_view passName) const;
+		// passNodeIdx -> cost
+		std::vector<double> GetCosts(const FrameGraph& fg) const;
+
+		size_t GetSampleNum(std::string_view passName) const;
+		size_t GetPassNum() const noexcept { return name2entry.size(); }
+
+		void Clear() noexcept { name2entry.clear(); }
+
+	private:
+		struct Entry {
+			double cost;
+			size_t sample_num;
+		};
+
+		double GetDefaultCost() const noexcept;
+
+		void Record(NameTable::ID passName, double duration);
+		const Entry* Find(std::string_view passName) const;
+
+		Config config;
+		std::unordered_map<NameTable::ID, Entry> name2entry;
+	};
+}
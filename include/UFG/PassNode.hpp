@@ -1,32 +1,24 @@
 #pragma once
 
+#include "NameTable.hpp"
+
+#include <stdexcept>
 #include <string>
-#include <vector>
-#include <span>
+#include <string_view>
 #include <typeinfo>
-#include <cassert>
+#include <cstdint>
 
 namespace Ubpa::UFG {
 	class PassNode {
 	public:
 		enum class Type { General, Copy };
 
-		PassNode(Type type,
-			std::string name,
-			std::vector<size_t> inputs,
-			std::vector<size_t> outputs)
-			: type{ type }
-			, name{ std::move(name) }
-			, inputs{ std::move(inputs) }
-			, outputs{ std::move(outputs) }
-		{ assert(IsValid()); }
-
 		bool IsValid() const noexcept {
-			if (name.empty())
+			if (NameTable::Instance().GetHash(name) == NameTable::Hash({}))
 				return false;
 
 			if (type == Type::Copy) {
-				if (inputs.size() != outputs.size())
+				if (input_num != output_num)
 					return false;
 			}
 
@@ -34,14 +26,46 @@ namespace Ubpa::UFG {
 		}
 
 		Type GetType() const noexcept { return type; }
-		std::string_view Name() const noexcept { return name; }
-		std::span<const size_t> Inputs() const noexcept { return inputs; }
-		std::span<const size_t> Outputs() const noexcept { return outputs; }
+		std::string_view Name() const noexcept { return NameTable::Instance().GetName(name); }
+		// for the outputs (graphviz, svg, trace, errors), the name or #<hash> with UFG_STRIP_NAMES
+		std::string Label() const { return NameTable::Instance().GetLabel(name); }
+		NameTable::ID GetNameID() const noexcept { return name; }
+		// the edges are packed in the frame graph, see FrameGraph::GetPassNodeInputs and GetPassNodeOutputs
+		size_t GetInputNum() const noexcept { return input_num; }
+		size_t GetOutputNum() const noexcept { return output_num; }
+
+		// condition bit index in the variant mask, static_cast<size_t>(-1) means unconditional
+		bool IsConditional() const noexcept { return condition != static_cast<size_t>(-1); }
+		size_t GetCondition() const noexcept { return condition; }
+		// throw std::out_of_range when bit >= 64
+		void SetCondition(size_t bit) {
+			if (bit >= 64)
+				throw std::out_of_range("condition bit out of the 64-bit variant mask");
+			condition = bit;
+		}
+		bool IsEnabled(uint64_t mask) const noexcept { return !IsConditional() || ((mask >> condition) & 1); }
+
+		// a pure pass's outputs only depend on its inputs, so it can be skipped when they are unchanged
+		bool IsPure() const noexcept { return pure; }
+		void SetPure(bool value) noexcept { pure = value; }
 
 	protected:
+		friend class FrameGraph;
+
+		PassNode(Type type, std::string_view name, uint32_t offset, uint32_t input_num, uint32_t output_num)
+			: type{ type }
+			, name{ NameTable::Instance().Intern(name) }
+			, offset{ offset }
+			, input_num{ input_num }
+			, output_num{ output_num }
+		{}
+
 		Type type;
-		std::string name;
-		std::vector<size_t> inputs;
-		std::vector<size_t> outputs;
+		NameTable::ID name;
+		uint32_t offset; // in FrameGraph::passEdges, [inputs..., outputs...]
+		uint32_t input_num;
+		uint32_t output_num;
+		size_t condition{ static_cast<size_t>(-1) };
+		bool pure{ false };
 	};
 }
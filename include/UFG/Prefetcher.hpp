@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Compiler.hpp"
+#include "ConcurrentPool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Ubpa::UFG {
+	// lookahead pre-allocation of transient resources on a helper thread.
+	// when a pass is about to run (Advance), the resources constructed by the passes
+	// up to distance ahead (in sorted_passes or in levels of the pass graph) are acquired from the pool
+	// and their pages are touched, so the executor takes them (Take) without malloc and page-fault stalls.
+	// the prefetched resources are alive earlier, the distance trades memory for latency
+	class Prefetcher {
+	public:
+		enum class Unit {
+			Order, // index in sorted_passes
+			Level  // longest path from the sources in the pass graph
+		};
+
+		struct Config {
+			size_t distance{ 2 };
+			Unit unit{ Unit::Order };
+			bool touch{ true }; // touch the pages of the prefetched allocations
+		};
+
+		struct Stats {
+			size_t prefetched_num{ 0 };
+			size_t taken_num{ 0 };
+			size_t late_num{ 0 }; // taken before prefetched
+			size_t touched_bytes{ 0 };
+		};
+
+		// desc of a transient resource, size 0 : not prefetched (e.g. imported)
+		using DescFunc = std::function<ConcurrentPool::Desc(size_t rsrcNodeIdx)>;
+
+		Prefetcher(const FrameGraph& fg, const Compiler::Result& crst, ConcurrentPool& pool, DescFunc descFunc);
+		Prefetcher(const FrameGraph& fg, const Compiler::Result& crst, ConcurrentPool& pool, DescFunc descFunc, Config config);
+		~Prefetcher();
+
+		Prefetcher(const Prefetcher&) = delete;
+		Prefetcher& operator=(const Prefetcher&) = delete;
+
+		// start a frame, prefetch the window of the first pass, not thread-safe
+		void Begin();
+
+		// thread-safe, the pass is about to run
+		void Advance(size_t passNodeIdx);
+
+		// thread-safe, claim the allocation of a resource to construct,
+		// an invalid handle if it is not prefetched yet (it won't be prefetched in this frame)
+		ConcurrentPool::Handle Take(size_t rsrcNodeIdx);
+
+		// end a frame, wait for the helper thread and release the allocations not taken, not thread-safe
+		void End();
+
+		// not thread-safe
+		Stats GetStats() const noexcept;
+		const Config& GetConfig() const noexcept { return config; }
+
+	private:
+		enum State : uint32_t {
+			state_pending,
+			state_prefetching,
+			state_ready,
+			state_taken
+		};
+
+		struct Entry {
+			size_t position;
+			size_t rsrc;
+		};
+
+		void Run();
+		void Prefetch(size_t rsrc);
+
+		ConcurrentPool& pool;
+		DescFunc descFunc;
+		Config config;
+
+		std::vector<size_t> pass2position;
+		std::vector<Entry> entries; // ordered by position
+
+		std::unique_ptr<std::atomic<uint32_t>[]> states; // rsrcNodeIdx -> State
+		std::vector<ConcurrentPool::Handle> handles; // rsrcNodeIdx -> prefetched handle
+
+		std::atomic<size_t> taken_num{ 0 };
+		std::atomic<size_t> late_num{ 0 };
+		size_t prefetched_num{ 0 }; // by the helper thread
+		size_t touched_bytes{ 0 }; // by the helper thread
+
+		std::mutex m;
+		std::condition_variable cv;
+		std::condition_variable cv_idle;
+		size_t cursor{ 0 }; // next entry
+		size_t target{ 0 }; // prefetch the entries with position <= target
+		bool active{ false };
+		bool busy{ false };
+		bool shutdown{ false };
+
+		std::thread helper;
+	};
+}
@@ -1,15 +1,49 @@
 #pragma once
 
+#include "NameTable.hpp"
+
 #include <string>
+#include <string_view>
 
 namespace Ubpa::UFG {
 	class ResourceNode {
 	public:
-		ResourceNode(std::string name)
-			: name{ std::move(name) } {}
+		ResourceNode(std::string_view name)
+			: name{ NameTable::Instance().Intern(name) } {}
+		explicit ResourceNode(NameTable::ID name)
+			: name{ name } {}
+
+		std::string_view Name() const noexcept { return NameTable::Instance().GetName(name); }
+		// for the outputs (graphviz, svg, trace, errors), the name or #<hash> with UFG_STRIP_NAMES
+		std::string Label() const { return NameTable::Instance().GetLabel(name); }
+		NameTable::ID GetNameID() const noexcept { return name; }
+
+		// history resource: persistent across frames with versions >= 2 physical versions,
+		// the node is the current version, previous versions are read by previous nodes
+		bool IsHistory() const noexcept { return versions != 0; }
+		size_t GetHistoryVersions() const noexcept { return versions; }
+		void SetHistoryVersions(size_t n) noexcept { versions = n; }
+
+		// previous node: read-only view of the version age frames before of the history resource
+		bool IsPrevious() const noexcept { return history != static_cast<size_t>(-1); }
+		size_t GetHistoryNodeIndex() const noexcept { return history; }
+		size_t GetHistoryAge() const noexcept { return age; }
+		void SetPrevious(size_t historyRsrcNodeIdx, size_t historyAge) noexcept {
+			history = historyRsrcNodeIdx;
+			age = historyAge;
+		}
+
+		// persistent resources live across frames, they are never aliased with transient ones
+		bool IsPersistent() const noexcept { return IsHistory() || IsPrevious(); }
 
-		std::string_view Name() const noexcept { return name; }
+		// size hint in bytes for memory-aware compilation, 0 : unknown or imported (not counted)
+		size_t GetSize() const noexcept { return size; }
+		void SetSize(size_t value) noexcept { size = value; }
 	private:
-		std::string name;
+		NameTable::ID name;
+		size_t size{ 0 };
+		size_t versions{ 0 };
+		size_t history{ static_cast<size_t>(-1) };
+		size_t age{ 0 };
 	};
 }
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <span>
+#include <vector>
+
+namespace Ubpa::UFG {
+	// discrete-event simulation of executing a compiled result on a worker/queue model,
+	// predicts the makespan, the worker occupancy and the live bytes over time without running the passes.
+	// a pass runs on a worker of its queue once its predecessors in the pass graph finished,
+	// the ready passes of a queue are picked by the policy.
+	// the sized transient resources (see ResourceNode::GetSize) are allocated when their first user starts
+	// and freed when their last user finishes, a chain of moves is one allocation (as in Compiler::Result::GetMemoryReport)
+	class ScheduleSimulator {
+	public:
+		enum class Policy {
+			Order,       // index in sorted_passes
+			Fifo,        // ready time, then Order
+			CriticalPath // longest path to the sinks (with the costs) first, then Order
+		};
+
+		struct Config {
+			std::vector<size_t> queue_worker_nums{ 1 }; // queue -> worker num
+			std::vector<size_t> pass2queue; // passNodeIdx -> queue, empty : every pass on queue 0
+			Policy policy{ Policy::CriticalPath };
+			double dispatch_cost{ 0 }; // added to every pass on its worker
+			double cross_queue_latency{ 0 }; // added to an edge between passes on different queues
+		};
+
+		struct Worker {
+			size_t queue{ 0 };
+			double busy_time{ 0 };
+			size_t pass_num{ 0 };
+		};
+
+		struct MemorySample {
+			double time;
+			size_t bytes; // live bytes from the time on
+		};
+
+		struct Result {
+			double makespan{ 0 };
+			double work{ 0 }; // sum of the costs
+			double critical_path{ 0 }; // longest path with the costs and latencies, the bound of the makespan
+
+			std::vector<Worker> workers;
+			std::vector<double> pass2start; // passNodeIdx -> time
+			std::vector<double> pass2finish; // passNodeIdx -> time
+			std::vector<size_t> pass2worker; // passNodeIdx -> worker
+
+			std::vector<MemorySample> memory;
+			size_t peak_bytes{ 0 };
+			double peak_time{ 0 };
+
+			// busy time / makespan
+			double GetOccupancy(size_t worker) const noexcept {
+				return makespan == 0 ? 0 : workers[worker].busy_time / makespan;
+			}
+		};
+
+		ScheduleSimulator(const FrameGraph& fg, const Compiler::Result& crst);
+
+		// costs : passNodeIdx -> cost (any time unit), thread-safe (const).
+		// throw std::logic_error when a pass is on a queue out of queue_worker_nums or without workers
+		Result Simulate(std::span<const double> costs, const Config& config) const;
+
+	private:
+		const Compiler::Result& crst;
+		size_t passNum;
+
+		// successors in CSR
+		std::vector<size_t> pass2succOffset;
+		std::vector<size_t> succs;
+		std::vector<size_t> predNums;
+
+		// sized transient allocations
+		std::vector<size_t> chainSizes;
+		std::vector<size_t> chainUserNums;
+		std::vector<bool> chainPreallocated; // live from the start
+		std::vector<size_t> pass2chainOffset;
+		std::vector<size_t> pass2chains;
+	};
+}
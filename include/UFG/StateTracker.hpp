@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+namespace Ubpa::UFG {
+	// dense tracker of resource states (e.g. GPU barriers) following the pass graph.
+	// the states required by the passes are flattened per pass at Build:
+	// - a writer / copy-in transitions its output before executing (Acquire)
+	// - the readers of a resource run concurrently, so they must require the same state,
+	//   the transition is hoisted to the end of the writer (Release),
+	//   to the move into the resource (Move) or to its construction (Construct) when there is no writer
+	//   (a copy-in runs after the readers, its Acquire then switches to the copy destination state)
+	// so a state is only touched by the pass owning the resource in the pass graph,
+	// the tracker is safe to use from worker threads executing the passes in the order of the pass graph
+	class StateTracker {
+	public:
+		using State = uint32_t;
+		static constexpr State state_none = static_cast<State>(-1);
+
+		struct Requirement {
+			size_t rsrc;
+			State state;
+		};
+
+		StateTracker(const FrameGraph& fg, const Compiler::Result& crst);
+
+		// not thread-safe, before Build
+		StateTracker& Require(size_t passNodeIdx, size_t rsrcNodeIdx, State state);
+
+		// throw std::logic_error when a pass requires a state of a resource it doesn't access
+		// or the readers of a resource require different states
+		void Build();
+
+		std::span<const Requirement> GetAcquires(size_t passNodeIdx) const noexcept {
+			return { acquires.data() + pass2acquireOffset[passNodeIdx], acquires.data() + pass2acquireOffset[passNodeIdx + 1] };
+		}
+		std::span<const Requirement> GetReleases(size_t passNodeIdx) const noexcept {
+			return { releases.data() + pass2releaseOffset[passNodeIdx], releases.data() + pass2releaseOffset[passNodeIdx + 1] };
+		}
+		// state required by the readers of a resource without writer, state_none if no requirement
+		State GetEntryState(size_t rsrcNodeIdx) const noexcept { return entryStates[rsrcNodeIdx]; }
+
+		void SetState(size_t rsrcNodeIdx, State state) noexcept { states[rsrcNodeIdx] = state; }
+		State GetState(size_t rsrcNodeIdx) const noexcept { return states[rsrcNodeIdx]; }
+
+		// transition(rsrcNodeIdx, before, after) is called for each state change
+
+		// a constructed or imported resource in the state, transition to the entry state if it has no writer
+		template<typename Func>
+		void Construct(size_t rsrcNodeIdx, State state, Func&& transition);
+		// before executing the pass
+		template<typename Func>
+		void Acquire(size_t passNodeIdx, Func&& transition) { Apply(GetAcquires(passNodeIdx), transition); }
+		// after executing the pass
+		template<typename Func>
+		void Release(size_t passNodeIdx, Func&& transition) { Apply(GetReleases(passNodeIdx), transition); }
+		// the destination inherits the state of the source
+		template<typename Func>
+		void Move(size_t dstRsrcNodeIdx, size_t srcRsrcNodeIdx, Func&& transition);
+
+	private:
+		template<typename Func>
+		void Apply(size_t rsrc, State state, Func& transition);
+		template<typename Func>
+		void Apply(std::span<const Requirement> requirements, Func& transition);
+
+		const FrameGraph& fg;
+		const Compiler::Result& crst;
+
+		std::vector<std::pair<size_t, Requirement>> registrations; // (pass, requirement)
+
+		std::vector<size_t> pass2acquireOffset;
+		std::vector<Requirement> acquires;
+		std::vector<size_t> pass2releaseOffset;
+		std::vector<Requirement> releases;
+		std::vector<State> entryStates; // rsrcNodeIdx -> state of the readers of a resource without writer
+
+		std::vector<State> states; // rsrcNodeIdx -> current state
+	};
+}
+
+#include "detail/StateTracker.inl"
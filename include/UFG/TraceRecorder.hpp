@@ -0,0 +1,85 @@
+#pragma once
+
+#include "FrameGraph.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Ubpa::UFG {
+	// low-overhead recorder of execution events, exported as Chrome Trace Event JSON (chrome://tracing, Perfetto).
+	// an event is a fixed size record written into a ring buffer (the oldest events are overwritten),
+	// Record is lock-free and thread-safe. the executor reports its events through UFG_TRACE,
+	// which is compiled out unless UFG_ENABLE_TRACE is defined
+	class TraceRecorder {
+	public:
+		enum class EventType : uint32_t {
+			PassBegin,  // index : pass
+			PassEnd,    // index : pass
+			Construct,  // index : resource
+			Destruct,   // index : resource
+			Move,       // index : destination, arg0 : source
+			Transition, // index : resource, arg0 : before, arg1 : after
+			IdleBegin,  // worker waits for work
+			IdleEnd
+		};
+
+		struct Event {
+			uint64_t time; // nanoseconds since the recorder's epoch
+			uint32_t thread;
+			EventType type;
+			uint32_t index;
+			uint32_t arg0;
+			uint32_t arg1;
+		};
+
+		// capacity is rounded up to a power of 2
+		TraceRecorder(size_t capacity = 1 << 16);
+
+		TraceRecorder(const TraceRecorder&) = delete;
+		TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+		// thread-safe
+		void Record(EventType type, size_t index = 0, size_t arg0 = 0, size_t arg1 = 0) noexcept {
+			uint64_t time = static_cast<uint64_t>((std::chrono::steady_clock::now() - epoch).count());
+			uint64_t cursor = next.fetch_add(1, std::memory_order_relaxed);
+			events[cursor & mask] = { time, GetThread(), type,
+				static_cast<uint32_t>(index), static_cast<uint32_t>(arg0), static_cast<uint32_t>(arg1) };
+		}
+
+		// not thread-safe, call when no event is being recorded
+
+		// the kept events in the order of recording
+		std::vector<Event> GetEvents() const;
+		// recorded events including the overwritten ones
+		uint64_t GetRecordedNum() const noexcept { return next.load(std::memory_order_relaxed); }
+		size_t GetCapacity() const noexcept { return mask + 1; }
+		void Clear() noexcept { next.store(0, std::memory_order_relaxed); }
+
+		// names of the passes and resources are taken from fg
+		std::string ToChromeTrace(const FrameGraph& fg) const;
+		// return false if the file can't be written
+		bool WriteChromeTrace(const FrameGraph& fg, const std::string& path) const;
+
+		// small id of the calling thread
+		static uint32_t GetThread() noexcept;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		const size_t mask;
+		std::unique_ptr<Event[]> events;
+		std::atomic<uint64_t> next{ 0 };
+		const Clock::time_point epoch;
+	};
+}
+
+#ifdef UFG_ENABLE_TRACE
+// UFG_TRACE(recorder, PassBegin, pass), the arguments aren't evaluated without UFG_ENABLE_TRACE
+#define UFG_TRACE(recorder, type, ...) (recorder).Record(::Ubpa::UFG::TraceRecorder::EventType::type __VA_OPT__(,) __VA_ARGS__)
+#else
+#define UFG_TRACE(recorder, type, ...) ((void)0)
+#endif
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace Ubpa::UFG {
+	// pool of transient allocations reused across frames.
+	// - a request is rounded up to a geometric size class (class_num_per_octave classes per power of two),
+	//   a released block is cached in its class and may host any request of a class up to max_host_ratio times smaller
+	// - blocks no larger than page_size are suballocated from pages (best-fit, coalesced on free),
+	//   larger ones are dedicated allocations
+	// - a cached block is returned to its page when unused for more than max_age frames
+	//   or evicted (least recently released first) when a new page exceeds the budget,
+	//   a page is freed once it is empty
+	// - a block still referenced by in-flight work is retired with a fence (e.g. the frame index),
+	//   it is released when the fence completes (Reclaim)
+	// - Compact between frames repacks the blocks of sparse pages into the other pages and frees the sparse ones
+	// - cost, with C the classes holding cached blocks and R the free ranges of the pages :
+	//   a hit and Release are O(log C) (plus the hosting classes and the misaligned blocks skipped by a hit),
+	//   a miss suballocates in O(log R), freeing a block (aging, eviction, Clear) coalesces in O(log R)
+	class TransientPool {
+	public:
+		struct Desc {
+			size_t size;
+			size_t alignment{ alignof(std::max_align_t) };
+			bool operator==(const Desc& rhs) const noexcept = default;
+		};
+
+		struct Handle {
+			uint32_t index{ static_cast<uint32_t>(-1) };
+			bool IsValid() const noexcept { return index != static_cast<uint32_t>(-1); }
+		};
+
+		struct Config {
+			size_t max_age{ 8 }; // frames
+			size_t budget{ static_cast<size_t>(-1) }; // bytes of pages and dedicated allocations
+			size_t page_size{ static_cast<size_t>(1) << 22 };
+			size_t class_num_per_octave{ 4 }; // 1 : power-of-two classes
+			double max_host_ratio{ 2. };
+			double compact_occupancy{ 0.5 }; // Compact evacuates the pages used no more than it
+		};
+
+		// allocated_bytes == live_bytes + waste_bytes + retired_bytes + cached_bytes + free_bytes
+		struct Stats {
+			size_t allocated_bytes{ 0 }; // pages + dedicated allocations
+			size_t live_bytes{ 0 }; // requested sizes of live blocks
+			size_t waste_bytes{ 0 }; // rounding of live blocks
+			size_t retired_bytes{ 0 };
+			size_t cached_bytes{ 0 };
+			size_t free_bytes{ 0 }; // unused in pages
+			size_t page_num{ 0 };
+			size_t block_num{ 0 }; // live + cached
+			size_t hit_num{ 0 };
+			size_t miss_num{ 0 };
+			size_t aged_num{ 0 }; // blocks freed by aging
+			size_t evicted_num{ 0 }; // blocks freed by the budget
+			size_t over_budget_num{ 0 }; // allocations exceeding the budget after evicting all cached blocks
+			size_t relocated_bytes{ 0 }; // by Compact
+			size_t reclaimed_bytes{ 0 }; // by Compact
+		};
+
+		TransientPool();
+		TransientPool(Config config);
+		~TransientPool();
+
+		TransientPool(const TransientPool&) = delete;
+		TransientPool& operator=(const TransientPool&) = delete;
+
+		Handle Acquire(const Desc& desc);
+		void Release(Handle handle);
+
+		// defer the release until the fence completes, fences are non-decreasing
+		void Retire(Handle handle, uint64_t fence);
+		// stamped with the current frame
+		void Retire(Handle handle) { Retire(handle, frame); }
+		// release the retired blocks with fence <= completedFence
+		void Reclaim(uint64_t completedFence);
+
+		void* GetData(Handle handle) const noexcept { return nodes[handle.index].data; }
+		// requested desc
+		const Desc& GetDesc(Handle handle) const noexcept { return nodes[handle.index].desc; }
+		// size of the block hosting the allocation
+		size_t GetBlockSize(Handle handle) const noexcept { return nodes[handle.index].size; }
+
+		// advance the frame and free the blocks unused for more than max_age frames
+		void NextFrame();
+
+		// free all cached blocks, the retired ones are kept
+		void Clear();
+
+		// repack the blocks of the sparse pages (emptiest first) until the time budget is exhausted,
+		// a page with retired blocks is kept, so is a page with live blocks unless relocateLive.
+		// a relocated live block keeps its handle and content but GetData changes.
+		// return the reclaimed bytes
+		size_t Compact(std::chrono::nanoseconds timeBudget, bool relocateLive = false);
+
+		size_t GetClassSize(size_t size) const noexcept;
+
+		const Config& GetConfig() const noexcept { return config; }
+		// page_size and class_num_per_octave only apply to new pages and blocks
+		void SetConfig(const Config& value) noexcept { config = value; }
+		const Stats& GetStats() const noexcept { return stats; }
+		uint64_t GetFrame() const noexcept { return frame; }
+
+		size_t GetLargestFreeRange() const noexcept;
+		// external fragmentation of pages : 1 - largest free range / free bytes
+		double GetFragmentation() const noexcept;
+
+	private:
+		static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+		static constexpr size_t granularity = alignof(std::max_align_t);
+		static constexpr size_t page_alignment = 4096;
+
+		enum class NodeState : uint8_t {
+			Live,
+			Retired,
+			Cached // in the list of its class and in the lru list
+		};
+
+		struct Node {
+			NodeState state{ NodeState::Live };
+			void* data{ nullptr };
+			Desc desc{ 0 };
+			size_t size{ 0 }; // block size
+			uint32_t page{ npos }; // npos : dedicated
+			size_t offset{ 0 }; // in page
+			size_t alignment{ 0 }; // of dedicated allocation
+			uint64_t frame{ 0 }; // release frame
+			uint32_t prev{ npos }; // list of class
+			uint32_t next{ npos };
+			uint32_t lru_prev{ npos };
+			uint32_t lru_next{ npos };
+		};
+
+		struct List {
+			uint32_t head{ npos };
+			uint32_t tail{ npos };
+		};
+
+		struct Page {
+			std::byte* data{ nullptr };
+			size_t size{ 0 };
+			size_t free_size{ 0 };
+			std::map<size_t, size_t> free_ranges; // offset -> size
+		};
+
+		void Cache(uint32_t index);
+		uint32_t NewPage();
+		void Pop(std::map<size_t, List>::iterator target, uint32_t index);
+		void Free(uint32_t index);
+		bool Suballocate(Node& node, size_t alignment);
+		void AddFreeRange(uint32_t pageIdx, size_t offset, size_t size);
+		void RemoveFreeRange(uint32_t pageIdx, size_t offset, size_t size);
+		void ReturnRange(uint32_t pageIdx, size_t offset, size_t size);
+
+		Config config;
+		Stats stats;
+		uint64_t frame{ 0 };
+
+		std::vector<Node> nodes;
+		std::vector<uint32_t> freeNodes;
+		std::map<size_t, List> class2cached; // block size -> cached blocks, no empty list
+		List lru; // head is the least recently released
+		std::deque<std::pair<uint64_t, uint32_t>> retireds; // (fence, index)
+
+		std::vector<Page> pages;
+		std::vector<uint32_t> freePages;
+		std::set<std::tuple<size_t, uint32_t, size_t>> free_ranges; // (size, page, offset), best-fit order
+	};
+}
@@ -2,6 +2,20 @@
 
 #include "Compiler.hpp"
 #include "FrameGraph.hpp"
+#include "IncrementalCache.hpp"
+#include "HistoryRing.hpp"
+#include "FramePipeline.hpp"
+#include "AsyncCompiler.hpp"
+#include "TransientPool.hpp"
+#include "ConcurrentPool.hpp"
+#include "UserCounter.hpp"
+#include "Prefetcher.hpp"
+#include "StateTracker.hpp"
+#include "TraceRecorder.hpp"
+#include "ScheduleSimulator.hpp"
+#include "PassCostModel.hpp"
+#include "GraphImage.hpp"
+#include "NameTable.hpp"
 #include "PassNode.hpp"
 #include "MoveNode.hpp"
 #include "ResourceNode.hpp"
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Compiler.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace Ubpa::UFG {
+	// per-resource atomic user counters of a compiled result, for executors running passes in parallel.
+	// the users of a resource are its writer, readers and copy-in (Compiler::Result::RsrcInfo),
+	// the worker completing the last user releases the resource (or moves it to its destination) at once
+	// instead of waiting for the static last position in sorted_passes
+	class UserCounter {
+	public:
+		UserCounter(const FrameGraph& fg, const Compiler::Result& crst);
+
+		// restore the counters, not thread-safe, call it before every execution
+		void Reset() noexcept;
+
+		// thread-safe, return true if the caller is the last user
+		bool Release(size_t rsrcNodeIdx) noexcept {
+			return counts[rsrcNodeIdx].fetch_sub(1, std::memory_order_acq_rel) == 1;
+		}
+
+		// thread-safe, release the inputs and outputs of a completed pass,
+		// call func(rsrcNodeIdx) for each resource the pass is the last user of
+		template<typename Func>
+		void Complete(size_t passNodeIdx, Func&& func) {
+			const auto& pass = fg.GetPassNodes()[passNodeIdx];
+			for (auto input : fg.GetPassNodeInputs(pass)) {
+				if (Release(input))
+					func(input);
+			}
+			for (auto output : fg.GetPassNodeOutputs(pass)) {
+				if (Release(output))
+					func(output);
+			}
+		}
+
+		size_t GetUserNum(size_t rsrcNodeIdx) const noexcept { return userNums[rsrcNodeIdx]; }
+		size_t GetRemainUserNum(size_t rsrcNodeIdx) const noexcept { return counts[rsrcNodeIdx].load(std::memory_order_relaxed); }
+
+	private:
+		const FrameGraph& fg;
+		std::vector<uint32_t> userNums; // rsrcNodeIdx -> user num
+		std::unique_ptr<std::atomic<uint32_t>[]> counts; // rsrcNodeIdx -> remain user num
+	};
+}
@@ -4,43 +4,43 @@ namespace Ubpa::UFG {
 	template<size_t N, size_t M>
 	size_t FrameGraph::RegisterPassNode(
 		PassNode::Type type,
-		std::string name,
+		std::string_view name,
 		const std::array<std::string_view, N>& inputs_str,
 		const std::array<std::string_view, M>& outputs_str)
 	{
-		std::vector<size_t> inputs(N);
-		std::vector<size_t> outputs(M);
+		std::array<size_t, N> inputs;
+		std::array<size_t, M> outputs;
 
 		for (size_t i = 0; i < N; i++)
 			inputs[i] = GetResourceNodeIndex(inputs_str[i]);
 		for (size_t i = 0; i < M; i++)
 			outputs[i] = GetResourceNodeIndex(outputs_str[i]);
 
-		return RegisterPassNode(type, std::move(name), std::move(inputs), std::move(outputs));
+		return RegisterPassNode(type, name, std::span<const size_t>{ inputs }, std::span<const size_t>{ outputs });
 	}
 
 	template<size_t N, size_t M>
 	size_t FrameGraph::RegisterGeneralPassNode(
-		std::string name,
+		std::string_view name,
 		const std::array<std::string_view, N>& inputs_str,
 		const std::array<std::string_view, M>& outputs_str)
 	{
-		RegisterCopyNode(
+		return RegisterPassNode(
 			PassNode::Type::General,
-			std::move(name),
+			name,
 			inputs_str,
 			outputs_str);
 	}
 
 	template<size_t N>
 	size_t FrameGraph::RegisterCopyPassNode(
-		std::string name,
+		std::string_view name,
 		const std::array<std::string_view, N>& inputs_str,
 		const std::array<std::string_view, N>& outputs_str)
 	{
-		RegisterCopyNode(
+		return RegisterPassNode(
 			PassNode::Type::Copy,
-			std::move(name),
+			name,
 			inputs_str,
 			outputs_str);
 	}
@@ -50,7 +50,7 @@ namespace Ubpa::UFG {
 		const std::array<std::string_view, N>& inputs_str,
 		const std::array<std::string_view, N>& outputs_str)
 	{
-		RegisterCopyNode(
+		return RegisterCopyPassNode(
 			GenerateCopyPassNodeName(),
 			inputs_str,
 			outputs_str);
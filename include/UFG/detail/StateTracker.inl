@@ -0,0 +1,32 @@
+#pragma once
+
+namespace Ubpa::UFG {
+	template<typename Func>
+	void StateTracker::Apply(size_t rsrc, State state, Func& transition) {
+		State before = states[rsrc];
+		if (before == state)
+			return;
+		transition(rsrc, before, state);
+		states[rsrc] = state;
+	}
+
+	template<typename Func>
+	void StateTracker::Apply(std::span<const Requirement> requirements, Func& transition) {
+		for (const auto& requirement : requirements)
+			Apply(requirement.rsrc, requirement.state, transition);
+	}
+
+	template<typename Func>
+	void StateTracker::Construct(size_t rsrcNodeIdx, State state, Func&& transition) {
+		states[rsrcNodeIdx] = state;
+		if (entryStates[rsrcNodeIdx] != state_none)
+			Apply(rsrcNodeIdx, entryStates[rsrcNodeIdx], transition);
+	}
+
+	template<typename Func>
+	void StateTracker::Move(size_t dstRsrcNodeIdx, size_t srcRsrcNodeIdx, Func&& transition) {
+		states[dstRsrcNodeIdx] = states[srcRsrcNodeIdx];
+		if (entryStates[dstRsrcNodeIdx] != state_none)
+			Apply(dstRsrcNodeIdx, entryStates[dstRsrcNodeIdx], transition);
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <UFG/FrameGraph.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// parametric frame graphs for the benchmarks, every resource gets a size hint (see UFG::ResourceNode::GetSize)
+namespace GraphGenerator {
+	using Ubpa::UFG::FrameGraph;
+
+	inline constexpr size_t rsrc_size = 1 << 20;
+
+	inline size_t AddResource(FrameGraph& fg, std::string name) {
+		size_t rsrc = fg.RegisterResourceNode(std::move(name));
+		fg.SetResourceNodeSize(rsrc, rsrc_size);
+		return rsrc;
+	}
+
+	// P0 -> R0 -> P1 -> R1 -> ... -> P(n-1)
+	inline FrameGraph Chain(size_t pass_num) {
+		FrameGraph fg("chain");
+		for (size_t i = 0; i < pass_num; i++)
+			AddResource(fg, "R" + std::to_string(i));
+		for (size_t i = 0; i < pass_num; i++) {
+			std::vector<size_t> inputs;
+			if (i > 0)
+				inputs.push_back(i - 1);
+			fg.RegisterGeneralPassNode("P" + std::to_string(i), inputs, std::array{ i });
+		}
+		return fg;
+	}
+
+	// Source -> Shared -> Branch i -> R i -> Sink, pass_num - 2 branches
+	inline FrameGraph FanOutIn(size_t pass_num) {
+		FrameGraph fg("fan out/in");
+		size_t branch_num = pass_num > 2 ? pass_num - 2 : 1;
+		size_t shared = AddResource(fg, "Shared");
+		std::vector<size_t> rsrcs;
+		for (size_t i = 0; i < branch_num; i++)
+			rsrcs.push_back(AddResource(fg, "R" + std::to_string(i)));
+
+		fg.RegisterGeneralPassNode("Source", {}, { shared });
+		for (size_t i = 0; i < branch_num; i++)
+			fg.RegisterGeneralPassNode("Branch" + std::to_string(i), { shared }, { rsrcs[i] });
+		fg.RegisterGeneralPassNode("Sink", rsrcs, {});
+		return fg;
+	}
+
+	// R0 is moved into R1, R1 into R2 ... every stride-th resource is written (read + write) by a pass,
+	// the others are moved through without access and pruned by the compiler
+	inline FrameGraph MoveChain(size_t pass_num, size_t stride = 2) {
+		FrameGraph fg("move chain");
+		size_t rsrc_num = pass_num * stride;
+		for (size_t i = 0; i < rsrc_num; i++)
+			AddResource(fg, "R" + std::to_string(i));
+		for (size_t i = 1; i < rsrc_num; i++)
+			fg.RegisterMoveNode(i, i - 1);
+		for (size_t i = 0; i < pass_num; i++)
+			fg.RegisterGeneralPassNode("P" + std::to_string(i), {}, { i * stride });
+		return fg;
+	}
+
+	// pass i writes R i and reads up to max_input_num resources written before it,
+	// picked from the last window passes (locality of real frames), deterministic in seed
+	inline FrameGraph RandomDAG(size_t pass_num, size_t max_input_num = 4, size_t window = 64, uint64_t seed = 0) {
+		FrameGraph fg("random dag");
+		for (size_t i = 0; i < pass_num; i++)
+			AddResource(fg, "R" + std::to_string(i));
+
+		std::mt19937_64 rng{ seed };
+		for (size_t i = 0; i < pass_num; i++) {
+			std::vector<size_t> inputs;
+			size_t begin = i > window ? i - window : 0;
+			size_t input_num = i == 0 ? 0 : std::uniform_int_distribution<size_t>{ 0, max_input_num }(rng);
+			for (size_t k = 0; k < input_num; k++) {
+				size_t input = std::uniform_int_distribution<size_t>{ begin, i - 1 }(rng);
+				if (std::find(inputs.begin(), inputs.end(), input) == inputs.end())
+					inputs.push_back(input);
+			}
+			fg.RegisterGeneralPassNode("P" + std::to_string(i), inputs, std::array{ i });
+		}
+		return fg;
+	}
+
+	// pass i reads R (i-1) and the history copy C i, writes R i, then R i is copied into C i,
+	// half of the passes are copy passes
+	inline FrameGraph CopyHeavy(size_t pass_num) {
+		FrameGraph fg("copy heavy");
+		size_t step_num = std::max<size_t>(pass_num / 2, 1);
+		for (size_t i = 0; i < step_num; i++) {
+			AddResource(fg, "R" + std::to_string(i));
+			AddResource(fg, "C" + std::to_string(i));
+		}
+		for (size_t i = 0; i < step_num; i++) {
+			std::vector<size_t> inputs{ 2 * i + 1 };
+			if (i > 0)
+				inputs.push_back(2 * (i - 1));
+			fg.RegisterGeneralPassNode("P" + std::to_string(i), inputs, std::array{ 2 * i });
+			fg.RegisterCopyPassNode({ 2 * i }, { 2 * i + 1 });
+		}
+		return fg;
+	}
+
+	// the deferred frame of test 02_parallel (9 passes) rendered for pass_num / 9 views, a final pass presents all of them
+	inline FrameGraph Deferred(size_t pass_num) {
+		FrameGraph fg("deferred");
+		size_t view_num = std::max<size_t>(pass_num / 9, 1);
+		std::vector<size_t> finaltargets;
+		for (size_t v = 0; v < view_num; v++) {
+			std::string view = "View" + std::to_string(v) + " ";
+			size_t depthbuffer = AddResource(fg, view + "Depth Buffer");
+			size_t depthbuffer2 = AddResource(fg, view + "Depth Buffer 2");
+			size_t gbuffer1 = AddResource(fg, view + "GBuffer1");
+			size_t gbuffer2 = AddResource(fg, view + "GBuffer2");
+			size_t gbuffer3 = AddResource(fg, view + "GBuffer3");
+			size_t lightingbuffer = AddResource(fg, view + "Lighting Buffer");
+			size_t finaltarget = AddResource(fg, view + "Final Target");
+			size_t debugoutput = AddResource(fg, view + "Debug Output");
+			finaltargets.push_back(finaltarget);
+
+			fg.RegisterGeneralPassNode(view + "Depth pass", {}, { depthbuffer });
+			for (size_t i = 0; i < 4; i++)
+				fg.RegisterGeneralPassNode(view + "Depth Buffer Read Pass" + std::to_string(i), { depthbuffer }, {});
+			fg.RegisterMoveNode(depthbuffer2, depthbuffer);
+			fg.RegisterGeneralPassNode(view + "GBuffer pass", {}, { depthbuffer2, gbuffer1, gbuffer2, gbuffer3 });
+			fg.RegisterGeneralPassNode(view + "Lighting", { depthbuffer2, gbuffer1, gbuffer2, gbuffer3 }, { lightingbuffer });
+			fg.RegisterGeneralPassNode(view + "Post", { lightingbuffer }, { finaltarget });
+			fg.RegisterGeneralPassNode(view + "Debug View", { gbuffer3 }, { debugoutput });
+		}
+		fg.RegisterGeneralPassNode("Present", std::move(finaltargets), {});
+		return fg;
+	}
+}
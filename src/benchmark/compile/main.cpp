@@ -0,0 +1,197 @@
+// compile throughput of UFG::Compiler on generated graphs
+// usage: compile [--format=csv|json] [--max-passes=N] [--min-time=SECONDS] [--filter=GENERATOR]
+// results are written to stdout, one row (csv) or object (json) per generator and size
+
+#include "../common/GraphGenerator.hpp"
+
+#include <UFG/Compiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Ubpa;
+
+// every allocation of the process is counted, and charged to the compilation phases (see CompileStats::CountAllocation)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+namespace {
+	std::atomic<size_t> allocation_num{ 0 };
+	std::atomic<size_t> allocated_bytes{ 0 };
+}
+
+void* operator new(size_t size) {
+	allocation_num.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	UFG::Compiler::CompileStats::CountAllocation(size);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size))
+		return ptr;
+	throw std::bad_alloc{};
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+struct Generator {
+	const char* name;
+	function<UFG::FrameGraph(size_t)> generate;
+};
+
+struct Row {
+	string generator;
+	size_t pass_num;
+	size_t resource_num;
+	size_t edge_num;
+	size_t repetition_num;
+	double min_ns;
+	double median_ns;
+	double mean_ns;
+	size_t allocation_num;
+	size_t allocated_bytes;
+	size_t result_bytes; // estimated, see UFG::Compiler::CompileStats::result_bytes
+	UFG::Compiler::CompileStats stats; // of all repetitions
+};
+
+Row Run(const Generator& generator, size_t pass_num, double min_time) {
+	auto fg = generator.generate(pass_num);
+	UFG::Compiler compiler;
+
+	Row row;
+	row.generator = generator.name;
+
+	// warm up and measure the allocations of one compilation
+	size_t allocation_num_begin = allocation_num.load();
+	size_t allocated_bytes_begin = allocated_bytes.load();
+	UFG::Compiler::CompileStats stats;
+	{
+		auto crst = compiler.Compile(fg, {}, &stats);
+		row.allocation_num = allocation_num.load() - allocation_num_begin;
+		row.allocated_bytes = allocated_bytes.load() - allocated_bytes_begin;
+	}
+	row.pass_num = stats.pass_num;
+	row.resource_num = stats.resource_num;
+	row.edge_num = stats.edge_num;
+	row.result_bytes = stats.result_bytes;
+
+	vector<double> times;
+	double total = 0;
+	while ((total < min_time * 1e9 || times.size() < 3) && times.size() < 1000) {
+		auto begin = chrono::steady_clock::now();
+		auto crst = compiler.Compile(fg, {}, &row.stats);
+		auto ns = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count());
+		times.push_back(ns);
+		total += ns;
+	}
+	sort(times.begin(), times.end());
+	row.repetition_num = times.size();
+	row.min_ns = times.front();
+	row.median_ns = times[times.size() / 2];
+	row.mean_ns = total / times.size();
+	return row;
+}
+
+void PrintCSVHeader() {
+	cout << "generator,passes,resources,edges,repetitions,min_ns,median_ns,mean_ns,ns_per_pass,"
+		"allocations,allocated_bytes,result_bytes";
+	for (auto name : UFG::Compiler::CompileStats::phase_names)
+		cout << ",phase_" << name << "_ns";
+	for (auto name : UFG::Compiler::CompileStats::phase_names)
+		cout << ",phase_" << name << "_allocations";
+	cout << "\n";
+}
+
+void PrintCSV(const Row& row) {
+	cout << row.generator << ',' << row.pass_num << ',' << row.resource_num << ',' << row.edge_num << ','
+		<< row.repetition_num << ',' << row.min_ns << ',' << row.median_ns << ',' << row.mean_ns << ','
+		<< row.median_ns / max<size_t>(row.pass_num, 1) << ','
+		<< row.allocation_num << ',' << row.allocated_bytes << ',' << row.result_bytes;
+	for (auto time : row.stats.phase_times)
+		cout << ',' << time.count() / static_cast<double>(row.stats.compile_num);
+	for (auto num : row.stats.phase_allocation_nums)
+		cout << ',' << num / static_cast<double>(row.stats.compile_num);
+	cout << "\n";
+}
+
+void PrintJSON(const Row& row, bool first) {
+	cout << (first ? "[\n" : ",\n")
+		<< "{\"generator\":\"" << row.generator << "\",\"passes\":" << row.pass_num
+		<< ",\"resources\":" << row.resource_num << ",\"edges\":" << row.edge_num
+		<< ",\"repetitions\":" << row.repetition_num << ",\"min_ns\":" << row.min_ns
+		<< ",\"median_ns\":" << row.median_ns << ",\"mean_ns\":" << row.mean_ns
+		<< ",\"ns_per_pass\":" << row.median_ns / max<size_t>(row.pass_num, 1)
+		<< ",\"allocations\":" << row.allocation_num << ",\"allocated_bytes\":" << row.allocated_bytes
+		<< ",\"result_bytes\":" << row.result_bytes << ",\"phases_ns\":{";
+	for (size_t i = 0; i < UFG::Compiler::CompileStats::PhaseNum; i++) {
+		cout << (i == 0 ? "" : ",") << '"' << UFG::Compiler::CompileStats::phase_names[i] << "\":"
+			<< row.stats.phase_times[i].count() / static_cast<double>(row.stats.compile_num);
+	}
+	cout << "},\"phases_allocations\":{";
+	for (size_t i = 0; i < UFG::Compiler::CompileStats::PhaseNum; i++) {
+		cout << (i == 0 ? "" : ",") << '"' << UFG::Compiler::CompileStats::phase_names[i] << "\":"
+			<< row.stats.phase_allocation_nums[i] / static_cast<double>(row.stats.compile_num);
+	}
+	cout << "}}";
+}
+
+int main(int argc, char** argv) {
+	string format = "csv";
+	size_t max_pass_num = 100000;
+	double min_time = 0.2;
+	string filter;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		auto value = arg.substr(arg.find('=') + 1);
+		if (arg.starts_with("--format="))
+			format = value;
+		else if (arg.starts_with("--max-passes="))
+			max_pass_num = stoull(value);
+		else if (arg.starts_with("--min-time="))
+			min_time = stod(value);
+		else if (arg.starts_with("--filter="))
+			filter = value;
+		else {
+			cerr << "usage: " << argv[0] << " [--format=csv|json] [--max-passes=N] [--min-time=SECONDS] [--filter=GENERATOR]" << endl;
+			return 1;
+		}
+	}
+
+	const Generator generators[] = {
+		{ "chain", [](size_t n) { return GraphGenerator::Chain(n); } },
+		{ "fan_out_in", [](size_t n) { return GraphGenerator::FanOutIn(n); } },
+		{ "move_chain", [](size_t n) { return GraphGenerator::MoveChain(n); } },
+		{ "random_dag", [](size_t n) { return GraphGenerator::RandomDAG(n); } },
+		{ "copy_heavy", [](size_t n) { return GraphGenerator::CopyHeavy(n); } },
+		{ "deferred", [](size_t n) { return GraphGenerator::Deferred(n); } },
+	};
+	const size_t pass_nums[] = { 100, 1000, 10000, 100000 };
+
+	if (format == "csv")
+		PrintCSVHeader();
+	bool first = true;
+	for (const auto& generator : generators) {
+		if (!filter.empty() && filter != generator.name)
+			continue;
+		for (auto pass_num : pass_nums) {
+			if (pass_num > max_pass_num)
+				continue;
+			auto row = Run(generator, pass_num, min_time);
+			if (format == "json")
+				PrintJSON(row, first);
+			else
+				PrintCSV(row);
+			first = false;
+			cout.flush();
+		}
+	}
+	if (format == "json")
+		cout << (first ? "[]\n" : "\n]\n");
+
+	return 0;
+}
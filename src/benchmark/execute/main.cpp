@@ -0,0 +1,555 @@
+// end-to-end execution of generated frame graphs with synthetic pass costs,
+// compares the scheduling strategies on the same persistent worker threads
+// usage: execute [--format=csv|json] [--passes=N] [--threads=1,2,4] [--cost-us=US] [--dist=constant|uniform|exponential|bimodal]
+//                [--frames=N] [--graph=GRAPH] [--executor=EXECUTOR]
+
+#include "../common/GraphGenerator.hpp"
+
+#include <UFG/UFG.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Ubpa;
+
+using Clock = chrono::steady_clock;
+
+static double ElapsedNs(Clock::time_point begin, Clock::time_point end) {
+	return static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - begin).count());
+}
+
+// synthetic CPU work
+static void Spin(double ns) {
+	auto end = Clock::now() + chrono::nanoseconds(static_cast<int64_t>(ns));
+	while (Clock::now() < end)
+		;
+}
+
+struct Scenario {
+	string name;
+	UFG::FrameGraph fg;
+	UFG::Compiler::Result crst;
+	vector<double> costs; // passNodeIdx -> ns
+	double work{ 0 }; // sum of the costs
+	double critical_path{ 0 }; // longest path weighted by the costs
+
+	Scenario(string name, UFG::FrameGraph graph, double mean_cost, const string& dist, uint64_t seed) :
+		name{ std::move(name) }, fg{ std::move(graph) }
+	{
+		UFG::Compiler compiler;
+		crst = compiler.Compile(fg);
+
+		mt19937_64 rng{ seed };
+		costs.resize(fg.GetPassNodes().size(), 0);
+		for (auto pass : crst.sorted_passes) {
+			double cost = mean_cost;
+			if (dist == "uniform")
+				cost = uniform_real_distribution<double>{ 0.5 * mean_cost, 1.5 * mean_cost }(rng);
+			else if (dist == "exponential")
+				cost = exponential_distribution<double>{ 1. / mean_cost }(rng);
+			else if (dist == "bimodal") // 10% heavy passes of 10x, the mean is kept
+				cost = bernoulli_distribution{ 0.1 }(rng) ? 10. * mean_cost / 1.9 : mean_cost / 1.9;
+			costs[pass] = cost;
+			work += cost;
+		}
+
+		vector<double> finishes(costs.size(), 0);
+		for (auto pass : crst.sorted_passes) {
+			finishes[pass] += costs[pass];
+			critical_path = max(critical_path, finishes[pass]);
+			for (auto next : crst.passgraph.adjList.at(pass))
+				finishes[next] = max(finishes[next], finishes[pass]);
+		}
+	}
+};
+
+// acquires and releases the transient resources like 02_parallel, thread-safe.
+// a resource is acquired by its writer, or at the frame begin if it has no writer,
+// the worker completing its last user releases it or moves it to the destination
+class Runtime {
+public:
+	Runtime(const Scenario& scenario, UFG::ConcurrentPool& pool) :
+		scenario{ scenario },
+		pool{ pool },
+		userCounter{ scenario.fg, scenario.crst },
+		handles(scenario.fg.GetResourceNodes().size())
+	{
+		const auto& crst = scenario.crst;
+		for (size_t rsrc = 0; rsrc < crst.rsrcinfos.size(); rsrc++) {
+			if (userCounter.GetUserNum(rsrc) == 0)
+				continue;
+			if (auto target = crst.moves_dst2src.find(rsrc); target != crst.moves_dst2src.end()
+				&& userCounter.GetUserNum(target->second) != 0)
+			{
+				continue; // moved in
+			}
+			if (crst.rsrcinfos[rsrc].writer == static_cast<size_t>(-1))
+				entryRsrcs.push_back(rsrc);
+			else
+				writerRsrcs.push_back(rsrc);
+		}
+		pass2acquires.resize(scenario.fg.GetPassNodes().size());
+		for (auto rsrc : writerRsrcs)
+			pass2acquires[crst.rsrcinfos[rsrc].writer].push_back(rsrc);
+	}
+
+	// not thread-safe
+	void BeginFrame(bool empty) {
+		costScale = empty ? 0. : 1.;
+		busy.store(0, memory_order_relaxed);
+		userCounter.Reset();
+		for (auto rsrc : entryRsrcs)
+			Acquire(rsrc);
+	}
+
+	void RunPass(size_t pass) {
+		for (auto rsrc : pass2acquires[pass])
+			Acquire(rsrc);
+
+		auto begin = Clock::now();
+		Spin(costScale * scenario.costs[pass]);
+		busy.fetch_add(static_cast<uint64_t>(ElapsedNs(begin, Clock::now())), memory_order_relaxed);
+
+		userCounter.Complete(pass, [&](size_t rsrc) {
+			auto target = scenario.crst.moves_src2dst.find(rsrc);
+			if (target != scenario.crst.moves_src2dst.end() && userCounter.GetUserNum(target->second) != 0)
+				handles[target->second] = handles[rsrc];
+			else
+				pool.Release(handles[rsrc]);
+			handles[rsrc] = {};
+		});
+	}
+
+	// time spent in the pass bodies of the frame
+	double GetBusyNs() const noexcept { return static_cast<double>(busy.load(memory_order_relaxed)); }
+
+private:
+	void Acquire(size_t rsrc) {
+		size_t size = max<size_t>(scenario.fg.GetResourceNodes()[rsrc].GetSize(), 1);
+		handles[rsrc] = pool.Acquire({ size, alignof(max_align_t) });
+	}
+
+	const Scenario& scenario;
+	UFG::ConcurrentPool& pool;
+	UFG::UserCounter userCounter;
+	vector<UFG::ConcurrentPool::Handle> handles;
+	vector<size_t> entryRsrcs;
+	vector<size_t> writerRsrcs;
+	vector<vector<size_t>> pass2acquires;
+	double costScale{ 1. };
+	atomic<uint64_t> busy{ 0 };
+};
+
+// persistent threads running one job per call of Run, the caller waits for all of them
+class Workers {
+public:
+	Workers(size_t n) {
+		for (size_t i = 0; i < n; i++) {
+			threads.emplace_back([this, i]() {
+				uint64_t seen = 0;
+				while (true) {
+					{
+						unique_lock<mutex> lk(m);
+						cv.wait(lk, [&]() { return shutdown || generation != seen; });
+						if (shutdown)
+							return;
+						seen = generation;
+					}
+					job(i);
+					{
+						lock_guard<mutex> lk(m);
+						if (--running == 0)
+							cv_done.notify_one();
+					}
+				}
+			});
+		}
+	}
+
+	~Workers() {
+		{
+			lock_guard<mutex> lk(m);
+			shutdown = true;
+		}
+		cv.notify_all();
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	size_t Size() const noexcept { return threads.size(); }
+
+	void Run(function<void(size_t)> func) {
+		unique_lock<mutex> lk(m);
+		job = std::move(func);
+		running = threads.size();
+		++generation;
+		cv.notify_all();
+		cv_done.wait(lk, [&]() { return running == 0; });
+	}
+
+private:
+	vector<thread> threads;
+	mutex m;
+	condition_variable cv;
+	condition_variable cv_done;
+	function<void(size_t)> job;
+	uint64_t generation{ 0 };
+	size_t running{ 0 };
+	bool shutdown{ false };
+};
+
+class Executor {
+public:
+	virtual ~Executor() = default;
+	virtual const char* Name() const noexcept = 0;
+	// precompute the schedule of the scenario, called before its frames
+	virtual void Prepare(const Scenario&, size_t) {}
+	virtual void Execute(const Scenario& scenario, Runtime& runtime, Workers& workers) = 0;
+};
+
+// sorted_passes on the calling thread
+class SerialExecutor : public Executor {
+public:
+	const char* Name() const noexcept override { return "serial"; }
+	void Execute(const Scenario& scenario, Runtime& runtime, Workers&) override {
+		for (auto pass : scenario.crst.sorted_passes)
+			runtime.RunPass(pass);
+	}
+};
+
+// the passes of a level (longest path from the sources) run in parallel, a barrier between levels
+class LevelParallelExecutor : public Executor {
+public:
+	const char* Name() const noexcept override { return "level_parallel"; }
+	void Prepare(const Scenario& scenario, size_t) override {
+		levels.clear();
+		vector<size_t> pass2level(scenario.fg.GetPassNodes().size(), 0);
+		for (auto pass : scenario.crst.sorted_passes) {
+			size_t level = pass2level[pass];
+			if (levels.size() <= level)
+				levels.resize(level + 1);
+			levels[level].push_back(pass);
+			for (auto next : scenario.crst.passgraph.adjList.at(pass))
+				pass2level[next] = max(pass2level[next], level + 1);
+		}
+	}
+
+	void Execute(const Scenario&, Runtime& runtime, Workers& workers) override {
+		for (const auto& level : levels) {
+			atomic<size_t> cursor{ 0 };
+			workers.Run([&](size_t) {
+				for (size_t i = cursor.fetch_add(1); i < level.size(); i = cursor.fetch_add(1))
+					runtime.RunPass(level[i]);
+			});
+		}
+	}
+
+private:
+	vector<vector<size_t>> levels;
+};
+
+// dependency-driven, a completed pass pushes its ready successors to the worker's own deque,
+// idle workers steal the oldest pass of the others
+class WorkStealingExecutor : public Executor {
+public:
+	const char* Name() const noexcept override { return "work_stealing"; }
+	void Execute(const Scenario& scenario, Runtime& runtime, Workers& workers) override {
+		const auto& crst = scenario.crst;
+		size_t passNum = scenario.fg.GetPassNodes().size();
+		unique_ptr<atomic<size_t>[]> remain_pred_cnts{ new atomic<size_t>[passNum] };
+		for (size_t i = 0; i < passNum; i++)
+			remain_pred_cnts[i].store(0, memory_order_relaxed);
+		for (const auto& [pass, adj] : crst.passgraph.adjList) {
+			for (auto next : adj)
+				remain_pred_cnts[next].fetch_add(1, memory_order_relaxed);
+		}
+
+		vector<Queue> queues(workers.Size());
+		size_t source_num = 0;
+		for (auto pass : crst.sorted_passes) {
+			if (remain_pred_cnts[pass].load(memory_order_relaxed) == 0)
+				queues[source_num++ % queues.size()].passes.push_back(pass);
+		}
+		atomic<size_t> remain_pass_num{ crst.sorted_passes.size() };
+
+		workers.Run([&](size_t worker) {
+			auto& own = queues[worker];
+			while (remain_pass_num.load(memory_order_acquire) != 0) {
+				size_t pass = own.PopBack();
+				for (size_t i = 1; pass == npos && i < queues.size(); i++)
+					pass = queues[(worker + i) % queues.size()].PopFront();
+				if (pass == npos) {
+					this_thread::yield();
+					continue;
+				}
+
+				runtime.RunPass(pass);
+				for (auto next : crst.passgraph.adjList.at(pass)) {
+					if (remain_pred_cnts[next].fetch_sub(1, memory_order_acq_rel) == 1)
+						own.PushBack(next);
+				}
+				remain_pass_num.fetch_sub(1, memory_order_release);
+			}
+		});
+	}
+
+private:
+	static constexpr size_t npos = static_cast<size_t>(-1);
+
+	struct alignas(64) Queue {
+		mutex m;
+		deque<size_t> passes;
+
+		void PushBack(size_t pass) {
+			lock_guard<mutex> lk(m);
+			passes.push_back(pass);
+		}
+		size_t PopBack() {
+			lock_guard<mutex> lk(m);
+			if (passes.empty())
+				return npos;
+			size_t pass = passes.back();
+			passes.pop_back();
+			return pass;
+		}
+		size_t PopFront() {
+			lock_guard<mutex> lk(m);
+			if (passes.empty())
+				return npos;
+			size_t pass = passes.front();
+			passes.pop_front();
+			return pass;
+		}
+	};
+};
+
+// list scheduling ahead of the frame with the known costs (Compiler::Options::pass_costs) : the ready pass with the longest path to the sinks
+// goes to the worker that can start it first, at run time a worker waits for the predecessors of its next pass
+class StaticListExecutor : public Executor {
+public:
+	const char* Name() const noexcept override { return "static_list"; }
+	void Execute(const Scenario& scenario, Runtime& runtime, Workers& workers) override {
+		const auto& crst = scenario.crst;
+		size_t passNum = scenario.fg.GetPassNodes().size();
+		assert(lists.size() == workers.Size());
+
+		unique_ptr<atomic<uint32_t>[]> remain_pred_cnts{ new atomic<uint32_t>[passNum] };
+		for (size_t i = 0; i < passNum; i++)
+			remain_pred_cnts[i].store(pred_cnts[i], memory_order_relaxed);
+
+		workers.Run([&](size_t worker) {
+			for (auto pass : lists[worker]) {
+				auto& cnt = remain_pred_cnts[pass];
+				for (uint32_t cur = cnt.load(memory_order_acquire); cur != 0; cur = cnt.load(memory_order_acquire))
+					cnt.wait(cur, memory_order_acquire);
+
+				runtime.RunPass(pass);
+				for (auto next : crst.passgraph.adjList.at(pass)) {
+					if (remain_pred_cnts[next].fetch_sub(1, memory_order_acq_rel) == 1)
+						remain_pred_cnts[next].notify_all();
+				}
+			}
+		});
+	}
+
+	void Prepare(const Scenario& scenario, size_t worker_num) override {
+		const auto& crst = scenario.crst;
+		size_t passNum = scenario.fg.GetPassNodes().size();
+
+		pred_cnts.assign(passNum, 0);
+		for (const auto& [pass, adj] : crst.passgraph.adjList) {
+			for (auto next : adj)
+				pred_cnts[next]++;
+		}
+
+		// the same pass graph, the compiler assigns the passes by static list scheduling with the costs
+		UFG::Compiler::Options options;
+		options.pass_costs = scenario.costs;
+		options.worker_num = worker_num;
+		lists = UFG::Compiler{}.Compile(scenario.fg, options).list_schedule.worker2passes;
+	}
+
+private:
+	vector<uint32_t> pred_cnts;
+	vector<vector<size_t>> lists; // worker -> passes in order
+};
+
+struct Row {
+	string graph;
+	string executor;
+	size_t thread_num;
+	size_t pass_num;
+	double work_ns;
+	double critical_path_ns;
+	double frame_ns; // median
+	double bound_ns; // max(critical path, work / threads)
+	double utilization; // busy / (frame * threads)
+	double overhead_ns_per_pass; // frame time of empty passes * threads / passes
+};
+
+Row Measure(const Scenario& scenario, Executor& executor, Workers& workers, UFG::ConcurrentPool& pool, size_t frame_num) {
+	size_t thread_num = string_view{ executor.Name() } == "serial" ? 1 : workers.Size();
+	Runtime runtime(scenario, pool);
+	executor.Prepare(scenario, workers.Size());
+
+	auto run = [&](bool empty, double* busy) {
+		runtime.BeginFrame(empty);
+		auto begin = Clock::now();
+		executor.Execute(scenario, runtime, workers);
+		double ns = ElapsedNs(begin, Clock::now());
+		pool.NextFrame();
+		if (busy)
+			*busy = runtime.GetBusyNs();
+		return ns;
+	};
+
+	run(false, nullptr); // warm up the pool
+	vector<double> frames, busys;
+	for (size_t i = 0; i < frame_num; i++) {
+		double busy;
+		frames.push_back(run(false, &busy));
+		busys.push_back(busy);
+	}
+	vector<double> empty_frames;
+	for (size_t i = 0; i < frame_num; i++)
+		empty_frames.push_back(run(true, nullptr));
+
+	auto median = [](vector<double> values) {
+		sort(values.begin(), values.end());
+		return values[values.size() / 2];
+	};
+
+	Row row;
+	row.graph = scenario.name;
+	row.executor = executor.Name();
+	row.thread_num = thread_num;
+	row.pass_num = scenario.crst.sorted_passes.size();
+	row.work_ns = scenario.work;
+	row.critical_path_ns = scenario.critical_path;
+	row.frame_ns = median(frames);
+	row.bound_ns = max(scenario.critical_path, scenario.work / thread_num);
+	row.utilization = median(busys) / (row.frame_ns * thread_num);
+	row.overhead_ns_per_pass = median(empty_frames) * thread_num / max<size_t>(row.pass_num, 1);
+	return row;
+}
+
+int main(int argc, char** argv) {
+	string format = "csv";
+	size_t pass_num = 1000;
+	vector<size_t> thread_nums;
+	double cost_us = 20;
+	string dist = "constant";
+	size_t frame_num = 5;
+	string graph_filter;
+	string executor_filter;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		auto value = arg.substr(arg.find('=') + 1);
+		if (arg.starts_with("--format="))
+			format = value;
+		else if (arg.starts_with("--passes="))
+			pass_num = stoull(value);
+		else if (arg.starts_with("--threads=")) {
+			for (size_t begin = 0; begin < value.size();) {
+				size_t end = min(value.find(',', begin), value.size());
+				thread_nums.push_back(stoull(value.substr(begin, end - begin)));
+				begin = end + 1;
+			}
+		}
+		else if (arg.starts_with("--cost-us="))
+			cost_us = stod(value);
+		else if (arg.starts_with("--dist="))
+			dist = value;
+		else if (arg.starts_with("--frames="))
+			frame_num = max<size_t>(stoull(value), 1);
+		else if (arg.starts_with("--graph="))
+			graph_filter = value;
+		else if (arg.starts_with("--executor="))
+			executor_filter = value;
+		else {
+			cerr << "usage: " << argv[0] << " [--format=csv|json] [--passes=N] [--threads=1,2,4] [--cost-us=US]"
+				" [--dist=constant|uniform|exponential|bimodal] [--frames=N] [--graph=GRAPH] [--executor=EXECUTOR]" << endl;
+			return 1;
+		}
+	}
+	if (thread_nums.empty()) {
+		for (size_t n = 1; n < thread::hardware_concurrency(); n *= 2)
+			thread_nums.push_back(n);
+		thread_nums.push_back(max(thread::hardware_concurrency(), 1u));
+	}
+
+	struct Graph {
+		const char* name;
+		function<UFG::FrameGraph(size_t)> generate;
+	};
+	const Graph graphs[] = {
+		{ "deferred", [](size_t n) { return GraphGenerator::Deferred(n); } },
+		{ "random_dag", [](size_t n) { return GraphGenerator::RandomDAG(n); } },
+		{ "fan_out_in", [](size_t n) { return GraphGenerator::FanOutIn(n); } },
+		{ "chain", [](size_t n) { return GraphGenerator::Chain(n); } },
+	};
+
+	vector<unique_ptr<Executor>> executors;
+	executors.push_back(make_unique<SerialExecutor>());
+	executors.push_back(make_unique<LevelParallelExecutor>());
+	executors.push_back(make_unique<WorkStealingExecutor>());
+	executors.push_back(make_unique<StaticListExecutor>());
+
+	if (format == "csv") {
+		cout << "graph,executor,threads,passes,work_ns,critical_path_ns,frame_ns,bound_ns,bound_ratio,"
+			"utilization,overhead_ns_per_pass\n";
+	}
+	bool first = true;
+	UFG::ConcurrentPool pool;
+	for (const auto& graph : graphs) {
+		if (!graph_filter.empty() && graph_filter != graph.name)
+			continue;
+		Scenario scenario(graph.name, graph.generate(pass_num), cost_us * 1000., dist, 0);
+
+		for (auto thread_num : thread_nums) {
+			Workers workers(thread_num);
+			for (const auto& executor : executors) {
+				if (!executor_filter.empty() && executor_filter != executor->Name())
+					continue;
+				if (string_view{ executor->Name() } == "serial" && thread_num != thread_nums.front())
+					continue;
+
+				auto row = Measure(scenario, *executor, workers, pool, frame_num);
+				double bound_ratio = row.frame_ns / row.bound_ns;
+				if (format == "json") {
+					cout << (first ? "[\n" : ",\n")
+						<< "{\"graph\":\"" << row.graph << "\",\"executor\":\"" << row.executor
+						<< "\",\"threads\":" << row.thread_num << ",\"passes\":" << row.pass_num
+						<< ",\"work_ns\":" << row.work_ns << ",\"critical_path_ns\":" << row.critical_path_ns
+						<< ",\"frame_ns\":" << row.frame_ns << ",\"bound_ns\":" << row.bound_ns
+						<< ",\"bound_ratio\":" << bound_ratio << ",\"utilization\":" << row.utilization
+						<< ",\"overhead_ns_per_pass\":" << row.overhead_ns_per_pass << "}";
+				}
+				else {
+					cout << row.graph << ',' << row.executor << ',' << row.thread_num << ',' << row.pass_num << ','
+						<< row.work_ns << ',' << row.critical_path_ns << ',' << row.frame_ns << ',' << row.bound_ns << ','
+						<< bound_ratio << ',' << row.utilization << ',' << row.overhead_ns_per_pass << "\n";
+				}
+				first = false;
+				cout.flush();
+			}
+		}
+	}
+	if (format == "json")
+		cout << (first ? "[]\n" : "\n]\n");
+
+	return 0;
+}
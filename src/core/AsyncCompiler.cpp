@@ -0,0 +1,99 @@
+#include <UFG/AsyncCompiler.hpp>
+
+#include <stdexcept>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+AsyncCompiler::AsyncCompiler(Compiler compiler)
+	: compiler{ std::move(compiler) }, worker{ [this]() { Run(); } } {}
+
+AsyncCompiler::~AsyncCompiler() {
+	Cancel();
+	{
+		std::lock_guard<std::mutex> lk(m);
+		shutdown = true;
+	}
+	cv.notify_one();
+	worker.join();
+}
+
+AsyncCompiler::Future AsyncCompiler::Submit(FrameGraph fg, Callback callback) {
+	return Submit(std::move(fg), Compiler::Options{}, std::move(callback));
+}
+
+AsyncCompiler::Future AsyncCompiler::Submit(FrameGraph fg, Compiler::Options options, Callback callback) {
+	auto request = std::make_unique<Request>();
+	request->fg = std::make_unique<FrameGraph>(std::move(fg));
+	request->options = std::move(options);
+	request->callback = std::move(callback);
+	Future future = request->promise.get_future().share();
+
+	std::unique_ptr<Request> stale;
+	{
+		std::lock_guard<std::mutex> lk(m);
+		request->generation = ++latestGeneration;
+		stale = std::move(pending);
+		pending = std::move(request);
+	}
+	cv.notify_one();
+
+	if (stale)
+		stale->promise.set_value(nullptr);
+
+	return future;
+}
+
+void AsyncCompiler::Cancel() {
+	std::unique_ptr<Request> stale;
+	{
+		std::lock_guard<std::mutex> lk(m);
+		++latestGeneration; // the running one becomes stale
+		stale = std::move(pending);
+	}
+	if (stale)
+		stale->promise.set_value(nullptr);
+}
+
+void AsyncCompiler::Run() {
+	while (true) {
+		std::unique_ptr<Request> request;
+		{
+			std::unique_lock<std::mutex> lk(m);
+			cv.wait(lk, [this]() { return shutdown || pending; });
+			if (shutdown)
+				return;
+			request = std::move(pending);
+		}
+
+		std::shared_ptr<Snapshot> snapshot;
+		try {
+			auto result = compiler.Compile(*request->fg, request->options);
+			snapshot = std::make_shared<Snapshot>(Snapshot{
+				std::move(*request->fg),
+				std::move(result),
+				request->generation });
+		}
+		catch (...) {
+			request->promise.set_exception(std::current_exception());
+			continue;
+		}
+
+		if (request->generation != latestGeneration.load()) {
+			request->promise.set_value(nullptr); // superseded while compiling
+			continue;
+		}
+
+		published.store(snapshot, std::memory_order_release);
+		try {
+			if (request->callback)
+				request->callback(snapshot);
+		}
+		catch (...) {
+			// the snapshot stays published, the future rethrows
+			request->promise.set_exception(std::current_exception());
+			continue;
+		}
+		request->promise.set_value(snapshot);
+	}
+}
@@ -2,10 +2,16 @@
 
 #include <UFG/ResourceNode.hpp>
 
+#include "detail/MemoryChains.hpp"
+
 #include <algorithm>
+#include <queue>
 #include <stack>
+#include <unordered_set>
 #include <cassert>
 #include <stdexcept>
+#include <string>
+#include <tuple>
 
 using namespace Ubpa;
 
@@ -52,256 +58,1278 @@ std::optional<std::vector<size_t>> Compiler::Result::PassGraph::TopoSort() const
 	return sorted_vertices;
 }
 
-Compiler::Result Compiler::Compile(const FrameGraph& fg) {
-	Result rst;
-	auto passes = fg.GetPassNodes();
+namespace Ubpa::UFG::details {
+	// allocations of the thread, see Compiler::CompileStats::CountAllocation
+	static thread_local size_t thread_allocation_num = 0;
+	static thread_local size_t thread_allocated_bytes = 0;
+
+	// adds the time and the allocations since the last phase to stats, nothing if stats is nullptr
+	class PhaseTimer {
+	public:
+		PhaseTimer(Compiler::CompileStats* stats) : stats{ stats } {
+			if (stats) {
+				last = std::chrono::steady_clock::now();
+				last_allocation_num = thread_allocation_num;
+				last_allocated_bytes = thread_allocated_bytes;
+			}
+		}
+
+		void End(Compiler::CompileStats::Phase phase) {
+			if (!stats)
+				return;
+			auto now = std::chrono::steady_clock::now();
+			stats->phase_times[phase] += now - last;
+			stats->phase_allocation_nums[phase] += thread_allocation_num - last_allocation_num;
+			stats->phase_allocated_bytes[phase] += thread_allocated_bytes - last_allocated_bytes;
+			last = now;
+			last_allocation_num = thread_allocation_num;
+			last_allocated_bytes = thread_allocated_bytes;
+		}
 
-	rst.rsrcinfos.resize(fg.GetResourceNodes().size());
+	private:
+		Compiler::CompileStats* stats;
+		std::chrono::steady_clock::time_point last;
+		size_t last_allocation_num{ 0 };
+		size_t last_allocated_bytes{ 0 };
+	};
 
-	// set every resource's readers, writer, copy-in
-	for (size_t i = 0; i < passes.size(); i++) {
-		const auto& pass = passes[i];
-		switch (pass.GetType())
+	// mask independent part of the compilation, shared by the variants
+	struct Analysis {
+		// accessors of every resource with all passes enabled,
+		// exclusive conditional passes may write (copy-in) the same resource
+		struct Accessors {
+			std::vector<size_t> writers;
+			std::vector<size_t> readers;
+			std::vector<size_t> copy_ins;
+		};
+		std::vector<Accessors> rsrcaccessors;
+		std::unordered_map<size_t, size_t> moves_src2dst; // before pruning
+		uint64_t condition_mask{ 0 };
+	};
+
+	static Analysis Analyze(const FrameGraph& fg) {
+		Analysis analysis;
+		auto passes = fg.GetPassNodes();
+
+		analysis.rsrcaccessors.resize(fg.GetResourceNodes().size());
+
+		// set every resource's readers, writers, copy-ins
+		for (size_t i = 0; i < passes.size(); i++) {
+			const auto& pass = passes[i];
+			if (pass.IsConditional())
+				analysis.condition_mask |= uint64_t{ 1 } << pass.GetCondition();
+			switch (pass.GetType())
+			{
+			case PassNode::Type::General: {
+				for (const auto& input : fg.GetPassNodeInputs(pass))
+					analysis.rsrcaccessors[input].readers.push_back(i);
+				for (const auto& output : fg.GetPassNodeOutputs(pass))
+					analysis.rsrcaccessors[output].writers.push_back(i);
+			} break;
+			case PassNode::Type::Copy: {
+				auto inputs = fg.GetPassNodeInputs(pass);
+				auto outputs = fg.GetPassNodeOutputs(pass);
+				for (size_t idx = 0; idx < inputs.size(); idx++) {
+					analysis.rsrcaccessors[inputs[idx]].readers.push_back(i);
+					analysis.rsrcaccessors[outputs[idx]].copy_ins.push_back(i);
+				}
+			} break;
+			default:
+				assert(false); // no entry
+				break;
+			}
+		}
+
+		// previous nodes are read-only
+		for (size_t rsrcNodeIdx = 0; rsrcNodeIdx < analysis.rsrcaccessors.size(); rsrcNodeIdx++) {
+			const auto& accessors = analysis.rsrcaccessors[rsrcNodeIdx];
+			if (fg.GetResourceNodes()[rsrcNodeIdx].IsPrevious()
+				&& (!accessors.writers.empty() || !accessors.copy_ins.empty()))
+			{
+				throw std::logic_error("write previous version");
+			}
+		}
+
+		// set move map
 		{
-		case PassNode::Type::General: {
-			for (const auto& input : pass.Inputs())
-				rst.rsrcinfos[input].readers.push_back(i);
-			for (const auto& output : pass.Outputs()) {
-				size_t& writer = rst.rsrcinfos[output].writer;
-				if (writer != static_cast<size_t>(-1))
-					throw std::logic_error("multi writers");
-				writer = i;
-			}
-		} break;
-		case PassNode::Type::Copy: {
-			for (size_t idx = 0; idx < pass.Inputs().size(); idx++) {
-				rst.rsrcinfos[pass.Inputs()[idx]].readers.push_back(i);
-				size_t& copy_in = rst.rsrcinfos[pass.Outputs()[idx]].copy_in;
-				if (copy_in != static_cast<size_t>(-1))
-					throw std::logic_error("multi copy_ins");
-				copy_in = i;
+			std::unordered_set<size_t> movedsts;
+			for (const auto& moveNode : fg.GetMoveNodes()) {
+				auto src = moveNode.GetSourceNodeIndex();
+				auto dst = moveNode.GetDestinationNodeIndex();
+				if (fg.GetResourceNodes()[src].IsPersistent() || fg.GetResourceNodes()[dst].IsPersistent())
+					throw std::logic_error("move persistent resource");
+				if (analysis.moves_src2dst.contains(src))
+					throw std::logic_error("move out more than once");
+				if (movedsts.contains(dst))
+					throw std::logic_error("move in more than once");
+				analysis.moves_src2dst.emplace(src, dst);
+				movedsts.insert(dst);
+			}
+		}
+
+		return analysis;
+	}
+
+	static bool IsAccessed(const Compiler::Result::RsrcInfo& info) noexcept {
+		return info.writer != static_cast<size_t>(-1)
+			|| !info.readers.empty()
+			|| info.copy_in != static_cast<size_t>(-1);
+	}
+
+	// set resource's first last and passinfo
+	// rst.sorted_passes, rst.rsrcinfos (writer, readers, copy_in) and the move maps must be ready.
+	// only the resources in rsrcs get lifetime and construction
+	static void SetLifetimes(Compiler::Result& rst, size_t passNum, std::span<const size_t> rsrcs) {
+		// the passes out of sorted_passes are npos in a pass2order of passNum entries
+		if (rst.pass2order.size() != passNum)
+			rst.pass2order.assign(passNum, static_cast<size_t>(-1));
+		for (size_t i = 0; i < rst.sorted_passes.size(); i++)
+			rst.pass2order[rst.sorted_passes[i]] = i;
+
+		for (auto pass : rst.sorted_passes)
+			rst.pass2info.emplace(pass, Compiler::Result::PassInfo());
+
+		for (auto rsrcNodeIdx : rsrcs) {
+			auto& info = rst.rsrcinfos[rsrcNodeIdx];
+
+			if (info.writer != static_cast<size_t>(-1))
+				info.first = rst.pass2order[info.writer];
+			else if (!info.readers.empty()) {
+				size_t first = static_cast<size_t>(-1); // max size_t
+				for (const auto& reader : info.readers)
+					first = std::min(first, rst.pass2order[reader]);
+				info.first = first;
 			}
-		} break;
-		default:
-			assert(false); // no entry
-			break;
+			else if (info.copy_in != static_cast<size_t>(-1))
+				info.first = rst.pass2order[info.copy_in];
+			//else [[do nothing]]; // info.first = static_cast<size_t>(-1)
+
+			info.last = info.first;
+			if (info.copy_in != static_cast<size_t>(-1))
+				info.last = rst.pass2order[info.copy_in];
+			else {
+				for (const auto& reader : info.readers) {
+					if (info.last == static_cast<size_t>(-1))
+						info.last = rst.pass2order[reader];
+					else
+						info.last = std::max(info.last, rst.pass2order[reader]);
+				}
+			}
+		}
+
+		for (auto rsrcNodeIdx : rsrcs) {
+			auto& info = rst.rsrcinfos[rsrcNodeIdx];
+
+			if (info.first == static_cast<size_t>(-1)) {
+				auto target = rst.moves_dst2src.find(rsrcNodeIdx);
+				if (target != rst.moves_dst2src.end()) {
+					info.first = rst.rsrcinfos[target->second].last;
+					if (info.last == static_cast<size_t>(-1))
+						info.last = info.first;
+					assert(info.last >= info.first);
+				}
+			}
+		}
+
+		for (auto rsrcNodeIdx : rsrcs) {
+			const auto& info = rst.rsrcinfos[rsrcNodeIdx];
+
+			size_t firstPassIdx = info.first != static_cast<size_t>(-1) ? rst.sorted_passes[info.first]
+				: static_cast<size_t>(-1);
+			size_t lastPassIdx = info.last != static_cast<size_t>(-1) ? rst.sorted_passes[info.last]
+				: static_cast<size_t>(-1);
+			if (!rst.moves_dst2src.contains(rsrcNodeIdx))
+				rst.pass2info[firstPassIdx].construct_resources.push_back(rsrcNodeIdx);
+			if (rst.moves_src2dst.contains(rsrcNodeIdx))
+				rst.pass2info[lastPassIdx].move_resources.push_back(rsrcNodeIdx);
+			else
+				rst.pass2info[lastPassIdx].destruct_resources.push_back(rsrcNodeIdx);
 		}
 	}
 
-	// set move map
+	MemoryChains CollectMemoryChains(const FrameGraph& fg, const Compiler::Result& rst) {
+		std::vector<size_t> all(rst.rsrcinfos.size());
+		for (size_t rsrc = 0; rsrc < all.size(); rsrc++)
+			all[rsrc] = rsrc;
+		return CollectMemoryChains(fg, rst, all);
+	}
+
+	MemoryChains CollectMemoryChains(const FrameGraph& fg, const Compiler::Result& rst, std::span<const size_t> candidates) {
+		MemoryChains chains;
+		chains.pass2chains.resize(fg.GetPassNodes().size());
+		const auto rsrcs = fg.GetResourceNodes();
+
+		std::vector<size_t> users;
+		for (auto root : candidates) {
+			if (rsrcs[root].IsPersistent() || rst.moves_dst2src.contains(root))
+				continue;
+
+			size_t size = 0;
+			users.clear();
+			for (size_t rsrc = root; rsrc != static_cast<size_t>(-1);) {
+				const auto& info = rst.rsrcinfos[rsrc];
+				size = std::max(size, rsrcs[rsrc].GetSize());
+				if (info.writer != static_cast<size_t>(-1))
+					users.push_back(info.writer);
+				users.insert(users.end(), info.readers.begin(), info.readers.end());
+				if (info.copy_in != static_cast<size_t>(-1))
+					users.push_back(info.copy_in);
+				auto target = rst.moves_src2dst.find(rsrc);
+				rsrc = target != rst.moves_src2dst.end() ? target->second : static_cast<size_t>(-1);
+			}
+			if (size == 0 || users.empty())
+				continue;
+
+			std::sort(users.begin(), users.end());
+			users.erase(std::unique(users.begin(), users.end()), users.end());
+
+			size_t chain = chains.sizes.size();
+			chains.sizes.push_back(size);
+			chains.roots.push_back(root);
+			chains.user_nums.push_back(users.size());
+			chains.preallocated.push_back(!IsAccessed(rst.rsrcinfos[root]));
+			for (auto user : users)
+				chains.pass2chains[user].push_back(chain);
+			chains.total_bytes += size;
+		}
+
+		return chains;
+	}
+
+	struct MemoryPeak {
+		size_t bytes{ 0 };
+		size_t pass{ static_cast<size_t>(-1) };
+		std::vector<size_t> chains; // live at the peak
+	};
+
+	// the chains are allocated at their first accessor and freed after their last one
+	// position2bytes : index in order -> live bytes, optional
+	static MemoryPeak ComputeMemoryPeak(const MemoryChains& chains, std::span<const size_t> order,
+		std::vector<size_t>* position2bytes = nullptr)
 	{
-		std::unordered_set<size_t> movedsts;
-		for (const auto& moveNode : fg.GetMoveNodes()) {
-			auto src = moveNode.GetSourceNodeIndex();
-			auto dst = moveNode.GetDestinationNodeIndex();
-			if (rst.moves_src2dst.contains(src))
-				throw std::logic_error("move out more than once");
-			if (movedsts.contains(dst))
-				throw std::logic_error("move in more than once");
-			rst.moves_src2dst.emplace(src, dst);
-			movedsts.insert(dst);
+		MemoryPeak peak;
+		std::vector<size_t> remain_user_nums = chains.user_nums;
+		std::vector<bool> live = chains.preallocated;
+		size_t live_bytes = 0;
+		for (size_t chain = 0; chain < chains.sizes.size(); chain++) {
+			if (live[chain])
+				live_bytes += chains.sizes[chain];
+		}
+
+		size_t peak_position = static_cast<size_t>(-1);
+		for (size_t position = 0; position < order.size(); position++) {
+			size_t pass = order[position];
+			for (auto chain : chains.pass2chains[pass]) {
+				if (!live[chain]) {
+					live[chain] = true;
+					live_bytes += chains.sizes[chain];
+				}
+			}
+			if (position2bytes)
+				position2bytes->push_back(live_bytes);
+			if (peak.pass == static_cast<size_t>(-1) || live_bytes > peak.bytes) {
+				peak.bytes = live_bytes;
+				peak.pass = pass;
+				peak_position = position;
+			}
+			for (auto chain : chains.pass2chains[pass]) {
+				if (--remain_user_nums[chain] == 0) {
+					live[chain] = false;
+					live_bytes -= chains.sizes[chain];
+				}
+			}
+		}
+
+		if (peak.pass == static_cast<size_t>(-1))
+			return peak;
+
+		// live at the peak : allocated at or before the peak and freed at or after it
+		std::vector<size_t> first_positions(chains.sizes.size(), static_cast<size_t>(-1));
+		std::vector<size_t> last_positions(chains.sizes.size(), 0);
+		for (size_t position = 0; position < order.size(); position++) {
+			for (auto chain : chains.pass2chains[order[position]]) {
+				first_positions[chain] = std::min(first_positions[chain], position);
+				last_positions[chain] = position;
+			}
+		}
+		for (size_t chain = 0; chain < chains.sizes.size(); chain++) {
+			bool allocated = chains.preallocated[chain] || first_positions[chain] <= peak_position;
+			if (allocated && last_positions[chain] >= peak_position)
+				peak.chains.push_back(chain);
 		}
+
+		return peak;
 	}
 
-	// set copy map
+	// longest path in passes, pass2order : passNodeIdx -> index in sorted_passes
+	static size_t CountLevels(const Compiler::Result::PassGraph& passgraph, std::span<const size_t> sorted_passes,
+		std::span<const size_t> pass2order)
 	{
-		std::unordered_set<size_t> copydsts;
-		for (const auto& pass : fg.GetPassNodes()) {
-			if (pass.GetType() != PassNode::Type::Copy)
+		std::vector<size_t> levels(sorted_passes.size(), 0); // order -> level
+		size_t level_num = 0;
+		for (size_t i = 0; i < sorted_passes.size(); i++) {
+			level_num = std::max(level_num, levels[i] + 1);
+			for (auto next : passgraph.adjList.at(sorted_passes[i])) {
+				size_t& level = levels[pass2order[next]];
+				level = std::max(level, levels[i] + 1);
+			}
+		}
+		return level_num;
+	}
+
+	// list scheduling over the pass graph, among the ready passes fitting in the budget the one freeing most goes first,
+	// otherwise the one allocating least. ties keep the order of the pass graph's topological sort.
+	// the ready passes are kept in heaps keyed on their memory delta and allocation, a pass is re-keyed (lazily,
+	// stale entries are skipped) when one of its chains gets allocated or is left to it as the last user
+	static std::vector<size_t> MemoryAwareSort(const Compiler::Result& rst, const MemoryChains& chains, size_t budget) {
+		std::vector<size_t> remain_pred_cnts(rst.pass2order.size(), 0);
+		for (const auto& [pass, adj] : rst.passgraph.adjList) {
+			for (auto next : adj)
+				remain_pred_cnts[next]++;
+		}
+
+		std::vector<std::vector<size_t>> chain2passes(chains.sizes.size());
+		for (auto pass : rst.sorted_passes) {
+			for (auto chain : chains.pass2chains[pass])
+				chain2passes[chain].push_back(pass);
+		}
+
+		std::vector<size_t> remain_user_nums = chains.user_nums;
+		std::vector<bool> live = chains.preallocated;
+		size_t live_bytes = 0;
+		for (size_t chain = 0; chain < chains.sizes.size(); chain++) {
+			if (live[chain])
+				live_bytes += chains.sizes[chain];
+		}
+
+		// bytes the pass would allocate and free if it ran next
+		std::vector<long long> alloc_bytes(rst.pass2order.size(), 0);
+		std::vector<long long> free_bytes(rst.pass2order.size(), 0);
+		for (auto pass : rst.sorted_passes) {
+			for (auto chain : chains.pass2chains[pass]) {
+				if (!live[chain])
+					alloc_bytes[pass] += chains.sizes[chain];
+				if (remain_user_nums[chain] == 1)
+					free_bytes[pass] += chains.sizes[chain];
+			}
+		}
+
+		enum class State : uint8_t { Waiting, Ready, Done };
+		std::vector<State> states(rst.pass2order.size(), State::Waiting);
+
+		// (key, order, pass), min-heaps. the keys only decrease, so an entry is stale iff its key is above the current one
+		using Entry = std::tuple<long long, size_t, size_t>;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> delta_heap;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> alloc_heap;
+		auto push = [&](size_t pass) {
+			delta_heap.emplace(alloc_bytes[pass] - free_bytes[pass], rst.pass2order[pass], pass);
+			alloc_heap.emplace(alloc_bytes[pass], rst.pass2order[pass], pass);
+		};
+		auto is_stale = [&](const Entry& entry, bool delta) {
+			size_t pass = std::get<2>(entry);
+			if (states[pass] != State::Ready)
+				return true;
+			return std::get<0>(entry) != (delta ? alloc_bytes[pass] - free_bytes[pass] : alloc_bytes[pass]);
+		};
+		auto rekey = [&](size_t pass) {
+			if (states[pass] == State::Ready)
+				push(pass);
+		};
+
+		for (auto pass : rst.sorted_passes) {
+			if (remain_pred_cnts[pass] == 0) {
+				states[pass] = State::Ready;
+				push(pass);
+			}
+		}
+
+		std::vector<Entry> unfit; // popped from delta_heap while looking for a fitting pass
+		std::vector<size_t> sorted_passes;
+		sorted_passes.reserve(rst.sorted_passes.size());
+		while (true) {
+			while (!alloc_heap.empty() && is_stale(alloc_heap.top(), false))
+				alloc_heap.pop();
+			if (alloc_heap.empty())
+				break;
+
+			size_t pass;
+			if (live_bytes + std::get<0>(alloc_heap.top()) > budget) {
+				// nothing fits, the one allocating least
+				pass = std::get<2>(alloc_heap.top());
+			}
+			else {
+				while (true) {
+					Entry entry = delta_heap.top();
+					delta_heap.pop();
+					if (is_stale(entry, true))
+						continue;
+					size_t candidate = std::get<2>(entry);
+					if (live_bytes + alloc_bytes[candidate] <= budget) {
+						pass = candidate;
+						break;
+					}
+					unfit.push_back(entry);
+				}
+				for (const auto& entry : unfit)
+					delta_heap.push(entry);
+				unfit.clear();
+			}
+
+			states[pass] = State::Done;
+			sorted_passes.push_back(pass);
+
+			for (auto chain : chains.pass2chains[pass]) {
+				if (!live[chain]) {
+					live[chain] = true;
+					live_bytes += chains.sizes[chain];
+					for (auto user : chain2passes[chain]) {
+						if (states[user] != State::Done) {
+							alloc_bytes[user] -= chains.sizes[chain];
+							rekey(user);
+						}
+					}
+				}
+			}
+			for (auto chain : chains.pass2chains[pass]) {
+				size_t remain_user_num = --remain_user_nums[chain];
+				if (remain_user_num == 0) {
+					live[chain] = false;
+					live_bytes -= chains.sizes[chain];
+				}
+				else if (remain_user_num == 1) {
+					for (auto user : chain2passes[chain]) {
+						if (states[user] != State::Done) {
+							free_bytes[user] += chains.sizes[chain];
+							rekey(user);
+							break;
+						}
+					}
+				}
+			}
+
+			for (auto next : rst.passgraph.adjList.at(pass)) {
+				if (--remain_pred_cnts[next] == 0) {
+					states[next] = State::Ready;
+					push(next);
+				}
+			}
+		}
+
+		return sorted_passes;
+	}
+
+	// serialize the passes in a memory-aware order when the sized resources may exceed the budget all together.
+	// an allocating pass waits for the previous allocating and freeing passes in the order,
+	// so the parallel execution never has more live bytes than the sequential one
+	static void ApplyMemoryBudget(const FrameGraph& fg, Compiler::Result& rst, size_t budget) {
+		size_t passNum = fg.GetPassNodes().size();
+		rst.pass2order = std::vector<size_t>(passNum, static_cast<size_t>(-1));
+		for (size_t i = 0; i < rst.sorted_passes.size(); i++)
+			rst.pass2order[rst.sorted_passes[i]] = i;
+
+		auto chains = CollectMemoryChains(fg, rst);
+		rst.memory.level_num_before = CountLevels(rst.passgraph, rst.sorted_passes, rst.pass2order);
+		rst.memory.level_num = rst.memory.level_num_before;
+
+		if (budget == 0 || chains.total_bytes <= budget) {
+			rst.memory.peak_bytes = ComputeMemoryPeak(chains, rst.sorted_passes).bytes;
+			return;
+		}
+
+		auto sorted_passes = MemoryAwareSort(rst, chains, budget);
+		auto peak = ComputeMemoryPeak(chains, sorted_passes);
+		if (peak.bytes > budget) {
+			std::string msg = "memory budget " + std::to_string(budget) + " bytes exceeded: peak "
+				+ std::to_string(peak.bytes) + " bytes at pass (" + fg.GetPassNodes()[peak.pass].Label()
+				+ "), live resources:";
+			for (auto chain : peak.chains) {
+				msg += " " + fg.GetResourceNodes()[chains.roots[chain]].Label()
+					+ " (" + std::to_string(chains.sizes[chain]) + " bytes)";
+			}
+			throw std::logic_error(msg);
+		}
+
+		std::vector<size_t> remain_user_nums = chains.user_nums;
+		std::vector<bool> live = chains.preallocated;
+		size_t last_alloc = static_cast<size_t>(-1);
+		std::vector<size_t> frees; // freeing passes since last_alloc
+		auto add_edge = [&](size_t from, size_t to) {
+			if (rst.passgraph.adjList[from].insert(to).second)
+				rst.memory.serialized_edge_num++;
+		};
+		for (auto pass : sorted_passes) {
+			bool allocating = false;
+			bool freeing = false;
+			for (auto chain : chains.pass2chains[pass]) {
+				if (!live[chain]) {
+					live[chain] = true;
+					allocating = true;
+				}
+			}
+			for (auto chain : chains.pass2chains[pass]) {
+				if (--remain_user_nums[chain] == 0)
+					freeing = true;
+			}
+
+			if (allocating) {
+				if (last_alloc != static_cast<size_t>(-1))
+					add_edge(last_alloc, pass);
+				for (auto free_pass : frees)
+					add_edge(free_pass, pass);
+				frees.clear();
+				last_alloc = pass;
+			}
+			else if (freeing)
+				frees.push_back(pass);
+		}
+
+		rst.sorted_passes = std::move(sorted_passes);
+		for (size_t i = 0; i < rst.sorted_passes.size(); i++)
+			rst.pass2order[rst.sorted_passes[i]] = i;
+		rst.memory.peak_bytes = peak.bytes;
+		rst.memory.level_num = CountLevels(rst.passgraph, rst.sorted_passes, rst.pass2order);
+	}
+
+	// longest cost path from each pass to the sinks
+	static std::vector<double> ComputePriorities(const Compiler::Result::PassGraph& passgraph,
+		std::span<const size_t> sorted_passes, std::span<const double> costs)
+	{
+		std::vector<double> priorities(costs.size(), 0);
+		for (auto iter = sorted_passes.rbegin(); iter != sorted_passes.rend(); ++iter) {
+			double tail = 0;
+			for (auto next : passgraph.adjList.at(*iter))
+				tail = std::max(tail, priorities[next]);
+			priorities[*iter] = costs[*iter] + tail;
+		}
+		return priorities;
+	}
+
+	// list scheduling over the pass graph, the ready pass of the highest priority goes first.
+	// ties keep the order of the pass graph's topological sort
+	static std::vector<size_t> PrioritySort(const Compiler::Result& rst, std::span<const double> priorities) {
+		std::vector<size_t> pass2order(priorities.size(), 0);
+		std::vector<size_t> remain_pred_cnts(priorities.size(), 0);
+		for (size_t i = 0; i < rst.sorted_passes.size(); i++)
+			pass2order[rst.sorted_passes[i]] = i;
+		for (const auto& [pass, adj] : rst.passgraph.adjList) {
+			for (auto next : adj)
+				remain_pred_cnts[next]++;
+		}
+
+		auto cmp = [&](size_t lhs, size_t rhs) {
+			return priorities[lhs] < priorities[rhs]
+				|| (priorities[lhs] == priorities[rhs] && pass2order[lhs] > pass2order[rhs]);
+		};
+		std::vector<size_t> ready; // heap
+		for (auto pass : rst.sorted_passes) {
+			if (remain_pred_cnts[pass] == 0)
+				ready.push_back(pass);
+		}
+		std::make_heap(ready.begin(), ready.end(), cmp);
+
+		std::vector<size_t> sorted_passes;
+		sorted_passes.reserve(rst.sorted_passes.size());
+		while (!ready.empty()) {
+			std::pop_heap(ready.begin(), ready.end(), cmp);
+			size_t pass = ready.back();
+			ready.pop_back();
+			sorted_passes.push_back(pass);
+			for (auto next : rst.passgraph.adjList.at(pass)) {
+				if (--remain_pred_cnts[next] == 0) {
+					ready.push_back(next);
+					std::push_heap(ready.begin(), ready.end(), cmp);
+				}
+			}
+		}
+		return sorted_passes;
+	}
+
+	// the passes in sorted_passes (a priority order) go to the worker where they start the earliest
+	static Compiler::Result::ListSchedule ListSchedule(const Compiler::Result& rst, std::span<const double> costs, size_t worker_num) {
+		Compiler::Result::ListSchedule schedule;
+		schedule.worker2passes.resize(worker_num);
+		schedule.pass2worker.assign(costs.size(), static_cast<size_t>(-1));
+
+		std::vector<double> worker_frees(worker_num, 0);
+		std::vector<double> ready_times(costs.size(), 0);
+		for (auto pass : rst.sorted_passes) {
+			size_t worker = 0;
+			double start = std::max(worker_frees[0], ready_times[pass]);
+			for (size_t i = 1; i < worker_num; i++) {
+				double t = std::max(worker_frees[i], ready_times[pass]);
+				if (t < start) {
+					start = t;
+					worker = i;
+				}
+			}
+
+			double finish = start + costs[pass];
+			worker_frees[worker] = finish;
+			schedule.worker2passes[worker].push_back(pass);
+			schedule.pass2worker[pass] = worker;
+			schedule.makespan = std::max(schedule.makespan, finish);
+			for (auto next : rst.passgraph.adjList.at(pass))
+				ready_times[next] = std::max(ready_times[next], finish);
+		}
+		return schedule;
+	}
+
+	static Compiler::Result Build(const FrameGraph& fg, const Analysis& analysis, uint64_t mask,
+		const Compiler::Options& options, Compiler::CompileStats* stats)
+	{
+		PhaseTimer timer(stats);
+		Compiler::Result rst;
+		auto passes = fg.GetPassNodes();
+
+		std::vector<bool> enabled(passes.size());
+		for (size_t i = 0; i < passes.size(); i++)
+			enabled[i] = passes[i].IsEnabled(mask);
+
+		// filter the shared accessors by the enabled passes
+		rst.rsrcinfos.resize(analysis.rsrcaccessors.size());
+		std::vector<bool> culled(analysis.rsrcaccessors.size(), false);
+		for (size_t rsrcNodeIdx = 0; rsrcNodeIdx < analysis.rsrcaccessors.size(); rsrcNodeIdx++) {
+			const auto& accessors = analysis.rsrcaccessors[rsrcNodeIdx];
+			auto& info = rst.rsrcinfos[rsrcNodeIdx];
+			for (auto writer : accessors.writers) {
+				if (!enabled[writer])
+					continue;
+				if (info.writer != static_cast<size_t>(-1))
+					throw std::logic_error("multi writers");
+				info.writer = writer;
+			}
+			for (auto reader : accessors.readers) {
+				if (enabled[reader])
+					info.readers.push_back(reader);
+			}
+			for (auto copy_in : accessors.copy_ins) {
+				if (!enabled[copy_in])
+					continue;
+				if (info.copy_in != static_cast<size_t>(-1))
+					throw std::logic_error("multi copy_ins");
+				info.copy_in = copy_in;
+			}
+			culled[rsrcNodeIdx] = !IsAccessed(info)
+				&& (!accessors.writers.empty() || !accessors.readers.empty() || !accessors.copy_ins.empty());
+		}
+		timer.End(Compiler::CompileStats::Analyze);
+
+		// set move map, moves touching culled resources are dropped
+		for (const auto& [src, dst] : analysis.moves_src2dst) {
+			if (!culled[src] && !culled[dst])
+				rst.moves_src2dst.emplace(src, dst);
+		}
+
+		// set copy map
+		for (size_t i = 0; i < passes.size(); i++) {
+			const auto& pass = passes[i];
+			if (pass.GetType() != PassNode::Type::Copy || !enabled[i])
 				continue;
 
-			for (size_t idx = 0; idx < pass.Inputs().size(); idx++)
-			{
-				auto src = pass.Inputs()[idx];
-				auto dst = pass.Outputs()[idx];
+			auto inputs = fg.GetPassNodeInputs(pass);
+			auto outputs = fg.GetPassNodeOutputs(pass);
+			for (size_t idx = 0; idx < inputs.size(); idx++) {
+				auto src = inputs[idx];
+				auto dst = outputs[idx];
 				if (rst.copys_src2dst.contains(src))
 					throw std::logic_error("copy out more than once");
-				if (copydsts.contains(dst))
-					throw std::logic_error("copy in more than once");
 				rst.copys_src2dst.emplace(src, dst);
-				copydsts.insert(dst);
 			}
 		}
-	}
 
-	// pruning continuous move without reading and writing
-	std::set<size_t> deleteMoves;
-	auto iter = rst.moves_src2dst.begin();
-	while (iter != rst.moves_src2dst.end()) {
-		auto& [src, dst] = *iter;
-		if (deleteMoves.contains(src)) {
-			++iter;
-			continue;
+		timer.End(Compiler::CompileStats::MoveCopyMaps);
+
+		// pruning continuous move without reading and writing
+		std::set<size_t> deleteMoves;
+		auto iter = rst.moves_src2dst.begin();
+		while (iter != rst.moves_src2dst.end()) {
+			auto& [src, dst] = *iter;
+			if (deleteMoves.contains(src)) {
+				++iter;
+				continue;
+			}
+
+			const auto& info = rst.rsrcinfos[dst];
+			auto next = rst.moves_src2dst.find(dst);
+			if (info.writer == static_cast<size_t>(-1)
+				&& info.readers.empty()
+				&& next != rst.moves_src2dst.end())
+			{
+				// src -> dst -> next : src -> next, the move out of dst is deleted
+				deleteMoves.insert(dst);
+				dst = next->second;
+			}
+			else
+				++iter;
 		}
+		for (auto idx : deleteMoves)
+			rst.moves_src2dst.erase(idx);
+		timer.End(Compiler::CompileStats::MovePruning);
 
-		const auto& info = rst.rsrcinfos[dst];
-		auto next = rst.moves_src2dst.find(dst);
-		if (info.writer == static_cast<size_t>(-1)
-			&& info.readers.empty()
-			&& next != rst.moves_src2dst.end())
-		{
-			dst = next->second;
-			deleteMoves.insert(dst);
+		// init rst.passgraph.adjList
+		rst.passgraph.adjList.reserve(passes.size());
+		for (size_t i = 0; i < passes.size(); i++) {
+			if (enabled[i])
+				rst.passgraph.adjList.try_emplace(i);
 		}
-		else
-			++iter;
-	}
-	for (auto idx : deleteMoves)
-		rst.moves_src2dst.erase(idx);
 
-	// init rst.passgraph.adjList
-	rst.passgraph.adjList.reserve(passes.size());
-	for (size_t i = 0; i < passes.size(); i++)
-		rst.passgraph.adjList.try_emplace(i);
+		// set resource inner orders
+		for (const auto& info : rst.rsrcinfos) {
+			// 1. writer -> readers
+			if (info.writer != static_cast<size_t>(-1)) {
+				auto& adj = rst.passgraph.adjList[info.writer];
+				for (const auto& reader : info.readers)
+					adj.insert(reader);
+			}
+
+			// 2. readers -> copy_in
+			if (info.copy_in != static_cast<size_t>(-1)) {
+				for (const auto& reader : info.readers) {
+					auto& adj = rst.passgraph.adjList[reader];
+					adj.insert(info.copy_in);
+				}
+			}
 
-	// set resource inner orders
-	for (const auto& info : rst.rsrcinfos) {
-		// 1. writer -> readers
-		if (info.writer != static_cast<size_t>(-1)) {
-			auto& adj = rst.passgraph.adjList[info.writer];
-			for (const auto& reader : info.readers)
-				adj.insert(reader);
+			// 3. writer -> copy_in
+			if (info.writer != static_cast<size_t>(-1)
+				&& info.readers.empty()
+				&& info.copy_in != static_cast<size_t>(-1))
+			{
+				rst.passgraph.adjList[info.writer].insert(info.copy_in);
+			}
 		}
 
-		// 2. readers -> copy_in
-		if (info.copy_in != static_cast<size_t>(-1)) {
-			for (const auto& reader : info.readers) {
-				auto& adj = rst.passgraph.adjList[reader];
-				adj.insert(info.copy_in);
+		// set resouce move order
+		for (const auto& [src, dst] : rst.moves_src2dst) {
+			// [src]
+			//   .
+			//   .
+			//   v
+			// [dst]
+
+			const auto& info_dst = rst.rsrcinfos[dst];
+			const auto& info_src = rst.rsrcinfos[src];
+
+			std::span<const size_t> first_accessers_dst;
+			std::span<const size_t> final_accessers_src;
+
+			if (info_dst.writer != static_cast<size_t>(-1))
+				first_accessers_dst = { &info_dst.writer, 1 };
+			else if (!info_dst.readers.empty())
+				first_accessers_dst = info_dst.readers;
+			else if (info_dst.copy_in != static_cast<size_t>(-1))
+				first_accessers_dst = { &info_dst.copy_in, 1 };
+
+			if (info_src.copy_in != static_cast<size_t>(-1))
+				final_accessers_src = { &info_src.copy_in, 1 };
+			else if (!info_src.readers.empty())
+				final_accessers_src = info_src.readers;
+			else if (info_src.writer != static_cast<size_t>(-1))
+				final_accessers_src = { &info_src.writer, 1 };
+
+			for (const auto& final_accesser : final_accessers_src) {
+				rst.passgraph.adjList[final_accesser].insert(
+					first_accessers_dst.begin(),
+					first_accessers_dst.end()
+				);
 			}
 		}
-		
-		// 3. writer -> copy_in
-		if (info.writer != static_cast<size_t>(-1)
-			&& info.readers.empty()
-			&& info.copy_in != static_cast<size_t>(-1))
-		{
-			rst.passgraph.adjList[info.writer].insert(info.copy_in);
+
+		timer.End(Compiler::CompileStats::Edges);
+
+		{ // toposort
+			auto option_sorted_passes = rst.passgraph.TopoSort();
+			if (!option_sorted_passes)
+				throw std::logic_error("not a DAG");
+			rst.sorted_passes = std::move(*option_sorted_passes);
+		}
+
+		// moves_src2dst -> moves_dst2src
+		for (const auto& [src, dst] : rst.moves_src2dst) {
+			auto [iter, success] = rst.moves_dst2src.emplace(dst, src);
+			assert(success);
 		}
-	}
 
-	// set resouce move order
-	for (const auto& [src, dst] : rst.moves_src2dst) {
-		// [src]
-		//   .
-		//   .
-		//   v
-		// [dst]
+		// copys_src2dst -> copys_dst2src
+		for (const auto& [src, dst] : rst.copys_src2dst) {
+			auto [iter, success] = rst.copys_dst2src.emplace(dst, src);
+			assert(success);
+		}
 
-		const auto& info_dst = rst.rsrcinfos[dst];
-		const auto& info_src = rst.rsrcinfos[src];
+		timer.End(Compiler::CompileStats::TopoSort);
 
-		std::span<const size_t> first_accessers_dst;
-		std::span<const size_t> final_accessers_src;
+		// the memory-aware order breaks the ties by the priority order
+		if (!options.pass_costs.empty()) {
+			if (options.pass_costs.size() != passes.size())
+				throw std::logic_error("pass costs (" + std::to_string(options.pass_costs.size())
+					+ ") don't match the pass nodes (" + std::to_string(passes.size()) + ")");
+			rst.pass2priority = ComputePriorities(rst.passgraph, rst.sorted_passes, options.pass_costs);
+			rst.sorted_passes = PrioritySort(rst, rst.pass2priority);
+		}
+		timer.End(Compiler::CompileStats::Schedule);
 
-		if (info_dst.writer != static_cast<size_t>(-1))
-			first_accessers_dst = { &info_dst.writer, 1 };
-		else if (!info_dst.readers.empty())
-			first_accessers_dst = info_dst.readers;
-		else if (info_dst.copy_in != static_cast<size_t>(-1))
-			first_accessers_dst = { &info_dst.copy_in, 1 };
+		ApplyMemoryBudget(fg, rst, options.memory_budget);
+		timer.End(Compiler::CompileStats::MemoryBudget);
 
-		if (info_src.copy_in != static_cast<size_t>(-1))
-			final_accessers_src = { &info_src.copy_in, 1 };
-		else if (!info_src.readers.empty())
-			final_accessers_src = info_src.readers;
-		else if (info_src.writer != static_cast<size_t>(-1))
-			final_accessers_src = { &info_src.writer, 1 };
+		if (!options.pass_costs.empty()) {
+			// the serialization edges lengthen the paths
+			if (rst.memory.serialized_edge_num > 0)
+				rst.pass2priority = ComputePriorities(rst.passgraph, rst.sorted_passes, options.pass_costs);
+			if (options.worker_num > 0)
+				rst.list_schedule = ListSchedule(rst, options.pass_costs, options.worker_num);
+		}
+		timer.End(Compiler::CompileStats::Schedule);
 
-		for (const auto& final_accesser : final_accessers_src) {
-			rst.passgraph.adjList[final_accesser].insert(
-				first_accessers_dst.begin(),
-				first_accessers_dst.end()
-			);
+		std::vector<size_t> rsrcs;
+		rsrcs.reserve(culled.size());
+		for (size_t rsrcNodeIdx = 0; rsrcNodeIdx < culled.size(); rsrcNodeIdx++) {
+			if (!culled[rsrcNodeIdx])
+				rsrcs.push_back(rsrcNodeIdx);
 		}
+		SetLifetimes(rst, passes.size(), rsrcs);
+		timer.End(Compiler::CompileStats::Lifetimes);
+
+		return rst;
 	}
 
-	{ // toposort
-		auto option_sorted_passes = rst.passgraph.TopoSort();
-		if (!option_sorted_passes)
-			throw std::logic_error("not a DAG");
-		rst.sorted_passes = std::move(*option_sorted_passes);
+	// per node of the node-based containers : the value and two pointers
+	template<typename Value>
+	constexpr size_t node_bytes = sizeof(Value) + 2 * sizeof(void*);
+
+	template<typename T>
+	static size_t VectorBytes(const std::vector<T>& vec) {
+		return vec.capacity() * sizeof(T);
 	}
 
-	// moves_src2dst -> moves_dst2src
-	for (const auto& [src, dst] : rst.moves_src2dst) {
-		auto [iter, success] = rst.moves_dst2src.emplace(dst, src);
-		assert(success);
+	template<typename Map>
+	static size_t UnorderedMapBytes(const Map& map) {
+		return (map.bucket_count() > 1 ? map.bucket_count() * sizeof(void*) : 0)
+			+ map.size() * node_bytes<typename Map::value_type>;
 	}
 
-	// copys_src2dst -> copys_dst2src
-	for (const auto& [src, dst] : rst.copys_src2dst) {
-		auto [iter, success] = rst.copys_dst2src.emplace(dst, src);
-		assert(success);
+	static void CountResult(Compiler::CompileStats& stats, const Compiler::Result& rst) {
+		stats.compile_num++;
+		stats.pass_num += rst.sorted_passes.size();
+		stats.resource_num += rst.rsrcinfos.size();
+		stats.move_num += rst.moves_src2dst.size();
+		stats.copy_num += rst.copys_src2dst.size();
+
+		size_t bytes = VectorBytes(rst.rsrcinfos);
+		for (const auto& info : rst.rsrcinfos)
+			bytes += VectorBytes(info.readers);
+		bytes += UnorderedMapBytes(rst.passgraph.adjList);
+		for (const auto& [pass, adj] : rst.passgraph.adjList) {
+			stats.edge_num += adj.size();
+			bytes += adj.size() * (node_bytes<size_t> + sizeof(void*)); // rb-tree nodes
+		}
+		bytes += VectorBytes(rst.sorted_passes);
+		bytes += UnorderedMapBytes(rst.pass2info);
+		for (const auto& [pass, info] : rst.pass2info)
+			bytes += VectorBytes(info.construct_resources) + VectorBytes(info.destruct_resources) + VectorBytes(info.move_resources);
+		bytes += VectorBytes(rst.pass2order);
+		bytes += VectorBytes(rst.pass2priority);
+		bytes += VectorBytes(rst.list_schedule.worker2passes);
+		for (const auto& passes : rst.list_schedule.worker2passes)
+			bytes += VectorBytes(passes);
+		bytes += VectorBytes(rst.list_schedule.pass2worker);
+		bytes += UnorderedMapBytes(rst.moves_src2dst);
+		bytes += UnorderedMapBytes(rst.moves_dst2src);
+		bytes += UnorderedMapBytes(rst.copys_src2dst);
+		bytes += UnorderedMapBytes(rst.copys_dst2src);
+		stats.result_bytes += bytes;
 	}
+}
 
-	// set resource's first last and passinfo
+void Compiler::CompileStats::CountAllocation(size_t size) noexcept {
+	details::thread_allocation_num++;
+	details::thread_allocated_bytes += size;
+}
+
+Compiler::Result Compiler::Compile(const FrameGraph& fg) {
+	return Compile(fg, Options{});
+}
+
+Compiler::Result Compiler::Compile(const FrameGraph& fg, const Options& options, CompileStats* stats) {
+	details::PhaseTimer timer(stats);
+	auto analysis = details::Analyze(fg);
+	timer.End(CompileStats::Analyze);
+
+	auto rst = details::Build(fg, analysis, static_cast<uint64_t>(-1), options, stats);
+	if (stats)
+		details::CountResult(*stats, rst);
+	return rst;
+}
 
-	rst.pass2order = vector<size_t>(rst.sorted_passes.size());
-	for (size_t i = 0; i < rst.sorted_passes.size(); i++)
-		rst.pass2order[rst.sorted_passes[i]] = i;
+Compiler::Result Compiler::Prune(
+	const FrameGraph& fg,
+	const Result& crst,
+	std::span<const size_t> requested_resources)
+{
+	return Prune(fg, crst, requested_resources, Options{});
+}
 
-	for (size_t i = 0; i < passes.size(); ++i)
-		rst.pass2info.emplace(i, Result::PassInfo());
+Compiler::Result Compiler::Prune(
+	const FrameGraph& fg,
+	const Result& crst,
+	std::span<const size_t> requested_resources,
+	const Options& options)
+{
+	Result rst;
+	Prune(fg, crst, requested_resources, options, rst);
+	return rst;
+}
 
-	for (size_t rsrcNodeIdx = 0; rsrcNodeIdx < rst.rsrcinfos.size(); rsrcNodeIdx++) {
-		auto& info = rst.rsrcinfos[rsrcNodeIdx];
+namespace Ubpa::UFG::details {
+	// the node sets of Prune, kept between the calls of a thread. a call sets the entries of its cone only
+	// and clears them before returning, so it doesn't pay for the nodes out of the cone
+	struct PruneSets {
+		std::vector<bool> in_cone; // passNodeIdx
+		std::vector<bool> touched; // rsrcNodeIdx
+		std::vector<bool> visited; // rsrcNodeIdx, pushed in the stack of the walk
 
-		if (info.writer != static_cast<size_t>(-1))
-			info.first = rst.pass2order[info.writer];
-		else if (!info.readers.empty()) {
-			size_t first = static_cast<size_t>(-1); // max size_t
-			for (const auto& reader : info.readers)
-				first = std::min(first, rst.pass2order[reader]);
-			info.first = first;
+		static PruneSets& Get(size_t passNum, size_t rsrcNum) {
+			thread_local PruneSets sets;
+			if (sets.in_cone.size() < passNum)
+				sets.in_cone.resize(passNum, false);
+			if (sets.touched.size() < rsrcNum) {
+				sets.touched.resize(rsrcNum, false);
+				sets.visited.resize(rsrcNum, false);
+			}
+			return sets;
 		}
-		else if (info.copy_in != static_cast<size_t>(-1))
-			info.first = rst.pass2order[info.copy_in];
-		//else [[do nothing]]; // info.first = static_cast<size_t>(-1)
+	};
 
-		info.last = info.first;
-		if (info.copy_in != static_cast<size_t>(-1))
-			info.last = rst.pass2order[info.copy_in];
+	// resets rst, a result of Prune (or empty), keeping its per node arrays when their sizes match.
+	// only the entries of its cone are cleared : every resource it touches is destructed or moved out by a pass info
+	static void ResetPruned(Compiler::Result& rst, size_t passNum, size_t rsrcNum) {
+		if (rst.pass2order.size() == passNum && rst.rsrcinfos.size() == rsrcNum) {
+			auto clear = [&](size_t rsrc) {
+				auto& info = rst.rsrcinfos[rsrc];
+				info.first = info.last = info.writer = info.copy_in = static_cast<size_t>(-1);
+				info.readers.clear();
+			};
+			for (auto pass : rst.sorted_passes)
+				rst.pass2order[pass] = static_cast<size_t>(-1);
+			for (const auto& [pass, info] : rst.pass2info) {
+				for (auto rsrc : info.destruct_resources)
+					clear(rsrc);
+				for (auto rsrc : info.move_resources)
+					clear(rsrc);
+			}
+		}
 		else {
-			for (const auto& reader : info.readers) {
-				if (info.last == static_cast<size_t>(-1))
-					info.last = rst.pass2order[reader];
-				else
-					info.last = std::max(info.last, rst.pass2order[reader]);
+			rst.pass2order.assign(passNum, static_cast<size_t>(-1));
+			rst.rsrcinfos.assign(rsrcNum, {});
+		}
+
+		rst.passgraph.adjList.clear();
+		rst.sorted_passes.clear();
+		rst.pass2info.clear();
+		rst.moves_src2dst.clear();
+		rst.moves_dst2src.clear();
+		rst.copys_src2dst.clear();
+		rst.copys_dst2src.clear();
+		rst.memory = {};
+		rst.pass2priority.clear();
+		rst.list_schedule = {};
+	}
+}
+
+void Compiler::Prune(
+	const FrameGraph& fg,
+	const Result& crst,
+	std::span<const size_t> requested_resources,
+	const Options& options,
+	Result& rst)
+{
+	auto passes = fg.GetPassNodes();
+	if (!options.pass_costs.empty() && options.pass_costs.size() != passes.size())
+		throw std::logic_error("pass costs (" + std::to_string(options.pass_costs.size())
+			+ ") don't match the pass nodes (" + std::to_string(passes.size()) + ")");
+
+	details::ResetPruned(rst, passes.size(), crst.rsrcinfos.size());
+
+	auto& sets = details::PruneSets::Get(passes.size(), crst.rsrcinfos.size());
+	auto& in_cone = sets.in_cone;
+	auto& touched = sets.touched;
+	auto& visited = sets.visited;
+	std::vector<size_t> cone_passes;
+	std::vector<size_t> touched_rsrcs;
+
+	// walk the backward cone : resource -> its writer and copy-in (and move source),
+	// pass -> its inputs (and the move sources of its outputs, write means read + write)
+	std::vector<size_t> rsrc_stack;
+	auto visit_rsrc = [&](size_t rsrc) {
+		if (!touched[rsrc]) {
+			touched[rsrc] = true;
+			touched_rsrcs.push_back(rsrc);
+		}
+		if (!visited[rsrc]) {
+			visited[rsrc] = true;
+			rsrc_stack.push_back(rsrc);
+		}
+	};
+	auto visit_pass = [&](size_t pass) {
+		if (pass == static_cast<size_t>(-1) || in_cone[pass])
+			return;
+		in_cone[pass] = true;
+		cone_passes.push_back(pass);
+		const auto& passNode = passes[pass];
+		for (auto input : fg.GetPassNodeInputs(passNode))
+			visit_rsrc(input);
+		for (auto output : fg.GetPassNodeOutputs(passNode)) {
+			if (!touched[output]) {
+				touched[output] = true;
+				touched_rsrcs.push_back(output);
+			}
+			if (passNode.GetType() == PassNode::Type::General) {
+				if (auto target = crst.moves_dst2src.find(output); target != crst.moves_dst2src.end())
+					visit_rsrc(target->second);
 			}
 		}
+	};
+
+	for (auto rsrc : requested_resources)
+		visit_rsrc(rsrc);
+
+	while (!rsrc_stack.empty()) {
+		auto rsrc = rsrc_stack.back();
+		rsrc_stack.pop_back();
+		const auto& info = crst.rsrcinfos[rsrc];
+		visit_pass(info.writer);
+		visit_pass(info.copy_in);
+		if (auto target = crst.moves_dst2src.find(rsrc); target != crst.moves_dst2src.end())
+			visit_rsrc(target->second);
+	}
+
+	// keep the order of the full result
+	std::sort(cone_passes.begin(), cone_passes.end(), [&](size_t lhs, size_t rhs) {
+		return crst.pass2order[lhs] < crst.pass2order[rhs];
+	});
+	rst.sorted_passes = cone_passes;
+
+	rst.passgraph.adjList.reserve(cone_passes.size());
+	for (auto pass : cone_passes) {
+		auto& adj = rst.passgraph.adjList[pass];
+		for (auto child : crst.passgraph.adjList.at(pass)) {
+			if (in_cone[child])
+				adj.insert(child);
+		}
 	}
 
-	for (size_t rsrcNodeIdx = 0; rsrcNodeIdx < rst.rsrcinfos.size(); rsrcNodeIdx++) {
-		auto& info = rst.rsrcinfos[rsrcNodeIdx];
+	std::sort(touched_rsrcs.begin(), touched_rsrcs.end());
+	for (auto rsrc : touched_rsrcs) {
+		const auto& src_info = crst.rsrcinfos[rsrc];
+		auto& info = rst.rsrcinfos[rsrc];
+		if (src_info.writer != static_cast<size_t>(-1) && in_cone[src_info.writer])
+			info.writer = src_info.writer;
+		for (auto reader : src_info.readers) {
+			if (in_cone[reader])
+				info.readers.push_back(reader);
+		}
+		if (src_info.copy_in != static_cast<size_t>(-1) && in_cone[src_info.copy_in])
+			info.copy_in = src_info.copy_in;
+
+		if (auto target = crst.moves_src2dst.find(rsrc); target != crst.moves_src2dst.end() && touched[target->second]) {
+			rst.moves_src2dst.emplace(rsrc, target->second);
+			rst.moves_dst2src.emplace(target->second, rsrc);
+		}
+		if (info.copy_in != static_cast<size_t>(-1)) {
+			auto src = crst.copys_dst2src.at(rsrc);
+			rst.copys_src2dst.emplace(src, rsrc);
+			rst.copys_dst2src.emplace(rsrc, src);
+		}
+	}
+
+	for (auto pass : cone_passes)
+		in_cone[pass] = false;
+	for (auto rsrc : touched_rsrcs) {
+		touched[rsrc] = false;
+		visited[rsrc] = false;
+	}
+
+	details::SetLifetimes(rst, passes.size(), touched_rsrcs);
+
+	if (!options.pass_costs.empty()) {
+		rst.pass2priority = details::ComputePriorities(rst.passgraph, rst.sorted_passes, options.pass_costs);
+		if (options.worker_num > 0)
+			rst.list_schedule = details::ListSchedule(rst, options.pass_costs, options.worker_num);
+	}
+
+	auto chains = details::CollectMemoryChains(fg, rst, touched_rsrcs);
+	rst.memory.peak_bytes = details::ComputeMemoryPeak(chains, rst.sorted_passes).bytes;
+	rst.memory.level_num = details::CountLevels(rst.passgraph, rst.sorted_passes, rst.pass2order);
+	rst.memory.level_num_before = rst.memory.level_num;
+}
+
+Compiler::VariantTable Compiler::CompileVariants(
+	const FrameGraph& fg,
+	std::span<const uint64_t> masks,
+	size_t max_variants)
+{
+	return CompileVariants(fg, masks, Options{}, max_variants);
+}
+
+Compiler::VariantTable Compiler::CompileVariants(
+	const FrameGraph& fg,
+	std::span<const uint64_t> masks,
+	const Options& options,
+	size_t max_variants)
+{
+	VariantTable table;
+	auto analysis = details::Analyze(fg);
+	table.condition_mask = analysis.condition_mask;
 
-		if (info.first == static_cast<size_t>(-1)) {
-			auto target = rst.moves_dst2src.find(rsrcNodeIdx);
-			if (target != rst.moves_dst2src.end()) {
-				info.first = rst.rsrcinfos[target->second].last;
-				if (info.last == static_cast<size_t>(-1))
-					info.last = info.first;
-				assert(info.last >= info.first);
+	for (auto mask : masks) {
+		uint64_t reduced_mask = mask & table.condition_mask;
+		if (table.mask2result.contains(reduced_mask))
+			continue;
+		if (table.results.size() == max_variants)
+			throw std::logic_error("too many variants");
+		table.mask2result.emplace(reduced_mask, table.results.size());
+		table.results.push_back(details::Build(fg, analysis, reduced_mask, options, nullptr));
+	}
+
+	return table;
+}
+
+Compiler::Result::MemoryReport Compiler::Result::GetMemoryReport(const FrameGraph& fg) const {
+	MemoryReport report;
+	auto chains = details::CollectMemoryChains(fg, *this);
+	auto peak = details::ComputeMemoryPeak(chains, sorted_passes, &report.live_bytes);
+	report.peak_bytes = peak.bytes;
+	report.peak_pass = peak.pass;
+	report.naive_bytes = chains.total_bytes;
+
+	if (peak.pass == static_cast<size_t>(-1))
+		return report;
+
+	size_t position = pass2order[peak.pass];
+	for (auto chain : peak.chains) {
+		// follow the moves to the resource holding the allocation at the peak
+		size_t holder = chains.roots[chain];
+		for (auto target = moves_src2dst.find(holder); target != moves_src2dst.end(); target = moves_src2dst.find(holder)) {
+			const auto& info = rsrcinfos[holder];
+			if (info.last != static_cast<size_t>(-1) && info.last >= position)
+				break;
+			holder = target->second;
+		}
+		report.peak_resources.push_back(holder);
+	}
+
+	return report;
+}
+
+namespace Ubpa::UFG::details {
+	static std::string EscapeXml(std::string_view str) {
+		std::string rst;
+		for (char c : str) {
+			switch (c)
+			{
+			case '&': rst += "&amp;"; break;
+			case '<': rst += "&lt;"; break;
+			case '>': rst += "&gt;"; break;
+			case '"': rst += "&quot;"; break;
+			default: rst += c; break;
 			}
 		}
+		return rst;
+	}
+
+	static std::string FormatBytes(size_t bytes) {
+		constexpr const char* units[] = { "B", "KiB", "MiB", "GiB" };
+		size_t unit = 0;
+		double value = static_cast<double>(bytes);
+		while (value >= 1024. && unit + 1 < std::size(units)) {
+			value /= 1024.;
+			unit++;
+		}
+		std::string str = std::to_string(value);
+		return str.substr(0, str.find('.') + (unit == 0 ? 0 : 3)) + " " + units[unit];
 	}
+}
+
+std::string Compiler::Result::ToLifetimeSVG(const FrameGraph& fg) const {
+	constexpr size_t label_width = 240;
+	constexpr size_t header_height = 140;
+	constexpr size_t column_width = 28;
+	constexpr size_t row_height = 18;
+	constexpr size_t chart_height = 80;
 
-	for (size_t rsrcNodeIdx = 0; rsrcNodeIdx < rst.rsrcinfos.size(); rsrcNodeIdx++) {
-		const auto& info = rst.rsrcinfos[rsrcNodeIdx];
+	auto report = GetMemoryReport(fg);
+	std::vector<bool> at_peak(rsrcinfos.size(), false);
+	for (auto rsrc : report.peak_resources)
+		at_peak[rsrc] = true;
 
-		size_t firstPassIdx = info.first != static_cast<size_t>(-1) ? rst.sorted_passes[info.first]
-			: static_cast<size_t>(-1);
-		size_t lastPassIdx = info.last != static_cast<size_t>(-1) ? rst.sorted_passes[info.last]
-			: static_cast<size_t>(-1);
-		if (!rst.moves_dst2src.contains(rsrcNodeIdx))
-			rst.pass2info[firstPassIdx].construct_resources.push_back(rsrcNodeIdx);
-		if (rst.moves_src2dst.contains(rsrcNodeIdx))
-			rst.pass2info[lastPassIdx].move_resources.push_back(rsrcNodeIdx);
-		else
-			rst.pass2info[lastPassIdx].destruct_resources.push_back(rsrcNodeIdx);
+	// the resources alive during the passes, ordered by their lifetimes
+	std::vector<size_t> rows;
+	for (size_t rsrc = 0; rsrc < rsrcinfos.size(); rsrc++) {
+		if (rsrcinfos[rsrc].first != static_cast<size_t>(-1))
+			rows.push_back(rsrc);
 	}
+	std::stable_sort(rows.begin(), rows.end(), [&](size_t lhs, size_t rhs) {
+		return std::pair{ rsrcinfos[lhs].first, rsrcinfos[lhs].last } < std::pair{ rsrcinfos[rhs].first, rsrcinfos[rhs].last };
+	});
 
-	return rst;
+	size_t width = label_width + sorted_passes.size() * column_width + 20;
+	size_t rows_top = header_height;
+	size_t chart_top = rows_top + rows.size() * row_height + 20;
+	size_t height = chart_top + chart_height + 40;
+
+	std::string svg = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" + std::to_string(width)
+		+ "\" height=\"" + std::to_string(height) + "\" font-family=\"consolas, monospace\" font-size=\"11\">\n";
+	svg += "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+
+	auto column_x = [&](size_t position) { return label_width + position * column_width; };
+
+	// peak column
+	if (report.peak_pass != static_cast<size_t>(-1)) {
+		svg += "<rect x=\"" + std::to_string(column_x(pass2order[report.peak_pass])) + "\" y=\"0\" width=\""
+			+ std::to_string(column_width) + "\" height=\"" + std::to_string(height) + "\" fill=\"#F6DCDB\"/>\n";
+	}
+
+	// passes
+	for (size_t i = 0; i < sorted_passes.size(); i++) {
+		size_t x = column_x(i) + column_width / 2;
+		svg += "<text transform=\"translate(" + std::to_string(x) + "," + std::to_string(header_height - 6)
+			+ ") rotate(-60)\">" + details::EscapeXml(fg.GetPassNodes()[sorted_passes[i]].Label()) + "</text>\n";
+	}
+
+	// lifetimes
+	for (size_t row = 0; row < rows.size(); row++) {
+		size_t rsrc = rows[row];
+		const auto& node = fg.GetResourceNodes()[rsrc];
+		const auto& info = rsrcinfos[rsrc];
+		size_t y = rows_top + row * row_height;
+
+		std::string label = node.Label();
+		if (node.GetSize() != 0)
+			label += " (" + details::FormatBytes(node.GetSize()) + ")";
+		svg += "<text x=\"4\" y=\"" + std::to_string(y + row_height - 5) + "\">" + details::EscapeXml(label) + "</text>\n";
+
+		const char* color = node.IsPersistent() ? "#9E9E9E" : (node.GetSize() != 0 ? "#6597AD" : "#B7CDD8");
+		svg += "<rect x=\"" + std::to_string(column_x(info.first) + 2) + "\" y=\"" + std::to_string(y + 2)
+			+ "\" width=\"" + std::to_string((info.last - info.first + 1) * column_width - 4) + "\" height=\""
+			+ std::to_string(row_height - 4) + "\" rx=\"3\" fill=\"" + color + "\"";
+		if (at_peak[rsrc])
+			svg += " stroke=\"#B54E4C\" stroke-width=\"2\"";
+		svg += "/>\n";
+	}
+
+	// live bytes
+	for (size_t i = 0; i < report.live_bytes.size(); i++) {
+		size_t bar = report.peak_bytes == 0 ? 0 : report.live_bytes[i] * chart_height / report.peak_bytes;
+		svg += "<rect x=\"" + std::to_string(column_x(i) + 2) + "\" y=\"" + std::to_string(chart_top + chart_height - bar)
+			+ "\" width=\"" + std::to_string(column_width - 4) + "\" height=\"" + std::to_string(bar) + "\" fill=\""
+			+ (i == pass2order[report.peak_pass] ? "#B54E4C" : "#6597AD") + "\"/>\n";
+	}
+	svg += "<text x=\"4\" y=\"" + std::to_string(chart_top + 12) + "\">live bytes</text>\n";
+	svg += "<text x=\"4\" y=\"" + std::to_string(chart_top + chart_height + 24) + "\">peak "
+		+ details::FormatBytes(report.peak_bytes) + ", naive " + details::FormatBytes(report.naive_bytes)
+		+ ", ratio " + std::to_string(report.GetAliasingRatio()).substr(0, 4) + "</text>\n";
+
+	svg += "</svg>\n";
+	return svg;
 }
 
 UGraphviz::Graph Compiler::Result::PassGraph::ToGraphvizGraph(const FrameGraph& fg) const {
@@ -318,12 +1346,12 @@ UGraphviz::Graph Compiler::Result::PassGraph::ToGraphvizGraph(const FrameGraph&
 		.RegisterGraphNodeAttr("fontname", "consolas");
 
 	for (const auto& [src, dsts] : adjList)
-		graph.AddNode(registry.RegisterNode(std::string{ fg.GetPassNodes()[src].Name() }));
+		graph.AddNode(registry.RegisterNode(fg.GetPassNodes()[src].Label()));
 
 	for (const auto& [src, dsts] : adjList) {
-		auto idx_src = registry.GetNodeIndex(std::string{ fg.GetPassNodes()[src].Name() });
+		auto idx_src = registry.GetNodeIndex(fg.GetPassNodes()[src].Label());
 		for (auto dst : dsts) {
-			auto idx_dst = registry.GetNodeIndex(std::string{ fg.GetPassNodes()[dst].Name() });
+			auto idx_dst = registry.GetNodeIndex(fg.GetPassNodes()[dst].Label());
 			graph.AddEdge(registry.RegisterEdge(idx_src, idx_dst));
 		}
 	}
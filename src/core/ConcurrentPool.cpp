@@ -0,0 +1,223 @@
+#include <UFG/ConcurrentPool.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+ConcurrentPool::ConcurrentPool() : ConcurrentPool(TransientPool::Config{}) {}
+
+ConcurrentPool::ConcurrentPool(TransientPool::Config config, size_t shard_num) :
+	shard_num{ std::max<size_t>(shard_num, 1) },
+	bucket_sizes{ new std::atomic<size_t>[bucket_num] },
+	stacks{ new Stack[bucket_num * this->shard_num] },
+	shards{ new Shard[this->shard_num] },
+	pool{ config }
+{
+	for (size_t i = 0; i < bucket_num; i++)
+		bucket_sizes[i].store(0, std::memory_order_relaxed);
+}
+
+ConcurrentPool::~ConcurrentPool() {
+	Reclaim(static_cast<uint64_t>(-1));
+	Clear();
+	for (auto& chunk : chunks)
+		delete[] chunk.load(std::memory_order_relaxed);
+}
+
+size_t ConcurrentPool::GetShard() const noexcept {
+	static std::atomic<size_t> thread_num{ 0 };
+	thread_local size_t thread_id = thread_num.fetch_add(1, std::memory_order_relaxed);
+	return thread_id % shard_num;
+}
+
+size_t ConcurrentPool::FindBucket(size_t size, bool insert) noexcept {
+	// open addressing, a bucket is never removed
+	size_t begin = (size * 0x9E3779B97F4A7C15ull) >> 56;
+	for (size_t i = 0; i < bucket_num; i++) {
+		size_t bucket = (begin + i) % bucket_num;
+		size_t cur = bucket_sizes[bucket].load(std::memory_order_acquire);
+		if (cur == size)
+			return bucket;
+		if (cur != 0)
+			continue;
+		if (!insert)
+			return static_cast<size_t>(-1);
+		if (bucket_sizes[bucket].compare_exchange_strong(cur, size, std::memory_order_acq_rel) || cur == size)
+			return bucket;
+	}
+	return static_cast<size_t>(-1);
+}
+
+void ConcurrentPool::Push(Stack& stack, uint32_t index) noexcept {
+	auto& node = GetNode(index);
+	uint64_t head = stack.head.load(std::memory_order_relaxed);
+	uint64_t new_head;
+	do {
+		node.next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+		new_head = ((head >> 32) + 1) << 32 | index;
+	} while (!stack.head.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+uint32_t ConcurrentPool::Pop(Stack& stack) noexcept {
+	uint64_t head = stack.head.load(std::memory_order_acquire);
+	uint64_t new_head;
+	do {
+		uint32_t index = static_cast<uint32_t>(head);
+		if (index == npos)
+			return npos;
+		// the node may be popped and pushed again by another thread, the tag fails the exchange then
+		uint32_t next = GetNode(index).next.load(std::memory_order_relaxed);
+		new_head = ((head >> 32) + 1) << 32 | next;
+	} while (!stack.head.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire));
+	return static_cast<uint32_t>(head);
+}
+
+ConcurrentPool::Handle ConcurrentPool::Acquire(const Desc& desc) {
+	size_t shard = GetShard();
+	size_t size = pool.GetClassSize(desc.size);
+	size_t alignment = std::max(desc.alignment, alignof(std::max_align_t));
+
+	// hit : own stack first, then steal from the other shards
+	if (size_t bucket = FindBucket(size, false); bucket != static_cast<size_t>(-1)) {
+		for (size_t i = 0; i < shard_num; i++) {
+			auto& stack = stacks[bucket * shard_num + (shard + i) % shard_num];
+			uint32_t index = Pop(stack);
+			if (index == npos)
+				continue;
+
+			auto& node = GetNode(index);
+			if (reinterpret_cast<uintptr_t>(node.data) % alignment != 0) {
+				// the other shards may cache an aligned block
+				Push(stack, index);
+				continue;
+			}
+
+			node.desc = desc;
+			shards[shard].hit_num.fetch_add(1, std::memory_order_relaxed);
+			return { index };
+		}
+	}
+
+	// miss
+	std::lock_guard<std::mutex> lk(mutex);
+	uint32_t index = NewNode();
+	auto& node = GetNode(index);
+	node.handle = pool.Acquire(desc);
+	node.desc = desc;
+	node.data = pool.GetData(node.handle);
+	node.size = pool.GetBlockSize(node.handle);
+	shards[shard].miss_num.fetch_add(1, std::memory_order_relaxed);
+	return { index };
+}
+
+void ConcurrentPool::Release(Handle handle) {
+	assert(handle.IsValid());
+	auto& node = GetNode(handle.index);
+	node.frame = frame.load(std::memory_order_relaxed);
+
+	size_t bucket = FindBucket(node.size, true);
+	if (bucket == static_cast<size_t>(-1)) {
+		// too many sizes
+		std::lock_guard<std::mutex> lk(mutex);
+		Return(handle.index);
+		return;
+	}
+
+	Push(stacks[bucket * shard_num + GetShard()], handle.index);
+}
+
+void ConcurrentPool::Retire(Handle handle, uint64_t fence) {
+	assert(handle.IsValid());
+	GetNode(handle.index).fence = fence;
+	Push(retireds, handle.index);
+}
+
+void ConcurrentPool::Reclaim(uint64_t completedFence) {
+	// take the whole list at once
+	uint64_t head = retireds.head.load(std::memory_order_relaxed);
+	while (!retireds.head.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | npos,
+		std::memory_order_acquire, std::memory_order_relaxed));
+
+	for (uint32_t index = static_cast<uint32_t>(head); index != npos;) {
+		uint32_t next = GetNode(index).next.load(std::memory_order_relaxed);
+		if (GetNode(index).fence > completedFence)
+			Push(retireds, index);
+		else
+			Release({ index });
+		index = next;
+	}
+}
+
+ConcurrentPool::Stats ConcurrentPool::GetStats() const noexcept {
+	Stats stats;
+	for (size_t i = 0; i < shard_num; i++) {
+		stats.hit_num += shards[i].hit_num.load(std::memory_order_relaxed);
+		stats.miss_num += shards[i].miss_num.load(std::memory_order_relaxed);
+	}
+	for (size_t i = 0; i < bucket_num * shard_num; i++) {
+		for (uint32_t index = static_cast<uint32_t>(stacks[i].head.load(std::memory_order_acquire));
+			index != npos; index = GetNode(index).next.load(std::memory_order_relaxed))
+		{
+			++stats.cached_num;
+		}
+	}
+	return stats;
+}
+
+uint32_t ConcurrentPool::NewNode() {
+	if (!freeNodes.empty()) {
+		uint32_t index = freeNodes.back();
+		freeNodes.pop_back();
+		return index;
+	}
+
+	if (node_num % chunk_size == 0) {
+		if (node_num / chunk_size == max_chunk_num)
+			throw std::bad_alloc{};
+		chunks[node_num / chunk_size].store(new Node[chunk_size], std::memory_order_release);
+	}
+	return static_cast<uint32_t>(node_num++);
+}
+
+void ConcurrentPool::Return(uint32_t index) {
+	auto& node = GetNode(index);
+	pool.Release(node.handle);
+	node.handle = {};
+	node.data = nullptr;
+	node.size = 0;
+	freeNodes.push_back(index);
+}
+
+void ConcurrentPool::NextFrame() {
+	uint64_t cur_frame = frame.fetch_add(1, std::memory_order_relaxed) + 1;
+	size_t max_age = pool.GetConfig().max_age;
+
+	std::lock_guard<std::mutex> lk(mutex);
+	std::vector<uint32_t> keeps;
+	for (size_t i = 0; i < bucket_num * shard_num; i++) {
+		auto& stack = stacks[i];
+		for (uint32_t index = Pop(stack); index != npos; index = Pop(stack)) {
+			if (cur_frame - GetNode(index).frame > max_age)
+				Return(index);
+			else
+				keeps.push_back(index);
+		}
+		// keep the order, the most recently released on the top
+		for (auto iter = keeps.rbegin(); iter != keeps.rend(); ++iter)
+			Push(stack, *iter);
+		keeps.clear();
+	}
+	pool.NextFrame();
+}
+
+void ConcurrentPool::Clear() {
+	std::lock_guard<std::mutex> lk(mutex);
+	for (size_t i = 0; i < bucket_num * shard_num; i++) {
+		for (uint32_t index = Pop(stacks[i]); index != npos; index = Pop(stacks[i]))
+			Return(index);
+	}
+	pool.Clear();
+}
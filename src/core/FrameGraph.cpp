@@ -6,66 +6,123 @@ using namespace Ubpa;
 using namespace Ubpa::UFG;
 
 bool FrameGraph::IsRegisteredResourceNode(std::string_view name) const {
-	return name2rsrcNodeIdx.find(name) != name2rsrcNodeIdx.end();
+	return name2rsrcNodeIdx.Find(name) != NameIndex::npos;
 }
 
 size_t FrameGraph::GetResourceNodeIndex(std::string_view name) const {
 	assert(IsRegisteredResourceNode(name));
-	return name2rsrcNodeIdx.find(name)->second;
+	return name2rsrcNodeIdx.Find(name);
 }
 
 size_t FrameGraph::RegisterResourceNode(ResourceNode node) {
-	assert(!IsRegisteredResourceNode(node.Name()));
 	size_t idx = resourceNodes.size();
-	name2rsrcNodeIdx.emplace(node.Name(), idx);
+	[[maybe_unused]] bool success = name2rsrcNodeIdx.Insert(node.GetNameID(), idx);
+	assert(success);
 	resourceNodes.push_back(std::move(node));
 	return idx;
 }
 
-size_t FrameGraph::RegisterResourceNode(std::string node) {
-	return RegisterResourceNode(ResourceNode{ node });
+size_t FrameGraph::RegisterResourceNode(std::string_view name) {
+	return RegisterResourceNode(ResourceNode{ name });
+}
+
+size_t FrameGraph::RegisterHistoryResourceNode(std::string_view name, size_t versions) {
+	assert(versions >= 2);
+	ResourceNode node{ name };
+	node.SetHistoryVersions(versions);
+	return RegisterResourceNode(std::move(node));
+}
+
+size_t FrameGraph::RegisterPreviousResourceNode(size_t historyRsrcNodeIdx, size_t age) {
+	assert(historyRsrcNodeIdx < resourceNodes.size());
+	const auto& history = resourceNodes[historyRsrcNodeIdx];
+	assert(history.IsHistory() && age >= 1 && age < history.GetHistoryVersions());
+	// derived from the ID, the name may be stripped (UFG_STRIP_NAMES)
+	ResourceNode node{ NameTable::Instance().Intern(history.GetNameID(), "#Prev" + std::to_string(age)) };
+	node.SetPrevious(historyRsrcNodeIdx, age);
+	return RegisterResourceNode(std::move(node));
 }
 
 bool FrameGraph::IsRegisteredPassNode(std::string_view name) const {
-	return name2passNodeIdx.find(name) != name2passNodeIdx.end();
+	return name2passNodeIdx.Find(name) != NameIndex::npos;
 }
 
 size_t FrameGraph::GetPassNodeIndex(std::string_view name) const {
 	assert(IsRegisteredPassNode(name));
-	return name2passNodeIdx.find(name)->second;
+	return name2passNodeIdx.Find(name);
 }
 
-size_t FrameGraph::RegisterPassNode(PassNode node) {
-	assert(!IsRegisteredPassNode(node.Name()));
+size_t FrameGraph::RegisterPassNode(
+	PassNode::Type type,
+	std::string_view name,
+	std::span<const size_t> inputs,
+	std::span<const size_t> outputs
+) {
+	assert(passEdges.size() + inputs.size() + outputs.size() <= static_cast<uint32_t>(-1));
 	size_t idx = passNodes.size();
-	name2passNodeIdx.emplace(node.Name(), idx);
-	passNodes.push_back(std::move(node));
+	PassNode node{
+		type,
+		name,
+		static_cast<uint32_t>(passEdges.size()),
+		static_cast<uint32_t>(inputs.size()),
+		static_cast<uint32_t>(outputs.size())
+	};
+	assert(node.IsValid());
+	[[maybe_unused]] bool success = name2passNodeIdx.Insert(node.GetNameID(), idx);
+	assert(success);
+
+	for (size_t input : inputs) {
+		assert(input <= static_cast<uint32_t>(-1));
+		passEdges.push_back(static_cast<uint32_t>(input));
+	}
+	for (size_t output : outputs) {
+		assert(output <= static_cast<uint32_t>(-1));
+		passEdges.push_back(static_cast<uint32_t>(output));
+	}
+
+	passNodes.push_back(node);
 	return idx;
 }
 
 size_t FrameGraph::RegisterPassNode(
 	PassNode::Type type,
-	std::string name,
-	std::vector<size_t> inputs,
-	std::vector<size_t> outputs
-) {
-	return RegisterPassNode(PassNode{ type, std::move(name), std::move(inputs), std::move(outputs) });
+	std::string_view name,
+	std::initializer_list<size_t> inputs,
+	std::initializer_list<size_t> outputs)
+{
+	return RegisterPassNode(type, name, std::span<const size_t>{ inputs }, std::span<const size_t>{ outputs });
+}
+
+size_t FrameGraph::RegisterGeneralPassNode(
+	std::string_view name,
+	std::span<const size_t> inputs,
+	std::span<const size_t> outputs)
+{
+	return RegisterPassNode(PassNode::Type::General, name, inputs, outputs);
 }
 
 size_t FrameGraph::RegisterGeneralPassNode(
-	std::string name,
-	std::vector<size_t> inputs,
-	std::vector<size_t> outputs)
+	std::string_view name,
+	std::initializer_list<size_t> inputs,
+	std::initializer_list<size_t> outputs)
+{
+	return RegisterPassNode(PassNode::Type::General, name, inputs, outputs);
+}
+
+size_t FrameGraph::RegisterCopyPassNode(
+	std::string_view name,
+	std::span<const size_t> inputs,
+	std::span<const size_t> outputs)
 {
-	return RegisterPassNode(PassNode::Type::General, std::move(name), std::move(inputs), std::move(outputs));
+	return RegisterPassNode(PassNode::Type::Copy, name, inputs, outputs);
 }
 
 size_t FrameGraph::RegisterCopyPassNode(
-	std::string name,
-	std::vector<size_t> inputs,
-	std::vector<size_t> outputs)
+	std::string_view name,
+	std::initializer_list<size_t> inputs,
+	std::initializer_list<size_t> outputs)
 {
-	return RegisterPassNode(PassNode::Type::Copy, std::move(name), std::move(inputs), std::move(outputs));
+	return RegisterPassNode(PassNode::Type::Copy, name, inputs, outputs);
 }
 
 std::string FrameGraph::GenerateCopyPassNodeName() const
@@ -74,10 +131,32 @@ std::string FrameGraph::GenerateCopyPassNodeName() const
 }
 
 size_t FrameGraph::RegisterCopyPassNode(
-	std::vector<size_t> inputs,
-	std::vector<size_t> outputs)
+	std::span<const size_t> inputs,
+	std::span<const size_t> outputs)
 {
-	return RegisterCopyPassNode(GenerateCopyPassNodeName(), std::move(inputs), std::move(outputs));
+	return RegisterCopyPassNode(GenerateCopyPassNodeName(), inputs, outputs);
+}
+
+size_t FrameGraph::RegisterCopyPassNode(
+	std::initializer_list<size_t> inputs,
+	std::initializer_list<size_t> outputs)
+{
+	return RegisterCopyPassNode(GenerateCopyPassNodeName(), inputs, outputs);
+}
+
+void FrameGraph::SetPassNodeCondition(size_t passNodeIdx, size_t bit) {
+	assert(passNodeIdx < passNodes.size());
+	passNodes[passNodeIdx].SetCondition(bit);
+}
+
+void FrameGraph::SetPassNodePure(size_t passNodeIdx, bool pure) {
+	assert(passNodeIdx < passNodes.size());
+	passNodes[passNodeIdx].SetPure(pure);
+}
+
+void FrameGraph::SetResourceNodeSize(size_t rsrcNodeIdx, size_t size) {
+	assert(rsrcNodeIdx < resourceNodes.size());
+	resourceNodes[rsrcNodeIdx].SetSize(size);
 }
 
 //
@@ -129,12 +208,13 @@ size_t FrameGraph::RegisterMoveNode(size_t dst, size_t src) {
 }
 
 void FrameGraph::Clear() noexcept {
-	name2rsrcNodeIdx.clear();
-	name2passNodeIdx.clear();
+	name2rsrcNodeIdx.Clear();
+	name2passNodeIdx.Clear();
 	dstRsrcNodeIdx2moveNodeIdx.clear();
 	srcRsrcNodeIdx2moveNodeIdx.clear();
 	resourceNodes.clear();
 	passNodes.clear();
+	passEdges.clear();
 	moveNodes.clear();
 }
 
@@ -171,22 +251,22 @@ UGraphviz::Graph FrameGraph::ToGraphvizGraph() const {
 		.RegisterGraphEdgeAttr(UGraphviz::Attrs_dir, "back");
 
 	for (const auto& rsrcNode : resourceNodes) {
-		auto rsrcIndex = registry.RegisterNode(std::string{ rsrcNode.Name() });
+		auto rsrcIndex = registry.RegisterNode(rsrcNode.Label());
 		subgraph_rsrc.AddNode(rsrcIndex);
 	}
 
 	for (const auto& passNode : passNodes) {
-		size_t passIndex = registry.RegisterNode(std::string{ passNode.Name() });
+		size_t passIndex = registry.RegisterNode(passNode.Label());
 		subgraph_pass.AddNode(passIndex);
 
-		for (size_t rsrcNodeIndex : passNode.Inputs()) {
-			const auto& rsrcNodeName = resourceNodes[rsrcNodeIndex].Name();
+		for (size_t rsrcNodeIndex : GetPassNodeInputs(passNode)) {
+			auto rsrcNodeName = resourceNodes[rsrcNodeIndex].Label();
 			auto edgeIndex = registry.RegisterEdge(registry.GetNodeIndex(rsrcNodeName), passIndex);
 			subgraph_read.AddEdge(edgeIndex);
 		}
 
-		for (size_t rsrcNodeIndex : passNode.Outputs()) {
-			const auto& rsrcNodeName = resourceNodes[rsrcNodeIndex].Name();
+		for (size_t rsrcNodeIndex : GetPassNodeOutputs(passNode)) {
+			auto rsrcNodeName = resourceNodes[rsrcNodeIndex].Label();
 			//auto edgeIndex = registry.RegisterEdge(passIndex, registry.GetNodeIndex(rsrcNodeName));
 			//subgraph_write.AddEdge(edgeIndex);
 
@@ -208,8 +288,8 @@ UGraphviz::Graph FrameGraph::ToGraphvizGraph() const {
 	}
 
 	for (const auto& moveNode : moveNodes) {
-		auto srcNodeIdx = registry.GetNodeIndex(resourceNodes[moveNode.GetSourceNodeIndex()].Name());
-		auto dstNodeIdx = registry.GetNodeIndex(resourceNodes[moveNode.GetDestinationNodeIndex()].Name());
+		auto srcNodeIdx = registry.GetNodeIndex(resourceNodes[moveNode.GetSourceNodeIndex()].Label());
+		auto dstNodeIdx = registry.GetNodeIndex(resourceNodes[moveNode.GetDestinationNodeIndex()].Label());
 		auto src2dst = registry.RegisterEdge(srcNodeIdx, dstNodeIdx);
 		subgraph_move.AddEdge(src2dst);
 	}
@@ -263,25 +343,27 @@ UGraphviz::Graph FrameGraph::ToGraphvizGraph2() const {
 		.RegisterGraphEdgeAttr(UGraphviz::Attrs_dir, "back");
 
 	for (const auto& rsrcNode : resourceNodes) {
-		auto rsrcIndex = registry.RegisterNode(std::string{ rsrcNode.Name() });
+		auto rsrcIndex = registry.RegisterNode(rsrcNode.Label());
 		subgraph_rsrc.AddNode(rsrcIndex);
 	}
 
 	for (const auto& passNode : passNodes) {
-		size_t passIndex = registry.RegisterNode(std::string{ passNode.Name() });
+		size_t passIndex = registry.RegisterNode(passNode.Label());
+		auto inputs = GetPassNodeInputs(passNode);
+		auto outputs = GetPassNodeOutputs(passNode);
 		subgraph_pass.AddNode(passIndex);
 		std::string label;
 		//label += "{"; // begin pass
-		label += std::string{ passNode.Name() };
+		label += passNode.Label();
 		label += "|";
 		label += "{"; // begin inout
 
 		label += "{"; // begin in
-		if (!passNode.Inputs().empty()) {
-			for (size_t i = 0; i < passNode.Inputs().size(); ++i) {
+		if (!inputs.empty()) {
+			for (size_t i = 0; i < inputs.size(); ++i) {
 				label += "<in_" + std::to_string(i) + "> ";
-				label += resourceNodes[passNode.Inputs()[i]].Name();
-				if (i != passNode.Inputs().size() - 1)
+				label += resourceNodes[inputs[i]].Label();
+				if (i != inputs.size() - 1)
 					label += "|";
 			}
 		}
@@ -292,11 +374,11 @@ UGraphviz::Graph FrameGraph::ToGraphvizGraph2() const {
 		label += "|";
 
 		label += "{"; // begin out
-		if (!passNode.Outputs().empty()) {
-			for (size_t i = 0; i < passNode.Outputs().size(); ++i) {
+		if (!outputs.empty()) {
+			for (size_t i = 0; i < outputs.size(); ++i) {
 				label += "<out_" + std::to_string(i) + "> ";
-				label += resourceNodes[passNode.Outputs()[i]].Name();
-				if (i != passNode.Outputs().size() - 1)
+				label += resourceNodes[outputs[i]].Label();
+				if (i != outputs.size() - 1)
 					label += "|";
 			}
 		}
@@ -308,9 +390,9 @@ UGraphviz::Graph FrameGraph::ToGraphvizGraph2() const {
 
 		registry.RegisterNodeAttr(passIndex, UGraphviz::Attrs_label, std::move(label));
 
-		for (size_t i = 0; i < passNode.Inputs().size(); ++i) {
-			size_t rsrcNodeIndex = passNode.Inputs()[i];
-			const auto& rsrcNodeName = resourceNodes[rsrcNodeIndex].Name();
+		for (size_t i = 0; i < inputs.size(); ++i) {
+			size_t rsrcNodeIndex = inputs[i];
+			auto rsrcNodeName = resourceNodes[rsrcNodeIndex].Label();
 			auto edgeIndex = registry.RegisterEdge(registry.GetNodeIndex(rsrcNodeName), passIndex);
 			subgraph_read.AddEdge(edgeIndex);
 			registry.RegisterEdgePort(
@@ -319,9 +401,9 @@ UGraphviz::Graph FrameGraph::ToGraphvizGraph2() const {
 				{.ID = "in_" + std::to_string(i), .compass = UGraphviz::Registry::Port::Compass::W }
 			);
 		}
-		for (size_t i = 0; i < passNode.Outputs().size(); ++i) {
-			size_t rsrcNodeIndex = passNode.Outputs()[i];
-			const auto& rsrcNodeName = resourceNodes[rsrcNodeIndex].Name();
+		for (size_t i = 0; i < outputs.size(); ++i) {
+			size_t rsrcNodeIndex = outputs[i];
+			auto rsrcNodeName = resourceNodes[rsrcNodeIndex].Label();
 			switch (passNode.GetType())
 			{
 			case PassNode::Type::General: {
@@ -350,8 +432,8 @@ UGraphviz::Graph FrameGraph::ToGraphvizGraph2() const {
 	}
 
 	for (const auto& moveNode : moveNodes) {
-		auto srcNodeIdx = registry.GetNodeIndex(resourceNodes[moveNode.GetSourceNodeIndex()].Name());
-		auto dstNodeIdx = registry.GetNodeIndex(resourceNodes[moveNode.GetDestinationNodeIndex()].Name());
+		auto srcNodeIdx = registry.GetNodeIndex(resourceNodes[moveNode.GetSourceNodeIndex()].Label());
+		auto dstNodeIdx = registry.GetNodeIndex(resourceNodes[moveNode.GetDestinationNodeIndex()].Label());
 		auto src2dst = registry.RegisterEdge(srcNodeIdx, dstNodeIdx);
 		subgraph_move.AddEdge(src2dst);
 		registry.RegisterEdgePort(
@@ -0,0 +1,162 @@
+#include <UFG/FramePipeline.hpp>
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+FramePipeline::FramePipeline(
+	const FrameGraph& fg,
+	const Compiler::Result& crst,
+	std::span<const size_t> importedRsrcs,
+	size_t framesInFlight)
+	: framesInFlight{ framesInFlight }
+{
+	if (framesInFlight == 0)
+		throw std::logic_error("no frame in flight");
+
+	auto passes = fg.GetPassNodes();
+	auto rsrcs = fg.GetResourceNodes();
+
+	std::vector<std::set<std::pair<size_t, size_t>>> pass2waits(passes.size()); // pass -> (pass, distance)
+
+	auto add_wait = [&](size_t pass, size_t waited_pass, size_t distance) {
+		if (pass == static_cast<size_t>(-1) || waited_pass == static_cast<size_t>(-1))
+			return;
+		if (distance < framesInFlight)
+			pass2waits[pass].emplace(waited_pass, distance);
+	};
+
+	// first and final accessers of a resource, as ordered by the moves in the compiler
+	auto first_accessers = [](const Compiler::Result::RsrcInfo& info) -> std::span<const size_t> {
+		if (info.writer != static_cast<size_t>(-1))
+			return { &info.writer, 1 };
+		if (!info.readers.empty())
+			return info.readers;
+		if (info.copy_in != static_cast<size_t>(-1))
+			return { &info.copy_in, 1 };
+		return {};
+	};
+	auto final_accessers = [](const Compiler::Result::RsrcInfo& info) -> std::span<const size_t> {
+		if (info.copy_in != static_cast<size_t>(-1))
+			return { &info.copy_in, 1 };
+		if (!info.readers.empty())
+			return info.readers;
+		if (info.writer != static_cast<size_t>(-1))
+			return { &info.writer, 1 };
+		return {};
+	};
+
+	// imported resource : the accesses of frame f wait for the final conflicting accesses of frame f - 1,
+	// the accesses of the earlier frames are ordered by transitivity
+	for (auto rsrc : importedRsrcs) {
+		const auto& info = crst.rsrcinfos[rsrc];
+
+		// moved in or out : the resources of the move chain hold the physical resource in turn,
+		// a move is a write, so the chain of frame f starts after the chain of frame f - 1 ends
+		if (crst.moves_dst2src.contains(rsrc) || crst.moves_src2dst.contains(rsrc)) {
+			size_t root = rsrc;
+			for (auto target = crst.moves_dst2src.find(root); target != crst.moves_dst2src.end(); target = crst.moves_dst2src.find(root))
+				root = target->second;
+
+			std::span<const size_t> firsts;
+			std::span<const size_t> finals;
+			for (size_t cur = root; cur != static_cast<size_t>(-1);) {
+				const auto& cur_info = crst.rsrcinfos[cur];
+				if (firsts.empty())
+					firsts = first_accessers(cur_info);
+				if (auto accessers = final_accessers(cur_info); !accessers.empty())
+					finals = accessers;
+				auto target = crst.moves_src2dst.find(cur);
+				cur = target != crst.moves_src2dst.end() ? target->second : static_cast<size_t>(-1);
+			}
+
+			for (auto first : firsts) {
+				for (auto last : finals)
+					add_wait(first, last, 1);
+			}
+			continue;
+		}
+
+		std::vector<size_t> writers;
+		if (info.writer != static_cast<size_t>(-1))
+			writers.push_back(info.writer);
+		if (info.copy_in != static_cast<size_t>(-1))
+			writers.push_back(info.copy_in);
+		if (writers.empty())
+			continue; // read-only
+
+		// write after read / write
+		for (auto writer : writers) {
+			for (auto accesser : final_accessers(info))
+				add_wait(writer, accesser, 1);
+		}
+
+		// read after write, only the readers before the copy-in read the content of the previous frame
+		if (info.writer == static_cast<size_t>(-1)) {
+			for (auto reader : info.readers)
+				add_wait(reader, info.copy_in, 1);
+		}
+	}
+
+	// history resource : the version of age a read at frame f is written at frame f - a,
+	// and it is overwritten at frame f - a + versions
+	for (size_t rsrc = 0; rsrc < rsrcs.size(); rsrc++) {
+		const auto& node = rsrcs[rsrc];
+		if (!node.IsPrevious())
+			continue;
+
+		const auto& info = crst.rsrcinfos[rsrc];
+		size_t history = node.GetHistoryNodeIndex();
+		size_t versions = rsrcs[history].GetHistoryVersions();
+		size_t age = node.GetHistoryAge();
+		size_t writer = crst.rsrcinfos[history].writer;
+
+		for (auto reader : info.readers) {
+			for (size_t distance = age; distance < framesInFlight; distance += versions)
+				add_wait(reader, writer, distance);
+			for (size_t distance = versions - age; distance < framesInFlight; distance += versions)
+				add_wait(writer, reader, distance);
+		}
+	}
+	for (size_t rsrc = 0; rsrc < rsrcs.size(); rsrc++) {
+		const auto& node = rsrcs[rsrc];
+		if (!node.IsHistory())
+			continue;
+
+		const auto& info = crst.rsrcinfos[rsrc];
+		size_t versions = node.GetHistoryVersions();
+		for (size_t distance = versions; distance < framesInFlight; distance += versions) {
+			add_wait(info.writer, info.writer, distance);
+			for (auto reader : info.readers)
+				add_wait(info.writer, reader, distance);
+		}
+	}
+
+	// flatten
+	std::vector<size_t> dependentNums(passes.size() + 1, 0);
+	pass2waitOffset.resize(passes.size() + 1);
+	for (size_t pass = 0; pass < passes.size(); pass++) {
+		pass2waitOffset[pass] = waits.size();
+		for (const auto& [waited_pass, distance] : pass2waits[pass]) {
+			waits.push_back({ waited_pass, distance });
+			++dependentNums[waited_pass];
+		}
+	}
+	pass2waitOffset[passes.size()] = waits.size();
+
+	pass2dependentOffset.resize(passes.size() + 1);
+	size_t offset = 0;
+	for (size_t pass = 0; pass <= passes.size(); pass++) {
+		pass2dependentOffset[pass] = offset;
+		offset += dependentNums[pass];
+	}
+	dependents.resize(waits.size());
+	std::vector<size_t> cursors(pass2dependentOffset.begin(), pass2dependentOffset.end() - 1);
+	for (size_t pass = 0; pass < passes.size(); pass++) {
+		for (const auto& wait : GetWaits(pass))
+			dependents[cursors[wait.pass]++] = { pass, wait.distance };
+	}
+}
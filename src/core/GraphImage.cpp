@@ -0,0 +1,607 @@
+#include <UFG/GraphImage.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+namespace Ubpa::UFG::details {
+	static constexpr size_t AlignUp(size_t size) noexcept { return (size + 7) & ~static_cast<size_t>(7); }
+
+	// element size of the sections
+	static constexpr std::array<size_t, GraphImage::SectionNum> section_element_sizes{
+		sizeof(char),                         // Strings
+		sizeof(GraphImage::ResourceRecord),   // Resources
+		sizeof(GraphImage::PassRecord),       // Passes
+		sizeof(uint32_t),                     // PassResources
+		sizeof(GraphImage::MoveRecord),       // Moves
+		sizeof(uint32_t),                     // SortedPasses
+		sizeof(uint32_t),                     // PassOrders
+		sizeof(GraphImage::RsrcInfoRecord),   // RsrcInfos
+		sizeof(uint32_t),                     // Readers
+		sizeof(GraphImage::Range),            // SuccessorRanges
+		sizeof(uint32_t),                     // Successors
+		sizeof(GraphImage::PassInfoRecord),   // PassInfos
+		sizeof(uint32_t),                     // PassInfoRsrcs
+		sizeof(GraphImage::MoveRecord),       // ResultMoves
+		sizeof(GraphImage::MoveRecord),       // ResultCopies
+		sizeof(double),                       // Priorities
+		sizeof(uint32_t),                     // Workers
+	};
+
+	static uint32_t ToIndex(size_t idx) {
+		if (idx == static_cast<size_t>(-1))
+			return GraphImage::npos;
+		if (idx >= GraphImage::npos)
+			throw std::logic_error("index (" + std::to_string(idx) + ") doesn't fit in 32 bits");
+		return static_cast<uint32_t>(idx);
+	}
+
+	static size_t FromIndex(uint32_t idx) noexcept {
+		return idx == GraphImage::npos ? static_cast<size_t>(-1) : idx;
+	}
+
+	// appends the indices to the array, the range of them
+	template<typename Indices>
+	static GraphImage::Range Append(std::vector<uint32_t>& arr, const Indices& indices) {
+		GraphImage::Range range{ ToIndex(arr.size()), ToIndex(indices.size()) };
+		for (auto idx : indices)
+			arr.push_back(ToIndex(idx));
+		return range;
+	}
+
+	static uint64_t ChecksumWords(uint64_t hash, std::span<const std::byte> bytes) noexcept {
+		size_t i = 0;
+		for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+			uint64_t word;
+			std::memcpy(&word, bytes.data() + i, sizeof(uint64_t));
+			hash = (hash ^ word) * 0x100000001b3ull;
+		}
+		for (; i < bytes.size(); i++)
+			hash = (hash ^ static_cast<uint64_t>(bytes[i])) * 0x100000001b3ull;
+		return hash;
+	}
+
+	// the whole image with the checksum field of the header zeroed
+	static uint64_t ImageChecksum(std::span<const std::byte> bytes) noexcept {
+		GraphImage::Header header;
+		std::memcpy(&header, bytes.data(), sizeof(GraphImage::Header));
+		header.checksum = 0;
+		uint64_t hash = ChecksumWords(0xcbf29ce484222325ull, std::as_bytes(std::span{ &header, 1 }));
+		return ChecksumWords(hash, bytes.subspan(sizeof(GraphImage::Header)));
+	}
+
+	static std::vector<size_t> ToIndices(std::span<const uint32_t> indices) {
+		std::vector<size_t> rst(indices.size());
+		for (size_t i = 0; i < indices.size(); i++)
+			rst[i] = FromIndex(indices[i]);
+		return rst;
+	}
+
+	template<typename Map>
+	static std::vector<GraphImage::MoveRecord> ToMoveRecords(const Map& src2dst) {
+		std::vector<GraphImage::MoveRecord> records;
+		records.reserve(src2dst.size());
+		for (const auto& [src, dst] : src2dst)
+			records.push_back({ ToIndex(dst), ToIndex(src) });
+		// deterministic images
+		std::sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) { return lhs.src < rhs.src; });
+		return records;
+	}
+}
+
+#ifndef UFG_STRIP_NAMES
+std::vector<std::byte> GraphImage::Serialize(const FrameGraph& fg, const Compiler::Result& crst) {
+	const auto rsrcs = fg.GetResourceNodes();
+	const auto passes = fg.GetPassNodes();
+
+	std::string strings;
+	auto add_string = [&](std::string_view str) {
+		Range range{ details::ToIndex(strings.size()), details::ToIndex(str.size()) };
+		strings.append(str);
+		return range;
+	};
+
+	Header header{};
+	header.magic = magic;
+	header.version = version;
+	header.byte_order = byte_order;
+	header.section_num = SectionNum;
+	header.name = add_string(fg.Name());
+
+	// frame graph
+	std::vector<ResourceRecord> rsrc_records;
+	rsrc_records.reserve(rsrcs.size());
+	for (const auto& rsrc : rsrcs) {
+		ResourceRecord record{};
+		record.name = add_string(rsrc.Name());
+		record.size = rsrc.GetSize();
+		record.versions = details::ToIndex(rsrc.GetHistoryVersions());
+		record.history = details::ToIndex(rsrc.GetHistoryNodeIndex());
+		record.age = details::ToIndex(rsrc.GetHistoryAge());
+		rsrc_records.push_back(record);
+	}
+
+	std::vector<PassRecord> pass_records;
+	std::vector<uint32_t> pass_rsrcs;
+	pass_records.reserve(passes.size());
+	for (const auto& pass : passes) {
+		PassRecord record{};
+		record.name = add_string(pass.Name());
+		record.inputs = details::Append(pass_rsrcs, fg.GetPassNodeInputs(pass));
+		record.outputs = details::Append(pass_rsrcs, fg.GetPassNodeOutputs(pass));
+		record.type = static_cast<uint32_t>(pass.GetType());
+		record.condition = details::ToIndex(pass.GetCondition());
+		record.pure = pass.IsPure();
+		pass_records.push_back(record);
+	}
+
+	std::vector<MoveRecord> move_records;
+	move_records.reserve(fg.GetMoveNodes().size());
+	for (const auto& move : fg.GetMoveNodes())
+		move_records.push_back({ details::ToIndex(move.GetDestinationNodeIndex()), details::ToIndex(move.GetSourceNodeIndex()) });
+
+	// compiled result
+	std::vector<uint32_t> sorted_passes;
+	details::Append(sorted_passes, crst.sorted_passes);
+	std::vector<uint32_t> pass_orders;
+	details::Append(pass_orders, crst.pass2order);
+
+	std::vector<RsrcInfoRecord> rsrcinfo_records;
+	std::vector<uint32_t> readers;
+	rsrcinfo_records.reserve(crst.rsrcinfos.size());
+	for (const auto& info : crst.rsrcinfos) {
+		rsrcinfo_records.push_back({
+			details::ToIndex(info.first),
+			details::ToIndex(info.last),
+			details::ToIndex(info.writer),
+			details::ToIndex(info.copy_in),
+			details::Append(readers, info.readers)
+		});
+	}
+
+	// the pass graph has a key for each sorted pass
+	std::vector<Range> successor_ranges(passes.size(), Range{ 0, 0 });
+	std::vector<uint32_t> successors;
+	for (auto pass : crst.sorted_passes)
+		successor_ranges[pass] = details::Append(successors, crst.passgraph.adjList.at(pass));
+
+	std::vector<PassInfoRecord> passinfo_records;
+	std::vector<uint32_t> passinfo_rsrcs;
+	std::vector<size_t> passinfo_keys; // deterministic images
+	passinfo_keys.reserve(crst.pass2info.size());
+	for (const auto& [pass, info] : crst.pass2info)
+		passinfo_keys.push_back(pass);
+	std::sort(passinfo_keys.begin(), passinfo_keys.end());
+	passinfo_records.reserve(passinfo_keys.size());
+	for (auto pass : passinfo_keys) {
+		const auto& info = crst.pass2info.at(pass);
+		passinfo_records.push_back({
+			details::ToIndex(pass),
+			details::Append(passinfo_rsrcs, info.construct_resources),
+			details::Append(passinfo_rsrcs, info.destruct_resources),
+			details::Append(passinfo_rsrcs, info.move_resources)
+		});
+	}
+
+	auto result_moves = details::ToMoveRecords(crst.moves_src2dst);
+	auto result_copies = details::ToMoveRecords(crst.copys_src2dst);
+
+	std::vector<uint32_t> workers;
+	details::Append(workers, crst.list_schedule.pass2worker);
+
+	header.worker_num = details::ToIndex(crst.list_schedule.worker2passes.size());
+	header.peak_bytes = crst.memory.peak_bytes;
+	header.serialized_edge_num = crst.memory.serialized_edge_num;
+	header.level_num_before = crst.memory.level_num_before;
+	header.level_num = crst.memory.level_num;
+	header.makespan = crst.list_schedule.makespan;
+
+	// layout
+	std::array<std::span<const std::byte>, SectionNum> contents;
+	auto set = [&]<typename T>(Section section, const T& arr) { contents[section] = std::as_bytes(std::span{ arr }); };
+	set(Strings, strings);
+	set(Resources, rsrc_records);
+	set(Passes, pass_records);
+	set(PassResources, pass_rsrcs);
+	set(Moves, move_records);
+	set(SortedPasses, sorted_passes);
+	set(PassOrders, pass_orders);
+	set(RsrcInfos, rsrcinfo_records);
+	set(Readers, readers);
+	set(SuccessorRanges, successor_ranges);
+	set(Successors, successors);
+	set(PassInfos, passinfo_records);
+	set(PassInfoRsrcs, passinfo_rsrcs);
+	set(ResultMoves, result_moves);
+	set(ResultCopies, result_copies);
+	set(Priorities, crst.pass2priority);
+	set(Workers, workers);
+
+	size_t size = details::AlignUp(sizeof(Header));
+	for (size_t i = 0; i < SectionNum; i++) {
+		header.sections[i] = { size, contents[i].size() / details::section_element_sizes[i] };
+		size = details::AlignUp(size + contents[i].size());
+	}
+	header.size = size;
+
+	std::vector<std::byte> bytes(size, std::byte{ 0 });
+	for (size_t i = 0; i < SectionNum; i++) {
+		if (!contents[i].empty())
+			std::memcpy(bytes.data() + header.sections[i].offset, contents[i].data(), contents[i].size());
+	}
+	std::memcpy(bytes.data(), &header, sizeof(Header));
+	header.checksum = details::ImageChecksum(bytes);
+	std::memcpy(bytes.data() + offsetof(Header, checksum), &header.checksum, sizeof(uint64_t));
+
+	return bytes;
+}
+
+bool GraphImage::Save(const FrameGraph& fg, const Compiler::Result& crst, const std::string& path) {
+	auto bytes = Serialize(fg, crst);
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	return static_cast<bool>(file);
+}
+#endif // !UFG_STRIP_NAMES
+
+uint64_t GraphImage::Checksum(std::span<const std::byte> bytes) noexcept {
+	return details::ChecksumWords(0xcbf29ce484222325ull, bytes);
+}
+
+//
+// Load
+/////////
+
+std::optional<GraphImage> GraphImage::Open(const std::string& path, bool verify_checksum, std::string* error) {
+	auto fail = [&](std::string msg) -> std::optional<GraphImage> {
+		if (error)
+			*error = std::move(msg) + " (" + path + ")";
+		return std::nullopt;
+	};
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return fail("can't open the file");
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+		CloseHandle(file);
+		return fail("file too small");
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+		return fail("can't map the file");
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		CloseHandle(mapping);
+		return fail("can't map the file");
+	}
+	GraphImage image{ { static_cast<const std::byte*>(data), static_cast<size_t>(file_size.QuadPart) }, mapping };
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return fail("can't open the file");
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+		close(fd);
+		return fail("file too small");
+	}
+	void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return fail("can't map the file");
+	GraphImage image{ { static_cast<const std::byte*>(data), static_cast<size_t>(st.st_size) }, data };
+#endif
+
+	auto rst = Validate(std::move(image), verify_checksum, error);
+	if (!rst && error)
+		*error += " (" + path + ")";
+	return rst;
+}
+
+std::optional<GraphImage> GraphImage::View(std::span<const std::byte> bytes, bool verify_checksum, std::string* error) {
+	return Validate(GraphImage{ bytes, nullptr }, verify_checksum, error);
+}
+
+GraphImage::GraphImage(GraphImage&& other) noexcept : bytes{ other.bytes }, mapping{ other.mapping } {
+	other.bytes = {};
+	other.mapping = nullptr;
+}
+
+GraphImage& GraphImage::operator=(GraphImage&& other) noexcept {
+	if (this != &other) {
+		this->~GraphImage();
+		bytes = other.bytes;
+		mapping = other.mapping;
+		other.bytes = {};
+		other.mapping = nullptr;
+	}
+	return *this;
+}
+
+GraphImage::~GraphImage() {
+	if (!mapping)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(bytes.data());
+	CloseHandle(mapping);
+#else
+	munmap(const_cast<std::byte*>(bytes.data()), bytes.size());
+#endif
+	mapping = nullptr;
+}
+
+std::optional<GraphImage> GraphImage::Validate(GraphImage image, bool verify_checksum, std::string* error) {
+	auto fail = [&](std::string msg) -> std::optional<GraphImage> {
+		if (error)
+			*error = std::move(msg);
+		return std::nullopt;
+	};
+
+	const auto bytes = image.bytes;
+	if (bytes.size() < sizeof(Header))
+		return fail("image too small");
+	if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(uint64_t) != 0)
+		return fail("image not 8-byte aligned");
+
+	const auto& header = image.GetHeader();
+	if (header.magic != magic)
+		return fail("not a frame graph image");
+	if (header.byte_order != byte_order)
+		return fail("byte order mismatch");
+	if (header.version != version)
+		return fail("version " + std::to_string(header.version) + " unsupported, expected " + std::to_string(version));
+	if (header.section_num != SectionNum || header.size != bytes.size())
+		return fail("corrupted header");
+
+	for (size_t i = 0; i < SectionNum; i++) {
+		const auto& section = header.sections[i];
+		if (section.offset % 8 != 0 || section.offset < sizeof(Header) || section.offset > bytes.size()
+			|| section.num > (bytes.size() - section.offset) / details::section_element_sizes[i])
+		{
+			return fail("section " + std::to_string(i) + " out of bounds");
+		}
+	}
+
+	if (verify_checksum && details::ImageChecksum(bytes) != header.checksum)
+		return fail("checksum mismatch");
+
+	// the indices and the ranges, so the views and the conversions stay in bounds
+	const size_t string_num = header.sections[Strings].num;
+	const size_t rsrc_num = header.sections[Resources].num;
+	const size_t pass_num = header.sections[Passes].num;
+	auto in_range = [](Range range, size_t num) { return range.offset <= num && range.num <= num - range.offset; };
+	auto in_section = [&](Range range, Section section) { return in_range(range, header.sections[section].num); };
+	auto valid_indices = [](std::span<const uint32_t> indices, size_t num, bool allow_npos) {
+		for (auto idx : indices) {
+			if (idx >= num && !(allow_npos && idx == npos))
+				return false;
+		}
+		return true;
+	};
+	auto valid_index = [](uint32_t idx, size_t num) { return idx < num || idx == npos; };
+
+	if (!in_range(header.name, string_num))
+		return fail("graph name out of bounds");
+	const auto rsrc_records = image.GetResourceRecords();
+	for (const auto& record : rsrc_records) {
+		if (!in_range(record.name, string_num) || !valid_index(record.history, rsrc_num))
+			return fail("corrupted resource record");
+	}
+	// the frame graph's invariants (see FrameGraph::RegisterHistoryResourceNode and RegisterPreviousResourceNode)
+	for (const auto& record : rsrc_records) {
+		if (record.versions == 1)
+			return fail("history resource with 1 version");
+		if (record.history == npos ? record.age != 0
+			: record.versions != 0 || record.age == 0 || record.age >= rsrc_records[record.history].versions)
+		{
+			return fail("previous resource doesn't match its history resource");
+		}
+	}
+	const auto pass_records = image.GetPassRecords();
+	for (const auto& record : pass_records) {
+		if (!in_range(record.name, string_num) || !in_section(record.inputs, PassResources) || !in_section(record.outputs, PassResources)
+			|| record.type > static_cast<uint32_t>(PassNode::Type::Copy) || !valid_index(record.condition, 64))
+		{
+			return fail("corrupted pass record");
+		}
+		if (record.name.num == 0)
+			return fail("pass without name");
+		if (record.type == static_cast<uint32_t>(PassNode::Type::Copy) && record.inputs.num != record.outputs.num)
+			return fail("copy pass with " + std::to_string(record.inputs.num) + " inputs and "
+				+ std::to_string(record.outputs.num) + " outputs");
+	}
+	auto find_duplicate = [&](auto records) -> std::optional<std::string_view> {
+		std::unordered_set<std::string_view> names;
+		names.reserve(records.size());
+		for (const auto& record : records) {
+			auto name = image.GetString(record.name);
+			if (!names.insert(name).second)
+				return name;
+		}
+		return std::nullopt;
+	};
+	if (auto name = find_duplicate(rsrc_records))
+		return fail("duplicate resource name (" + std::string{ *name } + ")");
+	if (auto name = find_duplicate(pass_records))
+		return fail("duplicate pass name (" + std::string{ *name } + ")");
+	if (!valid_indices(image.GetSection<uint32_t>(PassResources), rsrc_num, false))
+		return fail("corrupted pass resources");
+	{
+		// a resource is moved in and out at most once, not into itself
+		std::vector<bool> moved_in(rsrc_num, false);
+		std::vector<bool> moved_out(rsrc_num, false);
+		for (const auto& record : image.GetMoveRecords()) {
+			if (record.dst >= rsrc_num || record.src >= rsrc_num || record.dst == record.src
+				|| moved_in[record.dst] || moved_out[record.src])
+			{
+				return fail("corrupted move record");
+			}
+			moved_in[record.dst] = true;
+			moved_out[record.src] = true;
+		}
+	}
+
+	const size_t sorted_num = header.sections[SortedPasses].num;
+	if (header.sections[PassOrders].num != pass_num || header.sections[SuccessorRanges].num != pass_num
+		|| header.sections[RsrcInfos].num != rsrc_num
+		|| (header.sections[Priorities].num != 0 && header.sections[Priorities].num != pass_num)
+		|| (header.sections[Workers].num != 0 && header.sections[Workers].num != pass_num))
+	{
+		return fail("result doesn't match the frame graph");
+	}
+	if (!valid_indices(image.GetSortedPasses(), pass_num, false) || !valid_indices(image.GetPassOrders(), sorted_num, true))
+		return fail("corrupted pass order");
+	for (const auto& record : image.GetRsrcInfoRecords()) {
+		if (!valid_index(record.first, sorted_num) || !valid_index(record.last, sorted_num)
+			|| !valid_index(record.writer, pass_num) || !valid_index(record.copy_in, pass_num)
+			|| !in_section(record.readers, Readers))
+		{
+			return fail("corrupted resource info");
+		}
+	}
+	if (!valid_indices(image.GetSection<uint32_t>(Readers), pass_num, false))
+		return fail("corrupted readers");
+	for (const auto& range : image.GetSection<Range>(SuccessorRanges)) {
+		if (!in_section(range, Successors))
+			return fail("corrupted pass graph");
+	}
+	if (!valid_indices(image.GetSection<uint32_t>(Successors), pass_num, false))
+		return fail("corrupted pass graph");
+	for (const auto& record : image.GetPassInfoRecords()) {
+		if (!valid_index(record.pass, pass_num) || !in_section(record.construct_resources, PassInfoRsrcs)
+			|| !in_section(record.destruct_resources, PassInfoRsrcs) || !in_section(record.move_resources, PassInfoRsrcs))
+		{
+			return fail("corrupted pass info");
+		}
+	}
+	if (!valid_indices(image.GetSection<uint32_t>(PassInfoRsrcs), rsrc_num, false))
+		return fail("corrupted pass info");
+	for (auto section : { ResultMoves, ResultCopies }) {
+		for (const auto& record : image.GetSection<MoveRecord>(section)) {
+			if (record.dst >= rsrc_num || record.src >= rsrc_num)
+				return fail("corrupted result moves");
+		}
+	}
+	if (!valid_indices(image.GetSection<uint32_t>(Workers), header.worker_num, true))
+		return fail("corrupted list schedule");
+
+	return image;
+}
+
+//
+// Conversion
+///////////////
+
+FrameGraph GraphImage::ToFrameGraph() const {
+	FrameGraph fg{ std::string{ Name() } };
+
+	for (const auto& record : GetResourceRecords()) {
+		ResourceNode node{ std::string{ GetString(record.name) } };
+		node.SetSize(record.size);
+		node.SetHistoryVersions(record.versions);
+		if (record.history != npos)
+			node.SetPrevious(record.history, record.age);
+		fg.RegisterResourceNode(std::move(node));
+	}
+
+	for (const auto& record : GetPassRecords()) {
+		size_t idx = fg.RegisterPassNode(
+			static_cast<PassNode::Type>(record.type),
+			std::string{ GetString(record.name) },
+			details::ToIndices(GetPassResources(record.inputs)),
+			details::ToIndices(GetPassResources(record.outputs)));
+		if (record.condition != npos)
+			fg.SetPassNodeCondition(idx, record.condition);
+		fg.SetPassNodePure(idx, record.pure != 0);
+	}
+
+	for (const auto& record : GetMoveRecords())
+		fg.RegisterMoveNode(record.dst, record.src);
+
+	return fg;
+}
+
+Compiler::Result GraphImage::ToResult() const {
+	const auto& header = GetHeader();
+	Compiler::Result rst;
+
+	rst.sorted_passes = details::ToIndices(GetSortedPasses());
+	rst.pass2order = details::ToIndices(GetPassOrders());
+
+	rst.rsrcinfos.reserve(header.sections[RsrcInfos].num);
+	for (const auto& record : GetRsrcInfoRecords()) {
+		Compiler::Result::RsrcInfo info;
+		info.first = details::FromIndex(record.first);
+		info.last = details::FromIndex(record.last);
+		info.writer = details::FromIndex(record.writer);
+		info.copy_in = details::FromIndex(record.copy_in);
+		info.readers = details::ToIndices(GetReaders(record.readers));
+		rst.rsrcinfos.push_back(std::move(info));
+	}
+
+	rst.passgraph.adjList.reserve(rst.sorted_passes.size());
+	for (auto pass : rst.sorted_passes) {
+		auto successors = GetSuccessors(pass);
+		rst.passgraph.adjList[pass].insert(successors.begin(), successors.end());
+	}
+
+	rst.pass2info.reserve(header.sections[PassInfos].num);
+	for (const auto& record : GetPassInfoRecords()) {
+		auto& info = rst.pass2info[details::FromIndex(record.pass)];
+		info.construct_resources = details::ToIndices(GetPassInfoResources(record.construct_resources));
+		info.destruct_resources = details::ToIndices(GetPassInfoResources(record.destruct_resources));
+		info.move_resources = details::ToIndices(GetPassInfoResources(record.move_resources));
+	}
+
+	for (const auto& record : GetSection<MoveRecord>(ResultMoves)) {
+		rst.moves_src2dst.emplace(record.src, record.dst);
+		rst.moves_dst2src.emplace(record.dst, record.src);
+	}
+	for (const auto& record : GetSection<MoveRecord>(ResultCopies)) {
+		rst.copys_src2dst.emplace(record.src, record.dst);
+		rst.copys_dst2src.emplace(record.dst, record.src);
+	}
+
+	rst.memory.peak_bytes = header.peak_bytes;
+	rst.memory.serialized_edge_num = header.serialized_edge_num;
+	rst.memory.level_num_before = header.level_num_before;
+	rst.memory.level_num = header.level_num;
+
+	auto priorities = GetSection<double>(Priorities);
+	rst.pass2priority.assign(priorities.begin(), priorities.end());
+
+	// the list schedule assigns the passes in sorted_passes
+	rst.list_schedule.pass2worker = details::ToIndices(GetSection<uint32_t>(Workers));
+	rst.list_schedule.worker2passes.resize(header.worker_num);
+	if (!rst.list_schedule.pass2worker.empty()) {
+		for (auto pass : rst.sorted_passes) {
+			if (size_t worker = rst.list_schedule.pass2worker[pass]; worker != static_cast<size_t>(-1))
+				rst.list_schedule.worker2passes[worker].push_back(pass);
+		}
+	}
+	rst.list_schedule.makespan = header.makespan;
+
+	return rst;
+}
@@ -0,0 +1,27 @@
+#include <UFG/HistoryRing.hpp>
+
+#include <cassert>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+size_t HistoryRing::GetHistoryNodeIndex(size_t rsrcNodeIdx) const noexcept {
+	const auto& node = fg.GetResourceNodes()[rsrcNodeIdx];
+	assert(node.IsPersistent());
+	return node.IsPrevious() ? node.GetHistoryNodeIndex() : rsrcNodeIdx;
+}
+
+size_t HistoryRing::GetSlot(size_t rsrcNodeIdx) const noexcept {
+	const auto& node = fg.GetResourceNodes()[rsrcNodeIdx];
+	const auto& history = fg.GetResourceNodes()[GetHistoryNodeIndex(rsrcNodeIdx)];
+	uint64_t versions = history.GetHistoryVersions();
+	uint64_t age = node.IsPrevious() ? node.GetHistoryAge() : 0;
+	return static_cast<size_t>((frame % versions + versions - age) % versions);
+}
+
+bool HistoryRing::IsValid(size_t rsrcNodeIdx) const noexcept {
+	const auto& node = fg.GetResourceNodes()[rsrcNodeIdx];
+	if (!node.IsPrevious())
+		return true;
+	return frame - validFrame >= node.GetHistoryAge();
+}
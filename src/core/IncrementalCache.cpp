@@ -0,0 +1,124 @@
+#include <UFG/IncrementalCache.hpp>
+
+#include <cassert>
+#include <stdexcept>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+IncrementalCache::IncrementalCache(const FrameGraph& fg, const Compiler::Result& crst)
+	: fg{ fg }, crst{ crst }
+{
+	auto passes = fg.GetPassNodes();
+	size_t rsrcNum = crst.rsrcinfos.size();
+
+	versions.resize(rsrcNum);
+	versioned.resize(rsrcNum, false);
+	persistent.resize(rsrcNum, false);
+	skipped.resize(passes.size(), false);
+	pass2keyOffset.resize(passes.size(), static_cast<size_t>(-1));
+	cached.resize(passes.size(), false);
+
+	for (auto pass : crst.sorted_passes) {
+		const auto& passNode = passes[pass];
+		if (!passNode.IsPure())
+			continue;
+
+		for (auto output : fg.GetPassNodeOutputs(passNode)) {
+			if (passNode.GetType() == PassNode::Type::Copy
+				|| crst.moves_dst2src.contains(output)
+				|| crst.moves_src2dst.contains(output)
+				|| crst.rsrcinfos[output].copy_in != static_cast<size_t>(-1))
+			{
+				throw std::logic_error("output of pure pass is moved or copied in");
+			}
+			persistent[output] = true;
+		}
+
+		pass2keyOffset[pass] = keys.size();
+		keys.resize(keys.size() + fg.GetPassNodeInputs(passNode).size());
+	}
+
+	// a copy target keeps its last copy and the version of it across frames, unknown before the first one
+	for (size_t rsrcNodeIdx = 0; rsrcNodeIdx < rsrcNum; rsrcNodeIdx++) {
+		if (crst.rsrcinfos[rsrcNodeIdx].copy_in != static_cast<size_t>(-1)) {
+			versions[rsrcNodeIdx] = GenVolatileVersion();
+			persistent[rsrcNodeIdx] = true;
+		}
+	}
+}
+
+void IncrementalCache::SetVersion(size_t rsrcNodeIdx, uint64_t version) {
+	assert(version < (uint64_t{ 1 } << 63));
+	versions[rsrcNodeIdx] = version;
+	versioned[rsrcNodeIdx] = true;
+}
+
+void IncrementalCache::Invalidate() noexcept {
+	cached.assign(cached.size(), false);
+}
+
+void IncrementalCache::NextFrame() {
+	auto passes = fg.GetPassNodes();
+
+	// the resources without writer get their versions from the user, the move sources, the copies or nothing
+	for (size_t rsrcNodeIdx = 0; rsrcNodeIdx < crst.rsrcinfos.size(); rsrcNodeIdx++) {
+		const auto& info = crst.rsrcinfos[rsrcNodeIdx];
+		if (info.writer == static_cast<size_t>(-1) && !versioned[rsrcNodeIdx]
+			&& info.copy_in == static_cast<size_t>(-1) && !crst.moves_dst2src.contains(rsrcNodeIdx))
+		{
+			versions[rsrcNodeIdx] = GenVolatileVersion();
+		}
+	}
+
+	skippedNum = 0;
+	for (auto pass : crst.sorted_passes) {
+		const auto& passNode = passes[pass];
+
+		// the versions flow along the moves before the destination is accessed
+		for (auto output : fg.GetPassNodeOutputs(passNode)) {
+			if (auto target = crst.moves_dst2src.find(output); target != crst.moves_dst2src.end())
+				versions[output] = versions[target->second];
+		}
+		for (auto input : fg.GetPassNodeInputs(passNode)) {
+			if (auto target = crst.moves_dst2src.find(input); target != crst.moves_dst2src.end()
+				&& crst.rsrcinfos[input].writer == static_cast<size_t>(-1))
+			{
+				versions[input] = versions[target->second];
+			}
+		}
+
+		bool skip = false;
+		if (passNode.IsPure()) {
+			uint64_t* key = keys.data() + pass2keyOffset[pass];
+			auto inputs = fg.GetPassNodeInputs(passNode);
+
+			skip = cached[pass];
+			for (size_t i = 0; i < inputs.size(); i++) {
+				if (key[i] != versions[inputs[i]]) {
+					key[i] = versions[inputs[i]];
+					skip = false;
+				}
+			}
+			cached[pass] = true;
+		}
+
+		skipped[pass] = skip;
+		if (skip) {
+			++skippedNum;
+			continue; // the outputs keep their versions
+		}
+
+		if (passNode.GetType() == PassNode::Type::General) {
+			for (auto output : fg.GetPassNodeOutputs(passNode))
+				versions[output] = GenVolatileVersion();
+		}
+		else {
+			// the readers of a copy target run before the copy, they see it at the next frame
+			auto inputs = fg.GetPassNodeInputs(passNode);
+			auto outputs = fg.GetPassNodeOutputs(passNode);
+			for (size_t i = 0; i < inputs.size(); i++)
+				versions[outputs[i]] = versions[inputs[i]];
+		}
+	}
+}
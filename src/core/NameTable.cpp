@@ -0,0 +1,227 @@
+#include <UFG/NameTable.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+NameTable& NameTable::Instance() {
+	// never destroyed, the names outlive the static nodes
+	static NameTable* instance = new NameTable;
+	return *instance;
+}
+
+NameTable::NameTable() : slots(1024, invalid_id) {
+	for (auto& chunk : chunks)
+		chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+NameTable::~NameTable() {
+	for (auto& chunk : chunks)
+		delete[] chunk.load(std::memory_order_relaxed);
+}
+
+size_t NameTable::Probe(const Key& key, bool* collision) const noexcept {
+	size_t mask = slots.size() - 1;
+	for (size_t i = static_cast<size_t>(key.hash) & mask;; i = (i + 1) & mask) {
+		ID id = slots[i];
+		if (id == invalid_id || Equal(id, key))
+			return i;
+		if (collision && GetHash(id) == key.hash)
+			*collision = true;
+	}
+}
+
+NameTable::ID NameTable::Find(std::string_view name) const {
+	auto key = Key::Make(name);
+	std::shared_lock<std::shared_mutex> lk(mutex);
+	return slots[Probe(key)];
+}
+
+NameTable::ID NameTable::Intern(std::string_view name) {
+	return Insert(Key::Make(name));
+}
+
+NameTable::ID NameTable::Intern(ID prefix, std::string_view suffix) {
+#ifdef UFG_STRIP_NAMES
+	const auto& entry = GetEntry(prefix);
+	return Insert({ Hash(suffix, entry.hash), Check(suffix, entry.check) });
+#else
+	std::string name{ GetName(prefix) };
+	name += suffix;
+	return Insert(Key::Make(name));
+#endif
+}
+
+std::string NameTable::GetLabel(ID id) const {
+#ifdef UFG_STRIP_NAMES
+	constexpr char hex[] = "0123456789abcdef";
+	uint64_t hash = GetHash(id);
+	std::string label(17, '#');
+	for (size_t i = 16; i > 0; i--, hash >>= 4)
+		label[i] = hex[hash & 0xf];
+	return label;
+#else
+	return std::string{ GetName(id) };
+#endif
+}
+
+NameTable::ID NameTable::Insert(const Key& key) {
+	{
+		std::shared_lock<std::shared_mutex> lk(mutex);
+		if (ID id = slots[Probe(key)]; id != invalid_id)
+			return id;
+	}
+
+	std::lock_guard<std::shared_mutex> lk(mutex);
+	bool collision = false;
+	size_t slot = Probe(key, &collision);
+	if (slots[slot] != invalid_id)
+		return slots[slot]; // interned by another thread
+#ifdef UFG_STRIP_NAMES
+	// the names can't be told apart without the strings
+	if (collision)
+		throw std::logic_error("name hash collision (UFG_STRIP_NAMES)");
+#endif
+
+	if (name_num % chunk_size == 0) {
+		if (name_num == max_name_num)
+			throw std::length_error("too many names");
+		chunks[name_num / chunk_size].store(new Entry[chunk_size], std::memory_order_release);
+	}
+	ID id = static_cast<ID>(name_num++);
+	auto& entry = chunks[id / chunk_size].load(std::memory_order_relaxed)[id % chunk_size];
+	entry.hash = key.hash;
+#ifdef UFG_STRIP_NAMES
+	entry.check = key.check;
+#else
+	entry.str = Store(key.name);
+	entry.size = static_cast<uint32_t>(key.name.size());
+#endif
+	slots[slot] = id;
+
+	// load factor <= 1/2
+	if (2 * name_num > slots.size())
+		Grow();
+
+	return id;
+}
+
+void NameTable::Grow() {
+	std::vector<ID> old_slots(slots.size() * 2, invalid_id);
+	old_slots.swap(slots);
+	size_t mask = slots.size() - 1;
+	for (auto id : old_slots) {
+		if (id == invalid_id)
+			continue;
+		size_t i = static_cast<size_t>(GetHash(id)) & mask;
+		while (slots[i] != invalid_id)
+			i = (i + 1) & mask;
+		slots[i] = id;
+	}
+}
+
+const char* NameTable::Store(std::string_view name) {
+	if (name.empty())
+		return "";
+	string_bytes += name.size();
+	if (name.size() > block_size / 4) {
+		// dedicated block, the current one keeps its space
+		blocks.emplace_back(new char[name.size()]);
+		std::memcpy(blocks.back().get(), name.data(), name.size());
+		return blocks.back().get();
+	}
+	if (block_used + name.size() > block_size) {
+		blocks.emplace_back(new char[block_size]);
+		block = blocks.back().get();
+		block_used = 0;
+	}
+	char* str = block + block_used;
+	std::memcpy(str, name.data(), name.size());
+	block_used += name.size();
+	return str;
+}
+
+NameTable::Stats NameTable::GetStats() const {
+	std::shared_lock<std::shared_mutex> lk(mutex);
+	Stats stats;
+	stats.name_num = name_num;
+	stats.string_bytes = string_bytes;
+	stats.table_bytes = (name_num + chunk_size - 1) / chunk_size * chunk_size * sizeof(Entry) + slots.size() * sizeof(ID);
+	return stats;
+}
+
+//
+// NameIndex
+//////////////
+
+size_t NameIndex::Find(std::string_view name) const noexcept {
+	if (slots.empty())
+		return npos;
+	const auto& table = NameTable::Instance();
+	auto key = NameTable::Key::Make(name);
+	size_t mask = slots.size() - 1;
+	for (size_t i = static_cast<size_t>(key.hash) & mask;; i = (i + 1) & mask) {
+		const auto& slot = slots[i];
+		if (slot.id == NameTable::invalid_id)
+			return npos;
+		if (slot.hash == key.hash && table.Equal(slot.id, key))
+			return slot.value;
+	}
+}
+
+size_t NameIndex::Find(NameTable::ID id) const noexcept {
+	if (slots.empty())
+		return npos;
+	uint64_t hash = NameTable::Instance().GetHash(id);
+	size_t mask = slots.size() - 1;
+	for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+		const auto& slot = slots[i];
+		if (slot.id == NameTable::invalid_id)
+			return npos;
+		if (slot.id == id)
+			return slot.value;
+	}
+}
+
+bool NameIndex::Insert(NameTable::ID id, size_t value) {
+	assert(value < static_cast<uint32_t>(-1));
+	if (2 * (size + 1) > slots.size())
+		Grow();
+
+	uint64_t hash = NameTable::Instance().GetHash(id);
+	size_t mask = slots.size() - 1;
+	for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+		auto& slot = slots[i];
+		if (slot.id == id)
+			return false;
+		if (slot.id == NameTable::invalid_id) {
+			slot = { hash, id, static_cast<uint32_t>(value) };
+			++size;
+			return true;
+		}
+	}
+}
+
+void NameIndex::Grow() {
+	std::vector<Slot> old_slots(slots.empty() ? 16 : slots.size() * 2);
+	old_slots.swap(slots);
+	size_t mask = slots.size() - 1;
+	for (const auto& slot : old_slots) {
+		if (slot.id == NameTable::invalid_id)
+			continue;
+		size_t i = static_cast<size_t>(slot.hash) & mask;
+		while (slots[i].id != NameTable::invalid_id)
+			i = (i + 1) & mask;
+		slots[i] = slot;
+	}
+}
+
+void NameIndex::Clear() noexcept {
+	slots.clear();
+	size = 0;
+}
@@ -0,0 +1,75 @@
+#include <UFG/PassCostModel.hpp>
+
+#include <cassert>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+void PassCostModel::Record(std::string_view passName, double duration) {
+	Record(NameTable::Instance().Intern(passName), duration);
+}
+
+void PassCostModel::Record(NameTable::ID passName, double duration) {
+	assert(duration >= 0);
+	auto target = name2entry.find(passName);
+	if (target == name2entry.end()) {
+		name2entry.emplace(passName, Entry{ duration, 1 });
+		return;
+	}
+	auto& entry = target->second;
+	entry.cost += config.alpha * (duration - entry.cost);
+	entry.sample_num++;
+}
+
+void PassCostModel::Record(const FrameGraph& fg, std::span<const double> durations) {
+	const auto passes = fg.GetPassNodes();
+	assert(durations.size() >= passes.size());
+	for (size_t i = 0; i < passes.size(); i++) {
+		if (durations[i] >= 0)
+			Record(passes[i].GetNameID(), durations[i]);
+	}
+}
+
+const PassCostModel::Entry* PassCostModel::Find(std::string_view passName) const {
+	auto id = NameTable::Instance().Find(passName);
+	if (id == NameTable::invalid_id)
+		return nullptr;
+	auto target = name2entry.find(id);
+	return target != name2entry.end() ? &target->second : nullptr;
+}
+
+bool PassCostModel::Contains(std::string_view passName) const {
+	return Find(passName) != nullptr;
+}
+
+double PassCostModel::GetCost(std::string_view passName) const {
+	const auto* entry = Find(passName);
+	return entry ? entry->cost : GetDefaultCost();
+}
+
+std::vector<double> PassCostModel::GetCosts(const FrameGraph& fg) const {
+	const auto passes = fg.GetPassNodes();
+	double default_cost = GetDefaultCost();
+	std::vector<double> costs(passes.size());
+	for (size_t i = 0; i < passes.size(); i++) {
+		auto target = name2entry.find(passes[i].GetNameID());
+		costs[i] = target != name2entry.end() ? target->second.cost : default_cost;
+	}
+	return costs;
+}
+
+size_t PassCostModel::GetSampleNum(std::string_view passName) const {
+	const auto* entry = Find(passName);
+	return entry ? entry->sample_num : 0;
+}
+
+double PassCostModel::GetDefaultCost() const noexcept {
+	if (config.default_cost > 0)
+		return config.default_cost;
+	if (name2entry.empty())
+		return 1.;
+	double sum = 0;
+	for (const auto& [name, entry] : name2entry)
+		sum += entry.cost;
+	return sum / static_cast<double>(name2entry.size());
+}
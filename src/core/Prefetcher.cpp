@@ -0,0 +1,173 @@
+#include <UFG/Prefetcher.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+Prefetcher::Prefetcher(const FrameGraph& fg, const Compiler::Result& crst, ConcurrentPool& pool, DescFunc descFunc)
+	: Prefetcher(fg, crst, pool, std::move(descFunc), Config{}) {}
+
+Prefetcher::Prefetcher(const FrameGraph& fg, const Compiler::Result& crst, ConcurrentPool& pool, DescFunc descFunc, Config config) :
+	pool{ pool },
+	descFunc{ std::move(descFunc) },
+	config{ config },
+	pass2position(fg.GetPassNodes().size(), 0),
+	states{ new std::atomic<uint32_t>[fg.GetResourceNodes().size()] },
+	handles(fg.GetResourceNodes().size())
+{
+	for (size_t i = 0; i < fg.GetResourceNodes().size(); i++)
+		states[i].store(state_taken, std::memory_order_relaxed);
+
+	if (config.unit == Unit::Order) {
+		for (size_t i = 0; i < crst.sorted_passes.size(); i++)
+			pass2position[crst.sorted_passes[i]] = i;
+	}
+	else {
+		for (auto pass : crst.sorted_passes) {
+			auto target = crst.passgraph.adjList.find(pass);
+			if (target == crst.passgraph.adjList.end())
+				continue;
+			for (auto next : target->second)
+				pass2position[next] = std::max(pass2position[next], pass2position[pass] + 1);
+		}
+	}
+
+	// the resources constructed before the passes (pass -1) are at the first position
+	for (const auto& [pass, info] : crst.pass2info) {
+		size_t position = pass == static_cast<size_t>(-1) ? 0 : pass2position[pass];
+		for (auto rsrc : info.construct_resources)
+			entries.push_back({ position, rsrc });
+	}
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+		return lhs.position < rhs.position;
+	});
+
+	helper = std::thread{ [this]() { Run(); } };
+}
+
+Prefetcher::~Prefetcher() {
+	End();
+	{
+		std::lock_guard<std::mutex> lk(m);
+		shutdown = true;
+	}
+	cv.notify_one();
+	helper.join();
+}
+
+void Prefetcher::Begin() {
+	{
+		std::unique_lock<std::mutex> lk(m);
+		cv_idle.wait(lk, [this]() { return !busy; });
+		for (const auto& entry : entries)
+			states[entry.rsrc].store(state_pending, std::memory_order_relaxed);
+		cursor = 0;
+		target = config.distance;
+		active = true;
+	}
+	cv.notify_one();
+}
+
+void Prefetcher::Advance(size_t passNodeIdx) {
+	{
+		std::lock_guard<std::mutex> lk(m);
+		target = std::max(target, pass2position[passNodeIdx] + config.distance);
+	}
+	cv.notify_one();
+}
+
+ConcurrentPool::Handle Prefetcher::Take(size_t rsrcNodeIdx) {
+	auto& state = states[rsrcNodeIdx];
+	uint32_t cur = state.load(std::memory_order_acquire);
+	while (true) {
+		if (cur == state_pending) {
+			// too late, the helper thread skips it
+			if (state.compare_exchange_weak(cur, state_taken, std::memory_order_acq_rel)) {
+				late_num.fetch_add(1, std::memory_order_relaxed);
+				return {};
+			}
+		}
+		else if (cur == state_prefetching) {
+			std::this_thread::yield();
+			cur = state.load(std::memory_order_acquire);
+		}
+		else if (cur == state_ready) {
+			state.store(state_taken, std::memory_order_relaxed);
+			taken_num.fetch_add(1, std::memory_order_relaxed);
+			return handles[rsrcNodeIdx];
+		}
+		else // taken or not constructed
+			return {};
+	}
+}
+
+void Prefetcher::End() {
+	std::unique_lock<std::mutex> lk(m);
+	active = false;
+	cv_idle.wait(lk, [this]() { return !busy; });
+
+	for (const auto& entry : entries) {
+		auto& state = states[entry.rsrc];
+		if (state.load(std::memory_order_relaxed) == state_ready)
+			pool.Release(handles[entry.rsrc]);
+		state.store(state_taken, std::memory_order_relaxed);
+	}
+}
+
+Prefetcher::Stats Prefetcher::GetStats() const noexcept {
+	Stats stats;
+	stats.prefetched_num = prefetched_num;
+	stats.taken_num = taken_num.load(std::memory_order_relaxed);
+	stats.late_num = late_num.load(std::memory_order_relaxed);
+	stats.touched_bytes = touched_bytes;
+	return stats;
+}
+
+void Prefetcher::Run() {
+	std::unique_lock<std::mutex> lk(m);
+	while (true) {
+		cv.wait(lk, [this]() {
+			return shutdown || (active && cursor < entries.size() && entries[cursor].position <= target);
+		});
+		if (shutdown)
+			return;
+
+		size_t rsrc = entries[cursor++].rsrc;
+		busy = true;
+		lk.unlock();
+
+		Prefetch(rsrc);
+
+		lk.lock();
+		busy = false;
+		cv_idle.notify_all();
+	}
+}
+
+void Prefetcher::Prefetch(size_t rsrc) {
+	auto& state = states[rsrc];
+	uint32_t cur = state_pending;
+	if (!state.compare_exchange_strong(cur, state_prefetching, std::memory_order_acq_rel))
+		return; // taken
+
+	auto desc = descFunc(rsrc);
+	if (desc.size == 0) {
+		state.store(state_taken, std::memory_order_release);
+		return;
+	}
+
+	auto handle = pool.Acquire(desc);
+	if (config.touch) {
+		constexpr size_t page_size = 4096;
+		auto* data = static_cast<volatile std::byte*>(pool.GetData(handle));
+		for (size_t offset = 0; offset < desc.size; offset += page_size)
+			data[offset] = std::byte{ 0 };
+		touched_bytes += desc.size;
+	}
+
+	handles[rsrc] = handle;
+	++prefetched_num;
+	state.store(state_ready, std::memory_order_release);
+}
@@ -0,0 +1,205 @@
+#include <UFG/ScheduleSimulator.hpp>
+
+#include "detail/MemoryChains.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+ScheduleSimulator::ScheduleSimulator(const FrameGraph& fg, const Compiler::Result& crst) :
+	crst{ crst },
+	passNum{ fg.GetPassNodes().size() },
+	pass2succOffset(passNum + 1, 0),
+	predNums(passNum, 0),
+	pass2chainOffset(passNum + 1, 0)
+{
+	for (size_t pass = 0; pass < passNum; pass++) {
+		pass2succOffset[pass] = succs.size();
+		if (auto target = crst.passgraph.adjList.find(pass); target != crst.passgraph.adjList.end()) {
+			for (auto next : target->second) {
+				succs.push_back(next);
+				predNums[next]++;
+			}
+		}
+	}
+	pass2succOffset[passNum] = succs.size();
+
+	// chains of moves, the users of all members, as in Compiler::Result::GetMemoryReport
+	auto chains = details::CollectMemoryChains(fg, crst);
+	chainSizes = std::move(chains.sizes);
+	chainUserNums = std::move(chains.user_nums);
+	chainPreallocated = std::move(chains.preallocated);
+	for (size_t pass = 0; pass < passNum; pass++) {
+		pass2chainOffset[pass] = pass2chains.size();
+		pass2chains.insert(pass2chains.end(), chains.pass2chains[pass].begin(), chains.pass2chains[pass].end());
+	}
+	pass2chainOffset[passNum] = pass2chains.size();
+}
+
+ScheduleSimulator::Result ScheduleSimulator::Simulate(std::span<const double> costs, const Config& config) const {
+	assert(costs.size() >= passNum);
+	if (config.queue_worker_nums.empty())
+		throw std::logic_error("no queue");
+	if (!config.pass2queue.empty() && config.pass2queue.size() < passNum)
+		throw std::logic_error("pass2queue (" + std::to_string(config.pass2queue.size())
+			+ ") doesn't cover the pass nodes (" + std::to_string(passNum) + ")");
+	for (auto pass : crst.sorted_passes) {
+		size_t queue = config.pass2queue.empty() ? 0 : config.pass2queue[pass];
+		if (queue >= config.queue_worker_nums.size())
+			throw std::logic_error("pass " + std::to_string(pass) + " on the queue " + std::to_string(queue)
+				+ " out of the " + std::to_string(config.queue_worker_nums.size()) + " queues");
+		if (config.queue_worker_nums[queue] == 0)
+			throw std::logic_error("pass " + std::to_string(pass) + " on the queue " + std::to_string(queue) + " without workers");
+	}
+
+	auto queueOf = [&](size_t pass) { return config.pass2queue.empty() ? 0 : config.pass2queue[pass]; };
+	auto latency = [&](size_t from, size_t to) { return queueOf(from) != queueOf(to) ? config.cross_queue_latency : 0.; };
+	auto durationOf = [&](size_t pass) { return costs[pass] + config.dispatch_cost; };
+
+	Result rst;
+	rst.pass2start.assign(passNum, 0);
+	rst.pass2finish.assign(passNum, 0);
+	rst.pass2worker.assign(passNum, static_cast<size_t>(-1));
+
+	// longest path to the sinks, the priority of CriticalPath
+	std::vector<double> tails(passNum, 0);
+	for (auto iter = crst.sorted_passes.rbegin(); iter != crst.sorted_passes.rend(); ++iter) {
+		size_t pass = *iter;
+		double tail = 0;
+		for (size_t i = pass2succOffset[pass]; i < pass2succOffset[pass + 1]; i++)
+			tail = std::max(tail, latency(pass, succs[i]) + tails[succs[i]]);
+		tails[pass] = durationOf(pass) + tail;
+		rst.critical_path = std::max(rst.critical_path, tails[pass]);
+		rst.work += costs[pass];
+	}
+
+	// workers
+	std::vector<std::vector<size_t>> queue2freeWorkers(config.queue_worker_nums.size());
+	for (size_t queue = 0; queue < config.queue_worker_nums.size(); queue++) {
+		for (size_t i = 0; i < config.queue_worker_nums[queue]; i++) {
+			queue2freeWorkers[queue].push_back(rst.workers.size());
+			rst.workers.push_back({ queue });
+		}
+		// the first worker is picked first
+		std::reverse(queue2freeWorkers[queue].begin(), queue2freeWorkers[queue].end());
+	}
+
+	// ready passes per queue, the greatest key is picked
+	std::vector<double> readyTimes(passNum, 0);
+	using ReadyKey = std::pair<double, size_t>; // (policy key, reversed order)
+	auto readyKey = [&](size_t pass) -> ReadyKey {
+		size_t order = crst.pass2order[pass];
+		switch (config.policy)
+		{
+		case Policy::Fifo:
+			return { -readyTimes[pass], static_cast<size_t>(-1) - order };
+		case Policy::CriticalPath:
+			return { tails[pass], static_cast<size_t>(-1) - order };
+		default:
+			return { 0., static_cast<size_t>(-1) - order };
+		}
+	};
+	using ReadyEntry = std::pair<ReadyKey, size_t>;
+	std::vector<std::priority_queue<ReadyEntry>> queue2ready(config.queue_worker_nums.size());
+
+	// events : (time, kind, pass), finishes before readies at the same time
+	enum Kind : size_t { kind_finish, kind_ready };
+	using Event = std::tuple<double, size_t, size_t>;
+	std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+
+	std::vector<size_t> remainPredNums = predNums;
+	for (auto pass : crst.sorted_passes) {
+		if (remainPredNums[pass] == 0)
+			events.emplace(0., kind_ready, pass);
+	}
+
+	// memory, the preallocated chains are live from the start
+	std::vector<bool> live = chainPreallocated;
+	std::vector<size_t> remainUserNums = chainUserNums;
+	size_t liveBytes = 0;
+	for (size_t chain = 0; chain < chainSizes.size(); chain++) {
+		if (live[chain])
+			liveBytes += chainSizes[chain];
+	}
+	auto sample = [&](double time) {
+		if (!rst.memory.empty() && rst.memory.back().time == time)
+			rst.memory.back().bytes = liveBytes;
+		else if (rst.memory.empty() || rst.memory.back().bytes != liveBytes)
+			rst.memory.push_back({ time, liveBytes });
+		if (liveBytes > rst.peak_bytes) {
+			rst.peak_bytes = liveBytes;
+			rst.peak_time = time;
+		}
+	};
+	sample(0.);
+
+	while (!events.empty()) {
+		double now = std::get<0>(events.top());
+
+		// all events at now
+		while (!events.empty() && std::get<0>(events.top()) == now) {
+			auto [time, kind, pass] = events.top();
+			events.pop();
+
+			if (kind == kind_ready) {
+				queue2ready[queueOf(pass)].emplace(readyKey(pass), pass);
+				continue;
+			}
+
+			// finish
+			size_t worker = rst.pass2worker[pass];
+			queue2freeWorkers[rst.workers[worker].queue].push_back(worker);
+			for (size_t i = pass2chainOffset[pass]; i < pass2chainOffset[pass + 1]; i++) {
+				size_t chain = pass2chains[i];
+				if (--remainUserNums[chain] == 0) {
+					live[chain] = false;
+					liveBytes -= chainSizes[chain];
+				}
+			}
+			for (size_t i = pass2succOffset[pass]; i < pass2succOffset[pass + 1]; i++) {
+				size_t next = succs[i];
+				readyTimes[next] = std::max(readyTimes[next], now + latency(pass, next));
+				if (--remainPredNums[next] == 0)
+					events.emplace(readyTimes[next], kind_ready, next);
+			}
+			rst.makespan = std::max(rst.makespan, now);
+		}
+
+		// dispatch
+		for (size_t queue = 0; queue < queue2ready.size(); queue++) {
+			auto& ready = queue2ready[queue];
+			auto& freeWorkers = queue2freeWorkers[queue];
+			while (!ready.empty() && !freeWorkers.empty()) {
+				size_t pass = ready.top().second;
+				ready.pop();
+				size_t worker = freeWorkers.back();
+				freeWorkers.pop_back();
+
+				for (size_t i = pass2chainOffset[pass]; i < pass2chainOffset[pass + 1]; i++) {
+					size_t chain = pass2chains[i];
+					if (!live[chain] && remainUserNums[chain] == chainUserNums[chain]) {
+						live[chain] = true;
+						liveBytes += chainSizes[chain];
+					}
+				}
+
+				double duration = durationOf(pass);
+				rst.pass2start[pass] = now;
+				rst.pass2finish[pass] = now + duration;
+				rst.pass2worker[pass] = worker;
+				rst.workers[worker].busy_time += duration;
+				rst.workers[worker].pass_num++;
+				events.emplace(now + duration, kind_finish, pass);
+			}
+		}
+		sample(now);
+	}
+
+	return rst;
+}
@@ -0,0 +1,80 @@
+#include <UFG/StateTracker.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+StateTracker::StateTracker(const FrameGraph& fg, const Compiler::Result& crst) :
+	fg{ fg },
+	crst{ crst },
+	pass2acquireOffset(fg.GetPassNodes().size() + 1, 0),
+	pass2releaseOffset(fg.GetPassNodes().size() + 1, 0),
+	entryStates(fg.GetResourceNodes().size(), state_none),
+	states(fg.GetResourceNodes().size(), state_none) {}
+
+StateTracker& StateTracker::Require(size_t passNodeIdx, size_t rsrcNodeIdx, State state) {
+	registrations.emplace_back(passNodeIdx, Requirement{ rsrcNodeIdx, state });
+	return *this;
+}
+
+void StateTracker::Build() {
+	const auto& passes = fg.GetPassNodes();
+	const auto& rsrcs = fg.GetResourceNodes();
+
+	std::vector<std::vector<Requirement>> pass2acquires(passes.size());
+	std::vector<std::vector<Requirement>> pass2releases(passes.size());
+	std::fill(entryStates.begin(), entryStates.end(), state_none);
+
+	for (const auto& [pass, requirement] : registrations) {
+		const auto& passNode = passes[pass];
+		auto contains = [](std::span<const uint32_t> rsrcs, size_t rsrc) {
+			return std::find(rsrcs.begin(), rsrcs.end(), rsrc) != rsrcs.end();
+		};
+
+		if (contains(fg.GetPassNodeOutputs(passNode), requirement.rsrc)) {
+			pass2acquires[pass].push_back(requirement);
+			continue;
+		}
+
+		if (!contains(fg.GetPassNodeInputs(passNode), requirement.rsrc)) {
+			throw std::logic_error("pass (" + passNode.Label() + ") doesn't access resource ("
+				+ rsrcs[requirement.rsrc].Label() + ")");
+		}
+
+		// readers
+		auto& entry = entryStates[requirement.rsrc];
+		if (entry != state_none && entry != requirement.state) {
+			throw std::logic_error("readers of resource (" + rsrcs[requirement.rsrc].Label()
+				+ ") require different states");
+		}
+		entry = requirement.state;
+	}
+
+	// hoist the transitions of the readers to the writer, or keep them for Construct and Move.
+	// a copy-in comes after the readers (readers -> copy_in in the pass graph), so it never owns their transition
+	for (size_t rsrc = 0; rsrc < rsrcs.size(); rsrc++) {
+		if (entryStates[rsrc] == state_none || rsrc >= crst.rsrcinfos.size())
+			continue;
+
+		size_t writer = crst.rsrcinfos[rsrc].writer;
+		if (writer != static_cast<size_t>(-1)) {
+			pass2releases[writer].push_back({ rsrc, entryStates[rsrc] });
+			entryStates[rsrc] = state_none;
+		}
+	}
+
+	auto flatten = [&](const std::vector<std::vector<Requirement>>& pass2requirements,
+		std::vector<size_t>& offsets, std::vector<Requirement>& requirements)
+	{
+		requirements.clear();
+		for (size_t pass = 0; pass < passes.size(); pass++) {
+			offsets[pass] = requirements.size();
+			requirements.insert(requirements.end(), pass2requirements[pass].begin(), pass2requirements[pass].end());
+		}
+		offsets[passes.size()] = requirements.size();
+	};
+	flatten(pass2acquires, pass2acquireOffset, acquires);
+	flatten(pass2releases, pass2releaseOffset, releases);
+}
@@ -0,0 +1,146 @@
+#include <UFG/TraceRecorder.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+TraceRecorder::TraceRecorder(size_t capacity) :
+	mask{ std::bit_ceil(std::max<size_t>(capacity, 1)) - 1 },
+	events{ new Event[mask + 1]() }, // touch the pages before recording
+	epoch{ Clock::now() } {}
+
+uint32_t TraceRecorder::GetThread() noexcept {
+	static std::atomic<uint32_t> thread_num{ 0 };
+	thread_local uint32_t thread_id = thread_num.fetch_add(1, std::memory_order_relaxed);
+	return thread_id;
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::GetEvents() const {
+	uint64_t end = next.load(std::memory_order_acquire);
+	uint64_t begin = end > mask + 1 ? end - (mask + 1) : 0;
+	std::vector<Event> rst;
+	rst.reserve(end - begin);
+	for (uint64_t cursor = begin; cursor < end; cursor++)
+		rst.push_back(events[cursor & mask]);
+	return rst;
+}
+
+namespace Ubpa::UFG::details {
+	static void AppendJsonString(std::string& json, std::string_view str) {
+		json += '"';
+		for (char c : str) {
+			if (c == '"' || c == '\\') {
+				json += '\\';
+				json += c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20) {
+				// control characters as \u00XX
+				constexpr char hex[] = "0123456789abcdef";
+				json += "\\u00";
+				json += hex[static_cast<unsigned char>(c) >> 4];
+				json += hex[static_cast<unsigned char>(c) & 0xf];
+			}
+			else
+				json += c;
+		}
+		json += '"';
+	}
+}
+
+std::string TraceRecorder::ToChromeTrace(const FrameGraph& fg) const {
+	auto passName = [&](uint32_t pass) -> std::string {
+		return pass < fg.GetPassNodes().size() ? fg.GetPassNodes()[pass].Label() : std::string{ "Pass" };
+	};
+	auto rsrcName = [&](uint32_t rsrc) -> std::string {
+		return rsrc < fg.GetResourceNodes().size() ? fg.GetResourceNodes()[rsrc].Label() : std::string{ "Resource" };
+	};
+
+	std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	for (const auto& event : GetEvents()) {
+		if (!first)
+			json += ',';
+		first = false;
+
+		json += "\n{\"name\":";
+		const char* cat = "pass";
+		const char* ph = "i";
+		std::string args;
+		switch (event.type)
+		{
+		case EventType::PassBegin:
+			details::AppendJsonString(json, passName(event.index));
+			ph = "B";
+			break;
+		case EventType::PassEnd:
+			details::AppendJsonString(json, passName(event.index));
+			ph = "E";
+			break;
+		case EventType::Construct:
+			details::AppendJsonString(json, "Construct");
+			cat = "resource";
+			args = "\"resource\":";
+			details::AppendJsonString(args, rsrcName(event.index));
+			break;
+		case EventType::Destruct:
+			details::AppendJsonString(json, "Destruct");
+			cat = "resource";
+			args = "\"resource\":";
+			details::AppendJsonString(args, rsrcName(event.index));
+			break;
+		case EventType::Move:
+			details::AppendJsonString(json, "Move");
+			cat = "resource";
+			args = "\"dst\":";
+			details::AppendJsonString(args, rsrcName(event.index));
+			args += ",\"src\":";
+			details::AppendJsonString(args, rsrcName(event.arg0));
+			break;
+		case EventType::Transition:
+			details::AppendJsonString(json, "Transition");
+			cat = "resource";
+			args = "\"resource\":";
+			details::AppendJsonString(args, rsrcName(event.index));
+			args += ",\"before\":" + std::to_string(event.arg0) + ",\"after\":" + std::to_string(event.arg1);
+			break;
+		case EventType::IdleBegin:
+			json += "\"Idle\"";
+			cat = "worker";
+			ph = "B";
+			break;
+		case EventType::IdleEnd:
+			json += "\"Idle\"";
+			cat = "worker";
+			ph = "E";
+			break;
+		}
+
+		// microseconds with nanosecond precision
+		json += ",\"cat\":\"";
+		json += cat;
+		json += "\",\"ph\":\"";
+		json += ph;
+		json += "\",\"ts\":" + std::to_string(event.time / 1000) + '.';
+		std::string ns = std::to_string(event.time % 1000);
+		json += std::string(3 - ns.size(), '0') + ns;
+		json += ",\"pid\":0,\"tid\":" + std::to_string(event.thread);
+		if (ph[0] == 'i')
+			json += ",\"s\":\"t\"";
+		if (!args.empty())
+			json += ",\"args\":{" + args + '}';
+		json += '}';
+	}
+	json += "\n]}\n";
+	return json;
+}
+
+bool TraceRecorder::WriteChromeTrace(const FrameGraph& fg, const std::string& path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	file << ToChromeTrace(fg);
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,406 @@
+#include <UFG/TransientPool.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+TransientPool::TransientPool() : TransientPool(Config{}) {}
+
+TransientPool::TransientPool(Config config) : config{ config } {}
+
+TransientPool::~TransientPool() {
+	assert(stats.live_bytes == 0);
+	Reclaim(static_cast<uint64_t>(-1));
+	Clear();
+	assert(stats.page_num == 0);
+}
+
+size_t TransientPool::GetClassSize(size_t size) const noexcept {
+	assert(config.class_num_per_octave > 0);
+	size_t s = std::max(size, granularity);
+	// 2^o < s <= 2^(o+1), the octave is split into class_num_per_octave classes
+	size_t step = std::max(std::bit_floor(s - 1) / config.class_num_per_octave, granularity);
+	return (s + step - 1) / step * step;
+}
+
+TransientPool::Handle TransientPool::Acquire(const Desc& desc) {
+	size_t alignment = std::max(desc.alignment, granularity);
+	size_t size = GetClassSize(desc.size);
+
+	// hit : the most recently released block of the smallest class hosting the desc
+	size_t max_size = static_cast<size_t>(static_cast<double>(size) * config.max_host_ratio);
+	for (auto target = class2cached.lower_bound(size);
+		target != class2cached.end() && target->first <= max_size; ++target)
+	{
+		for (uint32_t index = target->second.tail; index != npos; index = nodes[index].prev) {
+			auto& node = nodes[index];
+			if (reinterpret_cast<uintptr_t>(node.data) % alignment != 0)
+				continue;
+
+			Pop(target, index);
+			node.state = NodeState::Live;
+			node.desc = desc;
+
+			++stats.hit_num;
+			stats.live_bytes += desc.size;
+			stats.waste_bytes += node.size - desc.size;
+			return { index };
+		}
+	}
+
+	// miss
+	uint32_t index;
+	if (freeNodes.empty()) {
+		index = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
+	}
+	else {
+		index = freeNodes.back();
+		freeNodes.pop_back();
+	}
+
+	auto& node = nodes[index];
+	node.desc = desc;
+	node.size = size;
+
+	if (size <= config.page_size && alignment <= page_alignment) {
+		while (!Suballocate(node, alignment)) {
+			if (stats.allocated_bytes + config.page_size > config.budget && lru.head != npos) {
+				Free(lru.head);
+				++stats.evicted_num;
+				continue;
+			}
+
+			if (stats.allocated_bytes + config.page_size > config.budget)
+				++stats.over_budget_num;
+
+			NewPage();
+		}
+	}
+	else {
+		while (stats.allocated_bytes + size > config.budget && lru.head != npos) {
+			Free(lru.head);
+			++stats.evicted_num;
+		}
+		if (stats.allocated_bytes + size > config.budget)
+			++stats.over_budget_num;
+
+		node.page = npos;
+		node.alignment = alignment;
+		node.data = ::operator new(size, std::align_val_t{ alignment });
+		stats.allocated_bytes += size;
+	}
+
+	++stats.miss_num;
+	++stats.block_num;
+	stats.live_bytes += desc.size;
+	stats.waste_bytes += size - desc.size;
+	return { index };
+}
+
+void TransientPool::Release(Handle handle) {
+	assert(handle.IsValid());
+	auto& node = nodes[handle.index];
+	stats.live_bytes -= node.desc.size;
+	stats.waste_bytes -= node.size - node.desc.size;
+	Cache(handle.index);
+}
+
+void TransientPool::Retire(Handle handle, uint64_t fence) {
+	assert(handle.IsValid());
+	assert(retireds.empty() || retireds.back().first <= fence);
+	auto& node = nodes[handle.index];
+	node.state = NodeState::Retired;
+	stats.live_bytes -= node.desc.size;
+	stats.waste_bytes -= node.size - node.desc.size;
+	stats.retired_bytes += node.size;
+	retireds.emplace_back(fence, handle.index);
+}
+
+void TransientPool::Reclaim(uint64_t completedFence) {
+	while (!retireds.empty() && retireds.front().first <= completedFence) {
+		uint32_t index = retireds.front().second;
+		retireds.pop_front();
+		stats.retired_bytes -= nodes[index].size;
+		Cache(index);
+	}
+}
+
+void TransientPool::Cache(uint32_t index) {
+	auto& node = nodes[index];
+	node.state = NodeState::Cached;
+	node.frame = frame;
+
+	auto& list = class2cached[node.size];
+	node.prev = list.tail;
+	node.next = npos;
+	(list.tail != npos ? nodes[list.tail].next : list.head) = index;
+	list.tail = index;
+
+	node.lru_prev = lru.tail;
+	node.lru_next = npos;
+	(lru.tail != npos ? nodes[lru.tail].lru_next : lru.head) = index;
+	lru.tail = index;
+
+	stats.cached_bytes += node.size;
+}
+
+void TransientPool::Pop(std::map<size_t, List>::iterator target, uint32_t index) {
+	auto& node = nodes[index];
+	auto& list = target->second;
+
+	(node.prev != npos ? nodes[node.prev].next : list.head) = node.next;
+	(node.next != npos ? nodes[node.next].prev : list.tail) = node.prev;
+	if (list.head == npos)
+		class2cached.erase(target);
+
+	(node.lru_prev != npos ? nodes[node.lru_prev].lru_next : lru.head) = node.lru_next;
+	(node.lru_next != npos ? nodes[node.lru_next].lru_prev : lru.tail) = node.lru_prev;
+
+	node.prev = node.next = node.lru_prev = node.lru_next = npos;
+
+	stats.cached_bytes -= node.size;
+}
+
+void TransientPool::Free(uint32_t index) {
+	auto& node = nodes[index];
+	Pop(class2cached.find(node.size), index);
+
+	if (node.page == npos) {
+		::operator delete(node.data, std::align_val_t{ node.alignment });
+		stats.allocated_bytes -= node.size;
+	}
+	else
+		ReturnRange(node.page, node.offset, node.size);
+	--stats.block_num;
+
+	node = Node{};
+	freeNodes.push_back(index);
+}
+
+uint32_t TransientPool::NewPage() {
+	uint32_t pageIdx;
+	if (freePages.empty()) {
+		pageIdx = static_cast<uint32_t>(pages.size());
+		pages.emplace_back();
+	}
+	else {
+		pageIdx = freePages.back();
+		freePages.pop_back();
+	}
+
+	auto& page = pages[pageIdx];
+	page.size = config.page_size;
+	page.free_size = page.size;
+	page.data = static_cast<std::byte*>(::operator new(page.size, std::align_val_t{ page_alignment }));
+	AddFreeRange(pageIdx, 0, page.size);
+
+	++stats.page_num;
+	stats.allocated_bytes += page.size;
+	stats.free_bytes += page.size;
+	return pageIdx;
+}
+
+bool TransientPool::Suballocate(Node& node, size_t alignment) {
+	// best-fit : the smallest free range fitting the aligned block
+	for (auto iter = free_ranges.lower_bound({ node.size, 0, 0 }); iter != free_ranges.end(); ++iter) {
+		auto [range_size, pageIdx, offset] = *iter;
+		size_t begin = (offset + alignment - 1) / alignment * alignment;
+		size_t end = begin + node.size;
+		if (end > offset + range_size)
+			continue;
+
+		RemoveFreeRange(pageIdx, offset, range_size);
+		if (begin > offset)
+			AddFreeRange(pageIdx, offset, begin - offset);
+		if (end < offset + range_size)
+			AddFreeRange(pageIdx, end, offset + range_size - end);
+
+		auto& page = pages[pageIdx];
+		page.free_size -= node.size;
+		stats.free_bytes -= node.size;
+
+		node.page = pageIdx;
+		node.offset = begin;
+		node.data = page.data + begin;
+		return true;
+	}
+	return false;
+}
+
+void TransientPool::AddFreeRange(uint32_t pageIdx, size_t offset, size_t size) {
+	pages[pageIdx].free_ranges.emplace(offset, size);
+	free_ranges.emplace(size, pageIdx, offset);
+}
+
+void TransientPool::RemoveFreeRange(uint32_t pageIdx, size_t offset, size_t size) {
+	pages[pageIdx].free_ranges.erase(offset);
+	free_ranges.erase({ size, pageIdx, offset });
+}
+
+void TransientPool::ReturnRange(uint32_t pageIdx, size_t offset, size_t size) {
+	auto& page = pages[pageIdx];
+	page.free_size += size;
+	stats.free_bytes += size;
+
+	// empty page
+	if (page.free_size == page.size) {
+		for (const auto& [range_offset, range_size] : page.free_ranges)
+			free_ranges.erase({ range_size, pageIdx, range_offset });
+		::operator delete(page.data, std::align_val_t{ page_alignment });
+
+		--stats.page_num;
+		stats.allocated_bytes -= page.size;
+		stats.free_bytes -= page.size;
+
+		page = Page{};
+		freePages.push_back(pageIdx);
+		return;
+	}
+
+	// coalesce with the neighbors
+	auto next = page.free_ranges.upper_bound(offset);
+	if (next != page.free_ranges.begin()) {
+		auto prev = std::prev(next);
+		if (prev->first + prev->second == offset) {
+			offset = prev->first;
+			size += prev->second;
+			RemoveFreeRange(pageIdx, prev->first, prev->second);
+		}
+	}
+	if (next != page.free_ranges.end() && next->first == offset + size) {
+		size += next->second;
+		RemoveFreeRange(pageIdx, next->first, next->second);
+	}
+
+	AddFreeRange(pageIdx, offset, size);
+}
+
+void TransientPool::NextFrame() {
+	++frame;
+	while (lru.head != npos && frame - nodes[lru.head].frame > config.max_age) {
+		Free(lru.head);
+		++stats.aged_num;
+	}
+}
+
+void TransientPool::Clear() {
+	while (lru.head != npos)
+		Free(lru.head);
+}
+
+size_t TransientPool::GetLargestFreeRange() const noexcept {
+	return free_ranges.empty() ? 0 : std::get<0>(*free_ranges.rbegin());
+}
+
+double TransientPool::GetFragmentation() const noexcept {
+	if (stats.free_bytes == 0)
+		return 0.;
+
+	return 1. - static_cast<double>(GetLargestFreeRange()) / static_cast<double>(stats.free_bytes);
+}
+
+size_t TransientPool::Compact(std::chrono::nanoseconds timeBudget, bool relocateLive) {
+	auto begin = std::chrono::steady_clock::now();
+	size_t allocated_bytes = stats.allocated_bytes;
+
+	// pageIdx -> blocks
+	std::vector<std::vector<uint32_t>> page2blocks(pages.size());
+	std::vector<bool> movables(pages.size(), true);
+	for (uint32_t index = 0; index < nodes.size(); index++) {
+		const auto& node = nodes[index];
+		if (!node.data || node.page == npos)
+			continue;
+		page2blocks[node.page].push_back(index);
+		if (node.state == NodeState::Retired || (node.state == NodeState::Live && !relocateLive))
+			movables[node.page] = false;
+	}
+
+	// the sparse pages, emptiest first
+	std::vector<uint32_t> candidates;
+	for (uint32_t pageIdx = 0; pageIdx < pages.size(); pageIdx++) {
+		const auto& page = pages[pageIdx];
+		if (page.data && movables[pageIdx]
+			&& static_cast<double>(page.size - page.free_size) <= config.compact_occupancy * static_cast<double>(page.size))
+		{
+			candidates.push_back(pageIdx);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [&](uint32_t lhs, uint32_t rhs) {
+		return pages[lhs].free_size > pages[rhs].free_size;
+	});
+
+	// the candidates are not the destinations
+	for (auto pageIdx : candidates) {
+		for (const auto& [offset, size] : pages[pageIdx].free_ranges)
+			free_ranges.erase({ size, pageIdx, offset });
+	}
+
+	size_t evacuated_num = 0;
+	for (auto pageIdx : candidates) {
+		if (std::chrono::steady_clock::now() - begin >= timeBudget)
+			break;
+
+		// place the larger blocks first, a fresh page is allocated when the other pages are full
+		// except for the last candidate (moving it to a fresh page reclaims nothing)
+		bool last = evacuated_num + 1 == candidates.size();
+		auto& blocks = page2blocks[pageIdx];
+		std::sort(blocks.begin(), blocks.end(), [&](uint32_t lhs, uint32_t rhs) {
+			return nodes[lhs].size > nodes[rhs].size;
+		});
+		std::vector<Node> placements;
+		bool placed = true;
+		for (auto index : blocks) {
+			Node placement;
+			placement.size = nodes[index].size;
+			size_t alignment = std::max(nodes[index].desc.alignment, granularity);
+			while (!Suballocate(placement, alignment)) {
+				if (last) {
+					placed = false;
+					break;
+				}
+				NewPage();
+			}
+			if (!placed)
+				break;
+			placements.push_back(placement);
+		}
+		if (!placed) {
+			for (const auto& placement : placements)
+				ReturnRange(placement.page, placement.offset, placement.size);
+			break;
+		}
+
+		for (size_t i = 0; i < blocks.size(); i++) {
+			auto& node = nodes[blocks[i]];
+			const auto& placement = placements[i];
+			if (node.state == NodeState::Live)
+				std::memcpy(placement.data, node.data, node.size);
+			stats.relocated_bytes += node.size;
+
+			size_t offset = node.offset;
+			node.page = placement.page;
+			node.offset = placement.offset;
+			node.data = placement.data;
+			// the last one frees the page
+			ReturnRange(pageIdx, offset, node.size);
+		}
+		++evacuated_num;
+	}
+
+	// the kept candidates are destinations again
+	for (size_t i = evacuated_num; i < candidates.size(); i++) {
+		uint32_t pageIdx = candidates[i];
+		for (const auto& [offset, size] : pages[pageIdx].free_ranges)
+			free_ranges.emplace(size, pageIdx, offset);
+	}
+
+	size_t reclaimed_bytes = allocated_bytes > stats.allocated_bytes ? allocated_bytes - stats.allocated_bytes : 0;
+	stats.reclaimed_bytes += reclaimed_bytes;
+	return reclaimed_bytes;
+}
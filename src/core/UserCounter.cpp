@@ -0,0 +1,26 @@
+#include <UFG/UserCounter.hpp>
+
+using namespace Ubpa;
+using namespace Ubpa::UFG;
+
+UserCounter::UserCounter(const FrameGraph& fg, const Compiler::Result& crst) :
+	fg{ fg },
+	userNums(fg.GetResourceNodes().size(), 0),
+	counts{ new std::atomic<uint32_t>[fg.GetResourceNodes().size()] }
+{
+	for (size_t i = 0; i < crst.rsrcinfos.size(); i++) {
+		const auto& info = crst.rsrcinfos[i];
+		size_t num = info.readers.size();
+		if (info.writer != static_cast<size_t>(-1))
+			++num;
+		if (info.copy_in != static_cast<size_t>(-1))
+			++num;
+		userNums[i] = static_cast<uint32_t>(num);
+	}
+	Reset();
+}
+
+void UserCounter::Reset() noexcept {
+	for (size_t i = 0; i < userNums.size(); i++)
+		counts[i].store(userNums[i], std::memory_order_relaxed);
+}
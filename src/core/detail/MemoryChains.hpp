@@ -0,0 +1,23 @@
+#pragma once
+
+#include <UFG/Compiler.hpp>
+
+#include <span>
+#include <vector>
+
+namespace Ubpa::UFG::details {
+	// a chain of moves shares one allocation, live from its first accessor to its last one
+	struct MemoryChains {
+		std::vector<size_t> sizes; // chain -> bytes
+		std::vector<size_t> roots; // chain -> resource moved into the others
+		std::vector<size_t> user_nums; // chain -> accessor num
+		std::vector<bool> preallocated; // chain -> constructed before the passes (the root isn't accessed)
+		std::vector<std::vector<size_t>> pass2chains;
+		size_t total_bytes{ 0 };
+	};
+
+	// the sized transient resources of rst (see ResourceNode::GetSize), shared by the compiler and the simulator
+	MemoryChains CollectMemoryChains(const FrameGraph& fg, const Compiler::Result& rst);
+	// only the chains rooted at the candidates
+	MemoryChains CollectMemoryChains(const FrameGraph& fg, const Compiler::Result& rst, std::span<const size_t> candidates);
+}
@@ -36,7 +36,7 @@ public:
 		std::map<size_t, size_t> remain_reader_cnt_map; // resource idx -> reader cnt
 		for (auto pass : *sorted_passes) {
 			// construct writed resources
-			for (auto output : fg.GetPassNodes()[pass].Outputs()) {
+			for (auto output : fg.GetPassNodeOutputs(pass)) {
 				if (crst.moves_dst2src.contains(output))
 					continue;
 
@@ -47,7 +47,7 @@ public:
 			cout << "[Execute]   " << fg.GetPassNodes()[pass].Name() << endl;
 
 			// count down readers
-			for (auto input : fg.GetPassNodes()[pass].Inputs()) {
+			for (auto input : fg.GetPassNodeInputs(pass)) {
 				if (!remain_reader_cnt_map.contains(input))
 					remain_reader_cnt_map.emplace(input, crst.rsrcinfos[input].readers.size());
 				auto& cnt = remain_reader_cnt_map[input];
@@ -6,35 +6,13 @@
 using namespace std;
 using namespace Ubpa;
 
-struct RsrcType {
-	size_t size;
-	bool operator==(const RsrcType& rhs) const noexcept {
-		return size == rhs.size;
-	}
-};
-
-namespace std {
-	template<>
-	struct hash<RsrcType> {
-		bool operator()(const RsrcType& type) const noexcept {
-			return hash<size_t>{}(type.size);
-		}
-	};
-}
-
 struct Resource {
 	float* buffer;
+	UFG::TransientPool::Handle handle;
 };
 
 class ResourceMngr {
 public:
-	~ResourceMngr() {
-		for (const auto& [type, rsrcs] : pool) {
-			for (auto rsrc : rsrcs)
-				delete[] rsrc.buffer;
-		}
-	}
-
 	void Construct(std::string_view name, size_t rsrcNodeIndex) {
 		Resource rsrc;
 
@@ -43,17 +21,13 @@ public:
 			cout << "[Construct] Import  | " << name << " @" << rsrc.buffer << endl;
 		}
 		else {
-			auto type = temporals[rsrcNodeIndex];
-			auto& typefrees = pool[type];
-			if (typefrees.empty()) {
-				rsrc.buffer = new float[type.size];
+			size_t miss_num = pool.GetStats().miss_num;
+			rsrc.handle = pool.Acquire(temporals[rsrcNodeIndex]);
+			rsrc.buffer = static_cast<float*>(pool.GetData(rsrc.handle));
+			if (pool.GetStats().miss_num != miss_num)
 				cout << "[Construct] Create  | " << name << " @" << rsrc.buffer << endl;
-			}
-			else {
-				rsrc = typefrees.back();
-				typefrees.pop_back();
+			else
 				cout << "[Construct] Reuse   | " << name << " @" << rsrc.buffer << endl;
-			}
 		}
 		actives[rsrcNodeIndex] = rsrc;
 	}
@@ -69,7 +43,7 @@ public:
 	void Destruct(std::string_view name, size_t rsrcNodeIndex) {
 		auto rsrc = actives[rsrcNodeIndex];
 		if (!IsImported(rsrcNodeIndex)) {
-			pool[temporals[rsrcNodeIndex]].push_back(actives[rsrcNodeIndex]);
+			pool.Release(rsrc.handle);
 			cout << "[Destruct]  Recycle | " << name << " @" << rsrc.buffer << endl;
 		}
 		else
@@ -83,8 +57,8 @@ public:
 		return *this;
 	}
 
-	ResourceMngr& RegisterTemporalRsrc(size_t rsrcNodeIndex, RsrcType type) {
-		temporals[rsrcNodeIndex] = type;
+	ResourceMngr& RegisterTemporalRsrc(size_t rsrcNodeIndex, size_t size) {
+		temporals[rsrcNodeIndex] = { size * sizeof(float), alignof(float) };
 		return *this;
 	}
 
@@ -92,13 +66,16 @@ public:
 		return importeds.find(rsrcNodeIndex) != importeds.end();
 	}
 
+	void NextFrame() { pool.NextFrame(); }
+
+	const UFG::TransientPool& GetPool() const noexcept { return pool; }
+
 private:
 	// rsrcNodeIndex -> rsrc
 	std::unordered_map<size_t, Resource> importeds;
-	// rsrcNodeIndex -> type
-	std::unordered_map<size_t, RsrcType> temporals;
-	// type -> vector<rsrc>
-	std::unordered_map<RsrcType, std::vector<Resource>> pool;
+	// rsrcNodeIndex -> desc
+	std::unordered_map<size_t, UFG::TransientPool::Desc> temporals;
+	UFG::TransientPool pool;
 	// rsrcNodeIndex -> rsrc
 	std::unordered_map<size_t, Resource> actives;
 };
@@ -122,7 +99,7 @@ public:
 
 		for (auto pass : crst.sorted_passes) {
 			// construct writed resources
-			for (auto output : fg.GetPassNodes()[pass].Outputs()) {
+			for (auto output : fg.GetPassNodeOutputs(pass)) {
 				if (crst.moves_dst2src.contains(output))
 					continue;
 
@@ -146,13 +123,13 @@ public:
 					rsrcMngr.Destruct(fg.GetResourceNodes()[rsrc].Name(), rsrc);
 			};
 
-			for (auto input : fg.GetPassNodes()[pass].Inputs()) {
+			for (auto input : fg.GetPassNodeInputs(pass)) {
 				auto& cnt = remain_user_cnt_map[input];
 				--cnt;
 				if (cnt == 0)
 					destruct_or_move_resouce(input);
 			}
-			for (auto output : fg.GetPassNodes()[pass].Outputs()) {
+			for (auto output : fg.GetPassNodeOutputs(pass)) {
 				auto& cnt = remain_user_cnt_map[output];
 				--cnt;
 				if (cnt == 0)
@@ -252,18 +229,25 @@ int main() {
 	ResourceMngr rsrcMngr;
 
 	rsrcMngr
-		.RegisterImportedRsrc(finaltarget, { nullptr })
+		.RegisterImportedRsrc(finaltarget, { nullptr, {} })
 
-		.RegisterTemporalRsrc(depthbuffer, { 32 })
-		.RegisterTemporalRsrc(depthbuffer2, { 32 })
-		.RegisterTemporalRsrc(gbuffer1, { 32 })
-		.RegisterTemporalRsrc(gbuffer2, { 32 })
-		.RegisterTemporalRsrc(gbuffer3, { 32 })
-		.RegisterTemporalRsrc(debugoutput, { 32 })
-		.RegisterTemporalRsrc(lightingbuffer, { 32 });
+		.RegisterTemporalRsrc(depthbuffer, 32)
+		.RegisterTemporalRsrc(depthbuffer2, 32)
+		.RegisterTemporalRsrc(gbuffer1, 32)
+		.RegisterTemporalRsrc(gbuffer2, 32)
+		.RegisterTemporalRsrc(gbuffer3, 32)
+		.RegisterTemporalRsrc(debugoutput, 32)
+		.RegisterTemporalRsrc(lightingbuffer, 32);
 
 	Executor executor;
-	executor.Execute(fg, crst, rsrcMngr);
+	for (size_t frame = 0; frame < 2; frame++) {
+		cout << "------------------------[frame " << frame << "]------------------------" << endl;
+		[[maybe_unused]] size_t miss_num = rsrcMngr.GetPool().GetStats().miss_num;
+		executor.Execute(fg, crst, rsrcMngr);
+		rsrcMngr.NextFrame();
+		// the allocations are kept across frames
+		assert(frame == 0 || rsrcMngr.GetPool().GetStats().miss_num == miss_num);
+	}
 
 	return 0;
 }
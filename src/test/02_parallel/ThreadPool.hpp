@@ -1,9 +1,11 @@
 #pragma once
 
 #include <mutex>
+#include <atomic>
 #include <thread>
 #include <deque>
 #include <functional>
+#include <condition_variable>
 
 class ThreadPool {
 public:
@@ -12,15 +14,21 @@ public:
 		Shutdown();
 	}
 
-	void Init(size_t n) {
+	// onIdle(true) before a worker waits for work, onIdle(false) after it wakes up
+	void Init(size_t n, std::function<void(bool)> onIdle = {}) {
 		for (size_t i = 0; i < n; i++) {
-			workers.emplace_back([this]() {
+			workers.emplace_back([this, onIdle]() {
 				while (!shutdown) {
 					std::function<void()> work;
 					{ // get work
 						std::unique_lock<std::mutex> lk(m);
-						if (works.empty())
+						if (works.empty()) {
+							if (onIdle)
+								onIdle(true);
 							cv.wait(lk);
+							if (onIdle)
+								onIdle(false);
+						}
 						if (works.empty())
 							break;
 						work = std::move(works.back());
@@ -33,7 +41,10 @@ public:
 	}
 
 	void Shutdown() {
-		shutdown = true;
+		{
+			std::lock_guard<std::mutex> lk(m);
+			shutdown = true;
+		}
 		cv.notify_all();
 		for (auto& worker : workers)
 			worker.join();
@@ -54,5 +65,5 @@ private:
 	std::mutex m;
 	std::deque<std::function<void()>> works;
 	std::vector<std::thread> workers;
-	bool shutdown{ false };
+	std::atomic<bool> shutdown{ false };
 };
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <cassert>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <thread>
 
@@ -36,7 +38,10 @@ struct Resource {
 
 	State state;
 	Buffer buffer;
+	UFG::ConcurrentPool::Handle handle;
 
+	// guards GPURsrcStateMap and the log, passes run on worker threads
+	inline static std::mutex GPUMutex;
 	inline static std::unordered_map<Buffer, State> GPURsrcStateMap;
 };
 
@@ -44,11 +49,13 @@ class CommandList {
 public:
 	void Execute(std::string_view str) {
 		commandbuffer.push_back([str]() {
+			std::lock_guard<std::mutex> lk(Resource::GPUMutex);
 			std::cout << "[Execute   ] " << str << endl;
 		});
 	};
 	void Transition(std::string_view name, float* buffer, Resource::State src, Resource::State dst) {
 		commandbuffer.push_back([=]() {
+			std::lock_guard<std::mutex> lk(Resource::GPUMutex);
 			assert(Resource::GPURsrcStateMap.at(buffer) == src);
 			std::cout << "[Transition] " << name << " " << src << " -> " << dst << " @" << buffer << endl;
 			Resource::GPURsrcStateMap.at(buffer) = dst;
@@ -64,83 +71,71 @@ private:
 	std::vector<std::function<void()>> commandbuffer;
 };
 
+// Construct, Move and Destruct are called by the worker threads,
+// the resource states are tracked by UFG::StateTracker
 class ResourceMngr {
 public:
-	~ResourceMngr() {
-		for (const auto& [type, rsrcs] : pool) {
-			for (auto rsrc : rsrcs)
-				delete[] rsrc.buffer;
-		}
-	}
+	ResourceMngr(size_t rsrcNum) : actives(rsrcNum) {}
 
-	void Construct(std::string_view name, size_t rsrcNodeIndex) {
-		Resource rsrc;
+	// return the state of the constructed resource
+	Resource::State Construct(std::string_view name, size_t rsrcNodeIndex) {
+		Active active;
 
 		if (IsImported(rsrcNodeIndex)) {
-			rsrc = importeds[rsrcNodeIndex];
-			cout << "[Construct ] Import  | " << name << " @" << "(" << rsrc.state << ")" << rsrc.buffer << endl;
+			active.rsrc = importeds.at(rsrcNodeIndex);
+			active.imported = true;
+			std::lock_guard<std::mutex> lk(Resource::GPUMutex);
+			cout << "[Construct ] Import  | " << name << " @" << "(" << active.rsrc.state << ")" << active.rsrc.buffer << endl;
 		}
 		else {
-			auto type = temporals[rsrcNodeIndex];
-			auto& typefrees = pool[type];
-			if (typefrees.empty()) {
-				rsrc.state = Resource::state_common;
-				rsrc.buffer = new float[type.size];
-				cout << "[Construct ] Create  | " << name << " @" << "(" << rsrc.state << ")" << rsrc.buffer << endl;
-				Resource::GPURsrcStateMap[rsrc.buffer] = rsrc.state;
-			}
-			else {
-				rsrc = typefrees.back();
-				typefrees.pop_back();
-				cout << "[Construct ] Reuse   | " << name << " @" << "(" << rsrc.state << ")" << rsrc.buffer << endl;
-			}
+			// a recycled buffer is returned in the common state
+			auto type = temporals.at(rsrcNodeIndex);
+			active.rsrc.state = Resource::state_common;
+			active.rsrc.handle = pool.Acquire({ type.size * sizeof(float), alignof(float) });
+			active.rsrc.buffer = static_cast<float*>(pool.GetData(active.rsrc.handle));
+			std::lock_guard<std::mutex> lk(Resource::GPUMutex);
+			auto [target, created] = Resource::GPURsrcStateMap.try_emplace(active.rsrc.buffer, active.rsrc.state);
+			assert(target->second == Resource::state_common);
+			cout << "[Construct ] " << (created ? "Create " : "Reuse  ") << " | " << name << " @"
+				<< "(" << active.rsrc.state << ")" << active.rsrc.buffer << endl;
 		}
-		actives[rsrcNodeIndex] = rsrc;
+		actives[rsrcNodeIndex] = active;
+		return active.rsrc.state;
 	}
 
 	void Move(std::string_view dstName, size_t dstRsrcNodeIndex,
 		std::string_view srcName, size_t srcRsrcNodeIndex)
 	{
-		auto rsrc = actives[srcRsrcNodeIndex];
-		cout << "[Move      ] " << dstName << " <- " << srcName << " @" << "(" << rsrc.state << ")" << rsrc.buffer << endl;
 		actives[dstRsrcNodeIndex] = actives[srcRsrcNodeIndex];
-		actives.erase(srcRsrcNodeIndex);
-		if (importeds.contains(srcRsrcNodeIndex))
-			importeds[dstRsrcNodeIndex] = importeds[srcRsrcNodeIndex];
-		else
-			temporals[dstRsrcNodeIndex] = temporals[srcRsrcNodeIndex];
+		actives[srcRsrcNodeIndex] = {};
+		const auto& rsrc = actives[dstRsrcNodeIndex].rsrc;
+		std::lock_guard<std::mutex> lk(Resource::GPUMutex);
+		cout << "[Move      ] " << dstName << " <- " << srcName << " @" << rsrc.buffer << endl;
 	}
 
-	void Destruct(CommandList& cmdlist, std::string_view name, size_t rsrcNodeIndex) {
-		auto rsrc = actives[rsrcNodeIndex];
-		if (!IsImported(rsrcNodeIndex)) {
-			pool[temporals[rsrcNodeIndex]].push_back(rsrc); // TODO
-			cout << "[Destruct  ] Recycle | " << name << " @" << "(" << rsrc.state << ")" << rsrc.buffer << endl;
+	// transition back to the import state or the common state of the recycled buffers
+	void Destruct(CommandList& cmdlist, UFG::StateTracker& tracker, std::string_view name, size_t rsrcNodeIndex) {
+		auto active = actives[rsrcNodeIndex];
+		Resource::State state = tracker.GetState(rsrcNodeIndex);
+		if (state != active.rsrc.state)
+			cmdlist.Transition(name, active.rsrc.buffer, state, active.rsrc.state);
+		cmdlist.Run();
+
+		if (!active.imported) {
+			pool.Release(active.rsrc.handle);
+			std::lock_guard<std::mutex> lk(Resource::GPUMutex);
+			cout << "[Destruct  ] Recycle | " << name << " @" << active.rsrc.buffer << endl;
 		}
 		else {
-			cmdlist.Transition(name, rsrc.buffer, rsrc.state, importeds.at(rsrcNodeIndex).state);
-			cout << "[Destruct  ] Import  | " << name << " @" << "(" << rsrc.state << ")" << rsrc.buffer << endl;
+			std::lock_guard<std::mutex> lk(Resource::GPUMutex);
+			cout << "[Destruct  ] Import  | " << name << " @" << active.rsrc.buffer << endl;
 		}
 
-		actives.erase(rsrcNodeIndex);
+		actives[rsrcNodeIndex] = {};
 	}
 
-	std::map<size_t, Resource::Buffer> Request(CommandList& cmdlist, const UFG::FrameGraph& fg, size_t passNodeIndex) {
-		std::map<size_t, Resource::Buffer> rst;
-		auto target = passRsrcStateMap.find(passNodeIndex);
-		if (target == passRsrcStateMap.end())
-			return rst;
-		const auto& rsrcStateMap = target->second;
-
-		for (const auto& [rsrc, state] : rsrcStateMap) {
-			auto& active_rsrc = actives.at(rsrc);
-			if (active_rsrc.state != state) {
-				cmdlist.Transition(fg.GetResourceNodes()[rsrc].Name(), active_rsrc.buffer, active_rsrc.state, state);
-				active_rsrc.state = state;
-			}
-			rst.emplace(rsrc, active_rsrc.buffer);
-		}
-		return rst;
+	Resource::Buffer GetBuffer(size_t rsrcNodeIndex) const noexcept {
+		return actives[rsrcNodeIndex].rsrc.buffer;
 	}
 
 	ResourceMngr& RegisterImportedRsrc(size_t rsrcNodeIndex, Resource rsrc) {
@@ -154,109 +149,158 @@ public:
 		return *this;
 	}
 
-	ResourceMngr& RegisterPassRsrcState(size_t passNodeIndex, size_t rsrcNodeIndex, Resource::State state) {
-		passRsrcStateMap[passNodeIndex][rsrcNodeIndex] = state;
-		return *this;
-	}
-
 	bool IsImported(size_t rsrcNodeIndex) const noexcept {
 		return importeds.find(rsrcNodeIndex) != importeds.end();
 	}
 
 private:
+	struct Active {
+		Resource rsrc{}; // rsrc.state : the state at construction
+		bool imported{ false };
+	};
+
 	// rsrcNodeIndex -> rsrc
 	std::unordered_map<size_t, Resource> importeds;
 	// rsrcNodeIndex -> type
 	std::unordered_map<size_t, RsrcType> temporals;
-	// type -> vector<rsrc>
-	std::unordered_map<RsrcType, std::vector<Resource>> pool;
-	// rsrcNodeIndex -> rsrc
-	std::unordered_map<size_t, Resource> actives;
-	// passNodeIndex -> rsrcNodeIndex -> rsrc state
-	std::unordered_map<size_t, std::unordered_map<size_t, Resource::State>> passRsrcStateMap;
+	UFG::ConcurrentPool pool;
+	// rsrcNodeIndex -> active rsrc, a move passes it to the destination
+	std::vector<Active> actives;
 };
 
+// a pass is submitted once its predecessors in the pass graph are completed,
+// the worker completing the last user of a resource releases or moves it at once
+// the events are recorded with UFG_TRACE when UFG_ENABLE_TRACE is defined
 class Executor {
+#ifdef UFG_ENABLE_TRACE
+	UFG::TraceRecorder recorder;
+#endif
 	ThreadPool threadpool;
 
 public:
 	Executor() {
+#ifdef UFG_ENABLE_TRACE
+		threadpool.Init(std::thread::hardware_concurrency(), [this](bool idle) {
+			if (idle)
+				UFG_TRACE(recorder, IdleBegin);
+			else
+				UFG_TRACE(recorder, IdleEnd);
+		});
+#else
 		threadpool.Init(std::thread::hardware_concurrency());
+#endif
 	}
 
+#ifdef UFG_ENABLE_TRACE
+	const UFG::TraceRecorder& GetTraceRecorder() const noexcept { return recorder; }
+#endif
+
 	virtual void Execute(
 		const UFG::FrameGraph& fg,
 		const UFG::Compiler::Result& crst,
-		ResourceMngr& rsrcMngr)
+		ResourceMngr& rsrcMngr,
+		UFG::UserCounter& userCounter,
+		UFG::StateTracker& tracker)
 	{
-		const size_t cmdlist_num = fg.GetPassNodes().size();
-		struct CommandListInfo {
-			std::mutex mutex_done;
-			bool done{ false };
-			CommandList cmdlist;
-			std::condition_variable cv;
+		userCounter.Reset();
+
+		auto transition_recorder = [&](CommandList& cmdlist) {
+			return [&](size_t rsrc, UFG::StateTracker::State before, UFG::StateTracker::State after) {
+				UFG_TRACE(recorder, Transition, rsrc, before, after);
+				cmdlist.Transition(fg.GetResourceNodes()[rsrc].Name(), rsrcMngr.GetBuffer(rsrc),
+					static_cast<Resource::State>(before), static_cast<Resource::State>(after));
+			};
 		};
-		std::vector<CommandListInfo> cmdlistInfos(cmdlist_num);
-		
-		if (auto target = crst.pass2info.find(static_cast<size_t>(-1)); target != crst.pass2info.end()) {
-			CommandList init_cmdlist;
-			const auto& info = target->second;
-			for (auto rsrc : info.construct_resources)
-				rsrcMngr.Construct(fg.GetResourceNodes()[rsrc].Name(), rsrc);
-			for (auto rsrc : info.move_resources) {
+
+		auto construct_resource = [&](CommandList& cmdlist, size_t rsrc) {
+			UFG_TRACE(recorder, Construct, rsrc);
+			auto state = rsrcMngr.Construct(fg.GetResourceNodes()[rsrc].Name(), rsrc);
+			tracker.Construct(rsrc, static_cast<UFG::StateTracker::State>(state), transition_recorder(cmdlist));
+		};
+
+		auto destruct_resource = [&](CommandList& cmdlist, size_t rsrc) {
+			UFG_TRACE(recorder, Destruct, rsrc);
+			rsrcMngr.Destruct(cmdlist, tracker, fg.GetResourceNodes()[rsrc].Name(), rsrc);
+		};
+
+		auto destruct_or_move_resource = [&](CommandList& cmdlist, size_t rsrc) {
+			if (auto target = crst.moves_src2dst.find(rsrc); target != crst.moves_src2dst.end()) {
 				auto src = rsrc;
-				auto dst = crst.moves_src2dst.at(src);
+				auto dst = target->second;
 				auto src_name = fg.GetResourceNodes()[src].Name();
 				auto dst_name = fg.GetResourceNodes()[dst].Name();
+				UFG_TRACE(recorder, Move, dst, src);
 				rsrcMngr.Move(dst_name, dst, src_name, src);
+				tracker.Move(dst, src, transition_recorder(cmdlist));
 			}
+			else
+				destruct_resource(cmdlist, rsrc);
+		};
+
+		if (auto target = crst.pass2info.find(static_cast<size_t>(-1)); target != crst.pass2info.end()) {
+			CommandList init_cmdlist;
+			const auto& info = target->second;
+			for (auto rsrc : info.construct_resources)
+				construct_resource(init_cmdlist, rsrc);
+			for (auto rsrc : info.move_resources)
+				destruct_or_move_resource(init_cmdlist, rsrc);
 			for (auto rsrc : info.destruct_resources)
-				rsrcMngr.Destruct(init_cmdlist, fg.GetResourceNodes()[rsrc].Name(), rsrc);
+				destruct_resource(init_cmdlist, rsrc);
 			init_cmdlist.Run();
 		}
 
-		for (auto pass : crst.sorted_passes) {
-			auto& cmdlistInfo = cmdlistInfos[crst.pass2order[pass]];
-			const auto& passInfo = crst.pass2info.at(pass);
-			for (auto rsrc : passInfo.construct_resources)
-				rsrcMngr.Construct(fg.GetResourceNodes()[rsrc].Name(), rsrc);
-
-			auto passRsrcs = rsrcMngr.Request(cmdlistInfo.cmdlist, fg, pass);
-			
-			threadpool.Summit([passRsrcs, cmdlist = &cmdlistInfo.cmdlist, name = fg.GetPassNodes()[pass].Name()]() {
-				cmdlist->Execute(name);
-				// record commands ...
-			});
-
-			for(auto rsrc : passInfo.move_resources) {
-				auto src = rsrc;
-				auto dst = crst.moves_src2dst.at(src);
-				auto src_name = fg.GetResourceNodes()[src].Name();
-				auto dst_name = fg.GetResourceNodes()[dst].Name();
-				rsrcMngr.Move(dst_name, dst, src_name, src);
-			}
-			for (auto rsrc : passInfo.destruct_resources)
-				rsrcMngr.Destruct(cmdlistInfo.cmdlist, fg.GetResourceNodes()[rsrc].Name(), rsrc);
-
-			{ // commit
-				std::lock_guard<std::mutex> lk(cmdlistInfo.mutex_done);
-				cmdlistInfo.done = true;
-				cmdlistInfo.cv.notify_one();
-			}
+		// passNodeIndex -> remain predecessor num
+		std::vector<std::atomic<size_t>> remain_pred_cnts(fg.GetPassNodes().size());
+		for (const auto& [pass, adj] : crst.passgraph.adjList) {
+			for (auto next : adj)
+				remain_pred_cnts[next].fetch_add(1, std::memory_order_relaxed);
 		}
 
-		size_t cnt = 0;
-		while (cnt < cmdlist_num) {
-			std::unique_lock<std::mutex> lk(cmdlistInfos[cnt].mutex_done);
-			if (!cmdlistInfos[cnt].done)
-				cmdlistInfos[cnt].cv.wait(lk);
-			CommandList cmdlist = std::move(cmdlistInfos[cnt].cmdlist);
-			lk.unlock();
+		std::mutex mutex_done;
+		std::condition_variable cv_done;
+		size_t remain_pass_cnt = crst.sorted_passes.size();
+
+		std::function<void(size_t)> run = [&](size_t pass) {
+			CommandList cmdlist;
+			for (auto rsrc : crst.pass2info.at(pass).construct_resources)
+				construct_resource(cmdlist, rsrc);
+
+			tracker.Acquire(pass, transition_recorder(cmdlist));
+			UFG_TRACE(recorder, PassBegin, pass);
+			cmdlist.Execute(fg.GetPassNodes()[pass].Name());
+			// record commands ...
+			cmdlist.Run();
+			UFG_TRACE(recorder, PassEnd, pass);
+			tracker.Release(pass, transition_recorder(cmdlist));
+			cmdlist.Run();
 
+			// release the resources at once
+			userCounter.Complete(pass, [&](size_t rsrc) { destruct_or_move_resource(cmdlist, rsrc); });
 			cmdlist.Run();
 
-			++cnt;
+			if (auto target = crst.passgraph.adjList.find(pass); target != crst.passgraph.adjList.end()) {
+				for (auto next : target->second) {
+					if (remain_pred_cnts[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+						threadpool.Summit([&run, next]() { run(next); });
+				}
+			}
+
+			std::lock_guard<std::mutex> lk(mutex_done);
+			if (--remain_pass_cnt == 0)
+				cv_done.notify_one();
+		};
+
+		// collect the sources before submitting, the counters change once a pass is submitted
+		std::vector<size_t> sources;
+		for (auto pass : crst.sorted_passes) {
+			if (remain_pred_cnts[pass].load(std::memory_order_relaxed) == 0)
+				sources.push_back(pass);
 		}
+		for (auto pass : sources)
+			threadpool.Summit([&run, pass]() { run(pass); });
+
+		std::unique_lock<std::mutex> lk(mutex_done);
+		cv_done.wait(lk, [&]() { return remain_pass_cnt == 0; });
 	}
 };
 
@@ -367,12 +411,101 @@ int main() {
 
 	cout << "------------------------[Execute]------------------------" << endl;
 
+	UFG::StateTracker tracker(fg, crst);
+	tracker
+		.Require(depth_pass, depthbuffer, Resource::state_write)
+
+		.Require(depth_pass0, depthbuffer, Resource::state_read)
+		.Require(depth_pass1, depthbuffer, Resource::state_read)
+		.Require(depth_pass2, depthbuffer, Resource::state_read)
+		.Require(depth_pass3, depthbuffer, Resource::state_read)
+
+		.Require(gbuffer_pass, depthbuffer2, Resource::state_write)
+		.Require(gbuffer_pass, gbuffer1, Resource::state_write)
+		.Require(gbuffer_pass, gbuffer2, Resource::state_write)
+		.Require(gbuffer_pass, gbuffer3, Resource::state_write)
+
+		.Require(lighting_pass, depthbuffer2, Resource::state_read)
+		.Require(lighting_pass, gbuffer1, Resource::state_read)
+		.Require(lighting_pass, gbuffer2, Resource::state_read)
+		.Require(lighting_pass, gbuffer3, Resource::state_read)
+		.Require(lighting_pass, lightingbuffer, Resource::state_write)
+
+		.Require(post_pass, lightingbuffer, Resource::state_read)
+		.Require(post_pass, finaltarget, Resource::state_write)
+
+		.Require(present_pass, finaltarget, Resource::state_read)
+
+		.Require(debug_pass, gbuffer3, Resource::state_read)
+		.Require(debug_pass, debugoutput, Resource::state_write)
+		;
+	tracker.Build();
+
+	// the concurrent readers of a resource can't require different states
+	try {
+		UFG::StateTracker conflict(fg, crst);
+		conflict
+			.Require(lighting_pass, gbuffer3, Resource::state_read)
+			.Require(debug_pass, gbuffer3, Resource::state_common)
+			.Build();
+		assert(false);
+	}
+	catch (const std::logic_error& e) {
+		cout << "[StateTracker] " << e.what() << endl;
+	}
+
+	cout << "------------------------[copy]------------------------" << endl;
+	{
+		// as in test 03 : TAA reads the previous buffer, then the copy pass copies the accumulation into it
+		constexpr UFG::StateTracker::State state_copy_dst = 4;
+
+		UFG::FrameGraph fg_copy("test 02 parallel copy");
+		size_t prev = fg_copy.RegisterResourceNode("Prev Acc Buffer");
+		size_t acc = fg_copy.RegisterResourceNode("Acc Buffer");
+		size_t target = fg_copy.RegisterResourceNode("Target");
+		size_t taa_pass = fg_copy.RegisterGeneralPassNode("TAA", { prev }, { acc });
+		size_t copy_pass = fg_copy.RegisterCopyPassNode({ acc }, { prev });
+		size_t post_pass = fg_copy.RegisterGeneralPassNode("Post", { acc }, { target });
+		auto crst_copy = compiler.Compile(fg_copy);
+		assert(crst_copy.rsrcinfos[prev].copy_in == copy_pass);
+		assert(crst_copy.pass2order[taa_pass] < crst_copy.pass2order[copy_pass]);
+
+		UFG::StateTracker copy_tracker(fg_copy, crst_copy);
+		copy_tracker
+			.Require(taa_pass, prev, Resource::state_read)
+			.Require(taa_pass, acc, Resource::state_write)
+			.Require(copy_pass, acc, Resource::state_read)
+			.Require(copy_pass, prev, state_copy_dst)
+			.Require(post_pass, acc, Resource::state_read)
+			.Require(post_pass, target, Resource::state_write)
+			.Build();
+		// the readers of the copy target run before the copy, in the state set at its construction
+		assert(copy_tracker.GetEntryState(prev) == Resource::state_read);
+
+		size_t transition_num = 0;
+		auto transition = [&](size_t, UFG::StateTracker::State, UFG::StateTracker::State) { transition_num++; };
+		for (auto pass : crst_copy.sorted_passes) {
+			for (auto rsrc : crst_copy.pass2info.at(pass).construct_resources)
+				copy_tracker.Construct(rsrc, Resource::state_common, transition);
+			copy_tracker.Acquire(pass, transition);
+			for ([[maybe_unused]] auto input : fg_copy.GetPassNodeInputs(pass))
+				assert(copy_tracker.GetState(input) == Resource::state_read);
+			if (pass == copy_pass)
+				assert(copy_tracker.GetState(prev) == state_copy_dst);
+			copy_tracker.Release(pass, transition);
+		}
+		// prev : common -> read -> copy dst, acc : common -> write -> read, target : common -> write
+		assert(transition_num == 5);
+		cout << transition_num << " transitions" << endl;
+	}
+
 	Executor executor;
+	UFG::UserCounter userCounter(fg, crst);
 	for (size_t i = 0; i < 2; i++) {
-		ResourceMngr rsrcMngr;
+		ResourceMngr rsrcMngr(fg.GetResourceNodes().size());
 
 		rsrcMngr
-			.RegisterImportedRsrc(finaltarget, { Resource::state_common, nullptr })
+			.RegisterImportedRsrc(finaltarget, { Resource::state_common, nullptr, {} })
 
 			.RegisterTemporalRsrc(depthbuffer, { 32 })
 			.RegisterTemporalRsrc(depthbuffer2, { 32 })
@@ -382,35 +515,15 @@ int main() {
 			.RegisterTemporalRsrc(debugoutput, { 32 })
 			.RegisterTemporalRsrc(lightingbuffer, { 32 })
 
-			.RegisterPassRsrcState(depth_pass, depthbuffer, Resource::state_write)
-
-			.RegisterPassRsrcState(depth_pass0, depthbuffer, Resource::state_read)
-			.RegisterPassRsrcState(depth_pass1, depthbuffer, Resource::state_read)
-			.RegisterPassRsrcState(depth_pass2, depthbuffer, Resource::state_read)
-			.RegisterPassRsrcState(depth_pass3, depthbuffer, Resource::state_read)
-
-			.RegisterPassRsrcState(gbuffer_pass, depthbuffer2, Resource::state_write)
-			.RegisterPassRsrcState(gbuffer_pass, gbuffer1, Resource::state_write)
-			.RegisterPassRsrcState(gbuffer_pass, gbuffer2, Resource::state_write)
-			.RegisterPassRsrcState(gbuffer_pass, gbuffer3, Resource::state_write)
-
-			.RegisterPassRsrcState(lighting_pass, depthbuffer2, Resource::state_read)
-			.RegisterPassRsrcState(lighting_pass, gbuffer1, Resource::state_read)
-			.RegisterPassRsrcState(lighting_pass, gbuffer2, Resource::state_read)
-			.RegisterPassRsrcState(lighting_pass, gbuffer3, Resource::state_read)
-			.RegisterPassRsrcState(lighting_pass, lightingbuffer, Resource::state_write)
-
-			.RegisterPassRsrcState(post_pass, lightingbuffer, Resource::state_read)
-			.RegisterPassRsrcState(post_pass, finaltarget, Resource::state_write)
-
-			.RegisterPassRsrcState(present_pass, finaltarget, Resource::state_read)
-
-			.RegisterPassRsrcState(debug_pass, gbuffer3, Resource::state_read)
-			.RegisterPassRsrcState(debug_pass, debugoutput, Resource::state_write)
 			;
 
-		executor.Execute(fg, crst, rsrcMngr);
+		executor.Execute(fg, crst, rsrcMngr, userCounter, tracker);
 	}
 
+#ifdef UFG_ENABLE_TRACE
+	cout << "------------------------[Trace]------------------------" << endl;
+	cout << executor.GetTraceRecorder().ToChromeTrace(fg) << endl;
+#endif
+
 	return 0;
 }
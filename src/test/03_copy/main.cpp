@@ -145,13 +145,13 @@ public:
 					rsrcMngr.Destruct(fg.GetResourceNodes()[rsrc].Name(), rsrc);
 			};
 
-			for (auto input : fg.GetPassNodes()[pass].Inputs()) {
+			for (auto input : fg.GetPassNodeInputs(pass)) {
 				auto& cnt = remain_user_cnt_map[input];
 				--cnt;
 				if (cnt == 0)
 					destruct_or_move_resouce(input);
 			}
-			for (auto output : fg.GetPassNodes()[pass].Outputs()) {
+			for (auto output : fg.GetPassNodeOutputs(pass)) {
 				auto& cnt = remain_user_cnt_map[output];
 				--cnt;
 				if (cnt == 0)
@@ -0,0 +1,148 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+
+using namespace std;
+using namespace Ubpa;
+
+class Executor {
+public:
+	virtual void Execute(
+		const UFG::FrameGraph& fg,
+		const UFG::Compiler::Result& crst)
+	{
+		for (auto pass : crst.sorted_passes) {
+			const auto& passInfo = crst.pass2info.at(pass);
+			for (auto rsrc : passInfo.construct_resources)
+				cout << "[Construct] " << fg.GetResourceNodes()[rsrc].Name() << endl;
+
+			cout << "[Execute]   " << fg.GetPassNodes()[pass].Name() << endl;
+
+			for (auto rsrc : passInfo.move_resources) {
+				cout << "[Move]      " << fg.GetResourceNodes()[crst.moves_src2dst.at(rsrc)].Name()
+					<< " <- " << fg.GetResourceNodes()[rsrc].Name() << endl;
+			}
+			for (auto rsrc : passInfo.destruct_resources)
+				cout << "[Destruct]  " << fg.GetResourceNodes()[rsrc].Name() << endl;
+		}
+	}
+};
+
+int main() {
+	UFG::FrameGraph fg("test 04 variant");
+
+	constexpr size_t bit_ssao = 0;
+	constexpr size_t bit_debug = 1;
+
+	size_t depthbuffer = fg.RegisterResourceNode("Depth Buffer");
+	size_t gbuffer = fg.RegisterResourceNode("GBuffer");
+	size_t aobuffer = fg.RegisterResourceNode("AO Buffer");
+	size_t lightingbuffer = fg.RegisterResourceNode("Lighting Buffer");
+	size_t finaltarget = fg.RegisterResourceNode("Final Target");
+	size_t debugoutput = fg.RegisterResourceNode("Debug Output");
+
+	fg.RegisterGeneralPassNode(
+		"Depth pass",
+		{},
+		{ depthbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"GBuffer pass",
+		{ depthbuffer },
+		{ gbuffer }
+	);
+	size_t ssao_pass = fg.RegisterGeneralPassNode(
+		"SSAO",
+		{ depthbuffer },
+		{ aobuffer }
+	);
+	size_t lighting_pass = fg.RegisterGeneralPassNode(
+		"Lighting",
+		{ gbuffer },
+		{ lightingbuffer }
+	);
+	size_t ao_lighting_pass = fg.RegisterGeneralPassNode(
+		"AO Lighting",
+		{ gbuffer,aobuffer },
+		{ lightingbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"Post",
+		{ lightingbuffer },
+		{ finaltarget }
+	);
+	size_t debug_pass = fg.RegisterGeneralPassNode(
+		"Debug View",
+		{ gbuffer },
+		{ debugoutput }
+	);
+
+	fg.SetPassNodeCondition(ssao_pass, bit_ssao);
+	fg.SetPassNodeCondition(ao_lighting_pass, bit_ssao);
+	fg.SetPassNodeCondition(debug_pass, bit_debug);
+
+	UFG::Compiler compiler;
+
+	// "Lighting" and "AO Lighting" both write the lighting buffer, so the full graph is invalid
+	[[maybe_unused]] bool failed = false;
+	try {
+		compiler.Compile(fg);
+	}
+	catch (const std::logic_error&) {
+		failed = true;
+	}
+	assert(failed);
+
+	// the variant mask has 64 bits
+	[[maybe_unused]] bool out_of_range = false;
+	try {
+		fg.SetPassNodeCondition(lighting_pass, 64);
+	}
+	catch (const std::out_of_range&) {
+		out_of_range = true;
+	}
+	assert(out_of_range && !fg.GetPassNodes()[lighting_pass].IsConditional());
+
+	// "Lighting" runs iff SSAO is off, it is expressed by the complementary bit
+	constexpr size_t bit_no_ssao = 2;
+	fg.SetPassNodeCondition(lighting_pass, bit_no_ssao);
+
+	constexpr uint64_t ssao = uint64_t{ 1 } << bit_ssao;
+	constexpr uint64_t no_ssao = uint64_t{ 1 } << bit_no_ssao;
+	constexpr uint64_t debug = uint64_t{ 1 } << bit_debug;
+
+	const uint64_t masks[] = {
+		no_ssao,
+		ssao,
+		no_ssao | debug,
+		ssao | debug,
+		ssao | debug | (uint64_t{ 1 } << 10), // unused bit, same variant as ssao | debug
+	};
+
+	auto table = compiler.CompileVariants(fg, masks);
+	assert(table.condition_mask == (ssao | no_ssao | debug));
+	assert(table.results.size() == 4);
+
+	for (auto mask : masks) {
+		const auto& crst = table.Select(mask);
+
+		cout << "------------------------[variant " << mask << "]------------------------" << endl;
+		cout << crst.passgraph.ToGraphvizGraph(fg).Dump() << endl;
+
+		[[maybe_unused]] bool has_ssao = mask & ssao;
+		[[maybe_unused]] bool has_debug = mask & debug;
+
+		assert(crst.sorted_passes.size() == size_t{ 4 } + has_ssao + has_debug);
+		assert((crst.pass2order[ssao_pass] != static_cast<size_t>(-1)) == has_ssao);
+		assert((crst.pass2order[debug_pass] != static_cast<size_t>(-1)) == has_debug);
+		assert((crst.rsrcinfos[aobuffer].first != static_cast<size_t>(-1)) == has_ssao);
+		assert((crst.rsrcinfos[debugoutput].first != static_cast<size_t>(-1)) == has_debug);
+
+		Executor executor;
+		executor.Execute(fg, crst);
+	}
+
+	return 0;
+}
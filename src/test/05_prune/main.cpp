@@ -0,0 +1,153 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+
+using namespace std;
+using namespace Ubpa;
+
+class Executor {
+public:
+	virtual void Execute(
+		const UFG::FrameGraph& fg,
+		const UFG::Compiler::Result& crst)
+	{
+		for (auto pass : crst.sorted_passes) {
+			const auto& passInfo = crst.pass2info.at(pass);
+			for (auto rsrc : passInfo.construct_resources)
+				cout << "[Construct] " << fg.GetResourceNodes()[rsrc].Name() << endl;
+
+			cout << "[Execute]   " << fg.GetPassNodes()[pass].Name() << endl;
+
+			for (auto rsrc : passInfo.move_resources) {
+				cout << "[Move]      " << fg.GetResourceNodes()[crst.moves_src2dst.at(rsrc)].Name()
+					<< " <- " << fg.GetResourceNodes()[rsrc].Name() << endl;
+			}
+			for (auto rsrc : passInfo.destruct_resources)
+				cout << "[Destruct]  " << fg.GetResourceNodes()[rsrc].Name() << endl;
+		}
+	}
+};
+
+int main() {
+	UFG::FrameGraph fg("test 05 prune");
+
+	size_t depthbuffer = fg.RegisterResourceNode("Depth Buffer");
+	size_t depthbuffer2 = fg.RegisterResourceNode("Depth Buffer 2");
+	size_t gbuffer1 = fg.RegisterResourceNode("GBuffer1");
+	size_t gbuffer2 = fg.RegisterResourceNode("GBuffer2");
+	size_t gbuffer3 = fg.RegisterResourceNode("GBuffer3");
+	size_t lightingbuffer = fg.RegisterResourceNode("Lighting Buffer");
+	size_t finaltarget = fg.RegisterResourceNode("Final Target");
+	size_t debugoutput = fg.RegisterResourceNode("Debug Output");
+
+	[[maybe_unused]] size_t depth_pass = fg.RegisterGeneralPassNode(
+		"Depth pass",
+		{},
+		{ depthbuffer }
+	);
+	fg.RegisterMoveNode(depthbuffer2, depthbuffer);
+	[[maybe_unused]] size_t gbuffer_pass = fg.RegisterGeneralPassNode(
+		"GBuffer pass",
+		{ },
+		{ depthbuffer2,gbuffer1,gbuffer2,gbuffer3 }
+	);
+	[[maybe_unused]] size_t lighting_pass = fg.RegisterGeneralPassNode(
+		"Lighting",
+		{ depthbuffer2,gbuffer1,gbuffer2,gbuffer3 },
+		{ lightingbuffer }
+	);
+	[[maybe_unused]] size_t post_pass = fg.RegisterGeneralPassNode(
+		"Post",
+		{ lightingbuffer },
+		{ finaltarget }
+	);
+	[[maybe_unused]] size_t present_pass = fg.RegisterGeneralPassNode(
+		"Present",
+		{ finaltarget },
+		{ }
+	);
+	[[maybe_unused]] size_t debug_pass = fg.RegisterGeneralPassNode(
+		"Debug View",
+		{ gbuffer3 },
+		{ debugoutput }
+	);
+
+	UFG::Compiler compiler;
+
+	auto crst = compiler.Compile(fg);
+
+	cout << "------------------------[full]------------------------" << endl;
+	Executor executor;
+	executor.Execute(fg, crst);
+
+	{
+		cout << "------------------------[Debug Output]------------------------" << endl;
+		const size_t requested[] = { debugoutput };
+		auto prst = compiler.Prune(fg, crst, requested);
+		executor.Execute(fg, prst);
+
+		// the depth buffer is moved into the gbuffer pass's output
+		assert(prst.sorted_passes.size() == 3);
+		assert(prst.pass2order[depth_pass] < prst.pass2order[gbuffer_pass]);
+		assert(prst.pass2order[gbuffer_pass] < prst.pass2order[debug_pass]);
+		assert(prst.pass2order[lighting_pass] == static_cast<size_t>(-1));
+		assert(prst.moves_src2dst.at(depthbuffer) == depthbuffer2);
+		assert(prst.rsrcinfos[gbuffer3].readers.size() == 1);
+		assert(prst.rsrcinfos[lightingbuffer].first == static_cast<size_t>(-1));
+	}
+
+	{
+		cout << "------------------------[Final Target]------------------------" << endl;
+		const size_t requested[] = { finaltarget };
+		auto prst = compiler.Prune(fg, crst, requested);
+		executor.Execute(fg, prst);
+
+		assert(prst.sorted_passes.size() == 4);
+		assert(prst.pass2order[post_pass] == 3);
+		assert(prst.pass2order[present_pass] == static_cast<size_t>(-1));
+		assert(prst.pass2order[debug_pass] == static_cast<size_t>(-1));
+		assert(prst.rsrcinfos[finaltarget].last == 3);
+		assert(prst.rsrcinfos[gbuffer3].last == prst.pass2order[lighting_pass]);
+	}
+
+	{
+		cout << "------------------------[reuse]------------------------" << endl;
+		// pruning into a previous pruned result gives the same result as a fresh one
+		[[maybe_unused]] auto same = [](const UFG::Compiler::Result& lhs, const UFG::Compiler::Result& rhs) {
+			if (lhs.rsrcinfos.size() != rhs.rsrcinfos.size() || lhs.pass2info.size() != rhs.pass2info.size())
+				return false;
+			for (size_t i = 0; i < lhs.rsrcinfos.size(); i++) {
+				const auto& l = lhs.rsrcinfos[i];
+				const auto& r = rhs.rsrcinfos[i];
+				if (l.first != r.first || l.last != r.last || l.writer != r.writer || l.copy_in != r.copy_in || l.readers != r.readers)
+					return false;
+			}
+			for (const auto& [pass, info] : lhs.pass2info) {
+				const auto& other = rhs.pass2info.at(pass);
+				if (info.construct_resources != other.construct_resources || info.destruct_resources != other.destruct_resources
+					|| info.move_resources != other.move_resources)
+					return false;
+			}
+			return lhs.sorted_passes == rhs.sorted_passes && lhs.pass2order == rhs.pass2order
+				&& lhs.passgraph.adjList == rhs.passgraph.adjList
+				&& lhs.moves_src2dst == rhs.moves_src2dst && lhs.copys_src2dst == rhs.copys_src2dst
+				&& lhs.memory.peak_bytes == rhs.memory.peak_bytes && lhs.memory.level_num == rhs.memory.level_num;
+		};
+
+		const size_t final_requested[] = { finaltarget };
+		const size_t debug_requested[] = { debugoutput };
+		UFG::Compiler::Result prst;
+		for (size_t i = 0; i < 2; i++) {
+			compiler.Prune(fg, crst, final_requested, {}, prst);
+			[[maybe_unused]] auto final_fresh = compiler.Prune(fg, crst, final_requested);
+			assert(same(prst, final_fresh));
+			compiler.Prune(fg, crst, debug_requested, {}, prst);
+			[[maybe_unused]] auto debug_fresh = compiler.Prune(fg, crst, debug_requested);
+			assert(same(prst, debug_fresh));
+		}
+		executor.Execute(fg, prst);
+	}
+
+	return 0;
+}
@@ -0,0 +1,168 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <unordered_set>
+
+using namespace std;
+using namespace Ubpa;
+
+class ResourceMngr {
+public:
+	void Construct(const UFG::FrameGraph& fg, const UFG::IncrementalCache& cache, size_t rsrcNodeIdx) {
+		if (cache.IsPersistent(rsrcNodeIdx)) {
+			if (persistents.contains(rsrcNodeIdx))
+				return;
+			persistents.insert(rsrcNodeIdx);
+			cout << "[Construct] Persistent | " << fg.GetResourceNodes()[rsrcNodeIdx].Name() << endl;
+		}
+		else
+			cout << "[Construct] " << fg.GetResourceNodes()[rsrcNodeIdx].Name() << endl;
+	}
+
+	void Destruct(const UFG::FrameGraph& fg, const UFG::IncrementalCache& cache, size_t rsrcNodeIdx) {
+		if (cache.IsPersistent(rsrcNodeIdx))
+			return;
+		cout << "[Destruct]  " << fg.GetResourceNodes()[rsrcNodeIdx].Name() << endl;
+	}
+
+	void Move(const UFG::FrameGraph& fg, size_t dstRsrcNodeIdx, size_t srcRsrcNodeIdx) {
+		cout << "[Move]      " << fg.GetResourceNodes()[dstRsrcNodeIdx].Name()
+			<< " <- " << fg.GetResourceNodes()[srcRsrcNodeIdx].Name() << endl;
+	}
+
+private:
+	std::unordered_set<size_t> persistents;
+};
+
+class Executor {
+public:
+	// return the number of executed passes
+	virtual size_t Execute(
+		const UFG::FrameGraph& fg,
+		const UFG::Compiler::Result& crst,
+		UFG::IncrementalCache& cache,
+		ResourceMngr& rsrcMngr)
+	{
+		size_t cnt = 0;
+		cache.NextFrame();
+		for (auto pass : crst.sorted_passes) {
+			const auto& passInfo = crst.pass2info.at(pass);
+			for (auto rsrc : passInfo.construct_resources)
+				rsrcMngr.Construct(fg, cache, rsrc);
+
+			if (cache.IsSkipped(pass))
+				cout << "[Skip]      " << fg.GetPassNodes()[pass].Name() << endl;
+			else {
+				cout << "[Execute]   " << fg.GetPassNodes()[pass].Name() << endl;
+				++cnt;
+			}
+
+			for (auto rsrc : passInfo.move_resources)
+				rsrcMngr.Move(fg, crst.moves_src2dst.at(rsrc), rsrc);
+			for (auto rsrc : passInfo.destruct_resources)
+				rsrcMngr.Destruct(fg, cache, rsrc);
+		}
+		return cnt;
+	}
+};
+
+int main() {
+	UFG::FrameGraph fg("test 06 incremental");
+
+	size_t envmap = fg.RegisterResourceNode("Environment Map");
+	size_t prefiltered = fg.RegisterResourceNode("Prefiltered Map");
+	size_t irradiance = fg.RegisterResourceNode("Irradiance Map");
+	size_t gbuffer = fg.RegisterResourceNode("GBuffer");
+	size_t lightingbuffer = fg.RegisterResourceNode("Lighting Buffer");
+	size_t finaltarget = fg.RegisterResourceNode("Final Target");
+
+	size_t prefilter_pass = fg.RegisterGeneralPassNode(
+		"Prefilter",
+		{ envmap },
+		{ prefiltered }
+	);
+	size_t irradiance_pass = fg.RegisterGeneralPassNode(
+		"Irradiance",
+		{ prefiltered },
+		{ irradiance }
+	);
+	[[maybe_unused]] size_t gbuffer_pass = fg.RegisterGeneralPassNode(
+		"GBuffer pass",
+		{ },
+		{ gbuffer }
+	);
+	size_t lighting_pass = fg.RegisterGeneralPassNode(
+		"Lighting",
+		{ gbuffer,prefiltered,irradiance },
+		{ lightingbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"Post",
+		{ lightingbuffer },
+		{ finaltarget }
+	);
+
+	fg.SetPassNodePure(prefilter_pass);
+	fg.SetPassNodePure(irradiance_pass);
+	// pure, but the gbuffer changes every frame
+	fg.SetPassNodePure(lighting_pass);
+
+	UFG::Compiler compiler;
+	auto crst = compiler.Compile(fg);
+
+	UFG::IncrementalCache cache(fg, crst);
+	assert(cache.IsPersistent(prefiltered));
+	assert(cache.IsPersistent(irradiance));
+	assert(!cache.IsPersistent(gbuffer));
+
+	ResourceMngr rsrcMngr;
+	Executor executor;
+
+	const uint64_t envmap_versions[] = { 0, 0, 0, 1, 1 };
+	[[maybe_unused]] const size_t executed_nums[] = { 5, 3, 3, 5, 3 };
+	for (size_t frame = 0; frame < std::size(envmap_versions); frame++) {
+		cout << "------------------------[frame " << frame << "]------------------------" << endl;
+		cache.SetVersion(envmap, envmap_versions[frame]);
+		[[maybe_unused]] size_t cnt = executor.Execute(fg, crst, cache, rsrcMngr);
+		assert(cnt == executed_nums[frame]);
+		assert(cache.IsSkipped(irradiance_pass) == (executed_nums[frame] == 3));
+		assert(!cache.IsSkipped(gbuffer_pass));
+		assert(!cache.IsSkipped(lighting_pass));
+	}
+
+	cache.Invalidate();
+	cache.SetVersion(envmap, 1);
+	[[maybe_unused]] size_t invalidated_cnt = executor.Execute(fg, crst, cache, rsrcMngr);
+	assert(invalidated_cnt == 5);
+
+	// as in test 03, "Blur" reads the copy of the last frame, before the copy pass
+	UFG::FrameGraph fg_copy("test 06 incremental copy");
+	size_t sky = fg_copy.RegisterResourceNode("Sky");
+	size_t skylut = fg_copy.RegisterResourceNode("Sky LUT");
+	size_t prevskylut = fg_copy.RegisterResourceNode("Prev Sky LUT");
+	size_t blurred = fg_copy.RegisterResourceNode("Blurred Sky LUT");
+	size_t skylut_pass = fg_copy.RegisterGeneralPassNode("Sky LUT pass", { sky }, { skylut });
+	fg_copy.RegisterCopyPassNode({ skylut }, { prevskylut });
+	size_t blur_pass = fg_copy.RegisterGeneralPassNode("Blur", { prevskylut }, { blurred });
+	fg_copy.SetPassNodePure(skylut_pass);
+	fg_copy.SetPassNodePure(blur_pass);
+
+	auto crst_copy = compiler.Compile(fg_copy);
+	UFG::IncrementalCache cache_copy(fg_copy, crst_copy);
+	assert(cache_copy.IsPersistent(prevskylut));
+	ResourceMngr rsrcMngr_copy;
+
+	// the copy target takes the version of the sky LUT, "Blur" is skipped once it is stable
+	const uint64_t sky_versions[] = { 0, 0, 0, 1, 1, 1 };
+	[[maybe_unused]] const size_t executed_copy_nums[] = { 3, 2, 1, 2, 2, 1 };
+	for (size_t frame = 0; frame < std::size(sky_versions); frame++) {
+		cout << "------------------------[copy frame " << frame << "]------------------------" << endl;
+		cache_copy.SetVersion(sky, sky_versions[frame]);
+		[[maybe_unused]] size_t cnt = executor.Execute(fg_copy, crst_copy, cache_copy, rsrcMngr_copy);
+		assert(cnt == executed_copy_nums[frame]);
+		assert(cache_copy.GetVersion(prevskylut) == cache_copy.GetVersion(skylut));
+	}
+
+	return 0;
+}
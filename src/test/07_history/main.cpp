@@ -0,0 +1,197 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+
+using namespace std;
+using namespace Ubpa;
+
+struct RsrcType {
+	size_t size;
+	bool operator==(const RsrcType& rhs) const noexcept {
+		return size == rhs.size;
+	}
+};
+
+namespace std {
+	template<>
+	struct hash<RsrcType> {
+		size_t operator()(const RsrcType& type) const noexcept {
+			return hash<size_t>{}(type.size);
+		}
+	};
+}
+
+struct Resource {
+	float* buffer;
+};
+
+class ResourceMngr {
+public:
+	ResourceMngr(const UFG::FrameGraph& fg, const UFG::HistoryRing& ring) : fg{ fg }, ring{ ring } {}
+
+	~ResourceMngr() {
+		for (const auto& [type, rsrcs] : pool) {
+			for (auto rsrc : rsrcs)
+				delete[] rsrc.buffer;
+		}
+		for (const auto& [rsrcNodeIndex, rsrcs] : histories) {
+			for (auto rsrc : rsrcs)
+				delete[] rsrc.buffer;
+		}
+	}
+
+	void Construct(size_t rsrcNodeIndex) {
+		Resource rsrc;
+		auto name = fg.GetResourceNodes()[rsrcNodeIndex].Name();
+
+		if (fg.GetResourceNodes()[rsrcNodeIndex].IsPersistent()) {
+			const auto& versions = histories.at(ring.GetHistoryNodeIndex(rsrcNodeIndex));
+			rsrc = versions[ring.GetSlot(rsrcNodeIndex)];
+			cout << "[Construct] History | " << name << " @" << rsrc.buffer
+				<< (ring.IsValid(rsrcNodeIndex) ? "" : " (invalid)") << endl;
+		}
+		else {
+			auto type = temporals[rsrcNodeIndex];
+			auto& typefrees = pool[type];
+			if (typefrees.empty()) {
+				rsrc.buffer = new float[type.size];
+				cout << "[Construct] Create  | " << name << " @" << rsrc.buffer << endl;
+			}
+			else {
+				rsrc = typefrees.back();
+				typefrees.pop_back();
+				cout << "[Construct] Reuse   | " << name << " @" << rsrc.buffer << endl;
+			}
+		}
+		actives[rsrcNodeIndex] = rsrc;
+	}
+
+	void Destruct(size_t rsrcNodeIndex) {
+		auto rsrc = actives[rsrcNodeIndex];
+		auto name = fg.GetResourceNodes()[rsrcNodeIndex].Name();
+		if (!fg.GetResourceNodes()[rsrcNodeIndex].IsPersistent()) {
+			pool[temporals[rsrcNodeIndex]].push_back(actives[rsrcNodeIndex]);
+			cout << "[Destruct]  Recycle | " << name << " @" << rsrc.buffer << endl;
+		}
+		else
+			cout << "[Destruct]  History | " << name << " @" << rsrc.buffer << endl;
+
+		actives.erase(rsrcNodeIndex);
+	}
+
+	ResourceMngr& RegisterHistoryRsrc(size_t rsrcNodeIndex, RsrcType type) {
+		auto& versions = histories[rsrcNodeIndex];
+		for (size_t i = 0; i < fg.GetResourceNodes()[rsrcNodeIndex].GetHistoryVersions(); i++)
+			versions.push_back({ new float[type.size] });
+		return *this;
+	}
+
+	ResourceMngr& RegisterTemporalRsrc(size_t rsrcNodeIndex, RsrcType type) {
+		temporals[rsrcNodeIndex] = type;
+		return *this;
+	}
+
+	float* GetBuffer(size_t rsrcNodeIndex) const { return actives.at(rsrcNodeIndex).buffer; }
+
+private:
+	const UFG::FrameGraph& fg;
+	const UFG::HistoryRing& ring;
+
+	// history rsrcNodeIndex -> versions
+	std::unordered_map<size_t, std::vector<Resource>> histories;
+	// rsrcNodeIndex -> type
+	std::unordered_map<size_t, RsrcType> temporals;
+	// type -> vector<rsrc>
+	std::unordered_map<RsrcType, std::vector<Resource>> pool;
+	// rsrcNodeIndex -> rsrc
+	std::unordered_map<size_t, Resource> actives;
+};
+
+int main() {
+	UFG::FrameGraph fg("test 07 history");
+
+	size_t gbuffer = fg.RegisterResourceNode("GBuffer");
+	size_t lightingbuffer = fg.RegisterResourceNode("Lighting Buffer");
+	size_t acclightingbuffer = fg.RegisterHistoryResourceNode("Acc Lighting Buffer", 2);
+	size_t prevacclightingbuffer = fg.RegisterPreviousResourceNode(acclightingbuffer);
+	size_t finaltarget = fg.RegisterResourceNode("Final Target");
+
+	fg.RegisterGeneralPassNode(
+		"GBuffer pass",
+		{ },
+		{ gbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"Lighting",
+		{ gbuffer },
+		{ lightingbuffer }
+	);
+	size_t taa_pass = fg.RegisterGeneralPassNode(
+		"TAA",
+		{ prevacclightingbuffer,lightingbuffer },
+		{ acclightingbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"Post",
+		{ acclightingbuffer },
+		{ finaltarget }
+	);
+
+	assert(fg.GetResourceNodeIndex("Acc Lighting Buffer#Prev1") == prevacclightingbuffer);
+
+	UFG::Compiler compiler;
+	auto crst = compiler.Compile(fg);
+
+	UFG::HistoryRing ring(fg);
+	ResourceMngr rsrcMngr(fg, ring);
+	rsrcMngr
+		.RegisterHistoryRsrc(acclightingbuffer, { 32 })
+
+		.RegisterTemporalRsrc(gbuffer, { 32 })
+		.RegisterTemporalRsrc(lightingbuffer, { 32 })
+		.RegisterTemporalRsrc(finaltarget, { 32 });
+
+	[[maybe_unused]] float* last_acc = nullptr;
+	for (size_t frame = 0; frame < 4; frame++) {
+		cout << "------------------------[frame " << frame << "]------------------------" << endl;
+		for (auto pass : crst.sorted_passes) {
+			const auto& passInfo = crst.pass2info.at(pass);
+			for (auto rsrc : passInfo.construct_resources)
+				rsrcMngr.Construct(rsrc);
+
+			cout << "[Execute]   " << fg.GetPassNodes()[pass].Name() << endl;
+
+			if (pass == taa_pass) {
+				[[maybe_unused]] float* prev = rsrcMngr.GetBuffer(prevacclightingbuffer);
+				float* acc = rsrcMngr.GetBuffer(acclightingbuffer);
+				assert(prev != acc);
+				assert(ring.IsValid(prevacclightingbuffer) == (frame > 0));
+				if (frame > 0)
+					assert(prev == last_acc); // previous frame's output without copy
+				last_acc = acc;
+			}
+
+			for (auto rsrc : passInfo.destruct_resources)
+				rsrcMngr.Destruct(rsrc);
+		}
+		ring.NextFrame();
+	}
+
+	// previous nodes are read-only
+	fg.RegisterGeneralPassNode(
+		"Invalid",
+		{ },
+		{ prevacclightingbuffer }
+	);
+	[[maybe_unused]] bool failed = false;
+	try {
+		compiler.Compile(fg);
+	}
+	catch (const std::logic_error&) {
+		failed = true;
+	}
+	assert(failed);
+
+	return 0;
+}
@@ -0,0 +1,307 @@
+#include <UFG/UFG.hpp>
+
+#include "../02_parallel/ThreadPool.hpp"
+
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+
+using namespace std;
+using namespace Ubpa;
+
+// frames in flight : a pass of frame f starts when its passes of frame f and its waits of the previous frames complete
+class PipelinedExecutor {
+	ThreadPool threadpool;
+
+public:
+	PipelinedExecutor(size_t threadNum) {
+		threadpool.Init(threadNum);
+	}
+
+	void Execute(
+		const UFG::FrameGraph& fg,
+		const UFG::Compiler::Result& crst,
+		const UFG::FramePipeline& pipeline,
+		size_t frameNum,
+		std::function<void(size_t frame, size_t pass)> work)
+	{
+		const size_t passNum = crst.sorted_passes.size();
+
+		std::vector<size_t> indegrees(fg.GetPassNodes().size(), 0);
+		for (const auto& [parent, children] : crst.passgraph.adjList) {
+			for (auto child : children)
+				++indegrees[child];
+		}
+
+		struct FrameState {
+			size_t frame{ static_cast<size_t>(-1) };
+			std::vector<size_t> remain;
+			std::vector<bool> done;
+			size_t doneCnt{ 0 };
+		};
+		std::vector<FrameState> states(pipeline.GetFramesInFlight());
+
+		std::mutex m;
+		std::condition_variable cv;
+
+		auto is_done = [&](size_t frame, size_t pass) {
+			const auto& state = states[pipeline.GetSlot(frame)];
+			return state.frame != frame || state.done[pass]; // the slot is reused after the frame completes
+		};
+
+		std::function<void(size_t, size_t)> submit = [&](size_t frame, size_t pass) {
+			threadpool.Summit([&, frame, pass]() {
+				work(frame, pass);
+
+				std::vector<std::pair<size_t, size_t>> readys;
+				{
+					std::lock_guard<std::mutex> lk(m);
+					auto& state = states[pipeline.GetSlot(frame)];
+					state.done[pass] = true;
+					++state.doneCnt;
+					for (auto child : crst.passgraph.adjList.at(pass)) {
+						if (--state.remain[child] == 0)
+							readys.emplace_back(frame, child);
+					}
+					for (const auto& dependent : pipeline.GetDependents(pass)) {
+						size_t next = frame + dependent.distance;
+						auto& next_state = states[pipeline.GetSlot(next)];
+						if (next_state.frame == next && --next_state.remain[dependent.pass] == 0)
+							readys.emplace_back(next, dependent.pass);
+					}
+					if (state.doneCnt == passNum)
+						cv.notify_all();
+				}
+				for (const auto& [ready_frame, ready_pass] : readys)
+					submit(ready_frame, ready_pass);
+			});
+		};
+
+		for (size_t frame = 0; frame < frameNum; frame++) {
+			std::vector<size_t> readys;
+			{
+				std::unique_lock<std::mutex> lk(m);
+				auto& state = states[pipeline.GetSlot(frame)];
+				cv.wait(lk, [&]() { return state.frame == static_cast<size_t>(-1) || state.doneCnt == passNum; });
+
+				state.frame = frame;
+				state.remain = indegrees;
+				state.done.assign(indegrees.size(), false);
+				state.doneCnt = 0;
+				for (auto pass : crst.sorted_passes) {
+					for (const auto& wait : pipeline.GetWaits(pass)) {
+						if (wait.distance <= frame && !is_done(frame - wait.distance, wait.pass))
+							++state.remain[pass];
+					}
+				}
+				for (auto pass : crst.sorted_passes) {
+					if (state.remain[pass] == 0)
+						readys.push_back(pass);
+				}
+			}
+			for (auto pass : readys)
+				submit(frame, pass);
+		}
+
+		std::unique_lock<std::mutex> lk(m);
+		cv.wait(lk, [&]() {
+			for (const auto& state : states) {
+				if (state.frame != static_cast<size_t>(-1) && state.doneCnt != passNum)
+					return false;
+			}
+			return true;
+		});
+	}
+};
+
+// physical resources shared by the frames, a write must be exclusive
+class HazardChecker {
+public:
+	HazardChecker(size_t n) : states(n) {}
+
+	void BeginRead(size_t i) {
+		[[maybe_unused]] int s = states[i].fetch_add(1);
+		assert(s >= 0);
+	}
+	void EndRead(size_t i) { states[i].fetch_sub(1); }
+	void BeginWrite(size_t i) {
+		int expected = 0;
+		[[maybe_unused]] bool success = states[i].compare_exchange_strong(expected, -1);
+		assert(success);
+	}
+	void EndWrite(size_t i) { states[i].store(0); }
+
+private:
+	std::vector<std::atomic<int>> states; // -1 : write, n : n readers
+};
+
+int main() {
+	UFG::FrameGraph fg("test 08 pipeline");
+
+	size_t constants = fg.RegisterResourceNode("Scene Constants");
+	size_t gbuffer = fg.RegisterResourceNode("GBuffer");
+	size_t lightingbuffer = fg.RegisterResourceNode("Lighting Buffer");
+	size_t acclightingbuffer = fg.RegisterHistoryResourceNode("Acc Lighting Buffer", 2);
+	size_t prevacclightingbuffer = fg.RegisterPreviousResourceNode(acclightingbuffer);
+	size_t finaltarget = fg.RegisterResourceNode("Final Target");
+
+	fg.RegisterGeneralPassNode(
+		"Update",
+		{ },
+		{ constants }
+	);
+	fg.RegisterGeneralPassNode(
+		"GBuffer pass",
+		{ constants },
+		{ gbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"Lighting",
+		{ constants,gbuffer },
+		{ lightingbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"TAA",
+		{ prevacclightingbuffer,lightingbuffer },
+		{ acclightingbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"Post",
+		{ acclightingbuffer },
+		{ finaltarget }
+	);
+	fg.RegisterGeneralPassNode(
+		"Present",
+		{ finaltarget },
+		{ }
+	);
+
+	UFG::Compiler compiler;
+	auto crst = compiler.Compile(fg);
+
+	const size_t importeds[] = { constants, finaltarget };
+	constexpr size_t frameNum = 16;
+
+	{ // serial
+		UFG::FramePipeline pipeline(fg, crst, importeds, 1);
+		for (size_t pass = 0; pass < fg.GetPassNodes().size(); pass++)
+			assert(pipeline.GetWaits(pass).empty());
+	}
+
+	for (size_t framesInFlight = 1; framesInFlight <= 3; framesInFlight++) {
+		UFG::FramePipeline pipeline(fg, crst, importeds, framesInFlight);
+
+		cout << "------------------------[" << framesInFlight << " frames in flight]------------------------" << endl;
+		for (size_t pass = 0; pass < fg.GetPassNodes().size(); pass++) {
+			for (const auto& wait : pipeline.GetWaits(pass)) {
+				cout << fg.GetPassNodes()[pass].Name() << " waits " << fg.GetPassNodes()[wait.pass].Name()
+					<< " of frame -" << wait.distance << endl;
+			}
+		}
+
+		// physical resources : constants, final target, 2 versions of acc lighting buffer
+		HazardChecker checker(4);
+		auto physical = [&](size_t frame, size_t rsrc) -> size_t {
+			if (rsrc == constants)
+				return 0;
+			if (rsrc == finaltarget)
+				return 1;
+			size_t versions = fg.GetResourceNodes()[acclightingbuffer].GetHistoryVersions();
+			size_t age = rsrc == prevacclightingbuffer ? 1 : 0;
+			return 2 + (frame + versions - age) % versions;
+		};
+		auto is_shared = [&](size_t rsrc) {
+			return rsrc == constants || rsrc == finaltarget || fg.GetResourceNodes()[rsrc].IsPersistent();
+		};
+
+		std::mutex m;
+		std::vector<size_t> running(frameNum, 0);
+		size_t max_overlap = 0;
+
+		PipelinedExecutor executor(4);
+		executor.Execute(fg, crst, pipeline, frameNum, [&](size_t frame, size_t pass) {
+			const auto& passNode = fg.GetPassNodes()[pass];
+			{
+				std::lock_guard<std::mutex> lk(m);
+				++running[frame];
+				size_t overlap = 0;
+				for (auto cnt : running)
+					overlap += cnt > 0 ? 1 : 0;
+				max_overlap = std::max(max_overlap, overlap);
+			}
+
+			for (auto input : fg.GetPassNodeInputs(passNode)) {
+				if (is_shared(input))
+					checker.BeginRead(physical(frame, input));
+			}
+			for (auto output : fg.GetPassNodeOutputs(passNode)) {
+				if (is_shared(output))
+					checker.BeginWrite(physical(frame, output));
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			for (auto input : fg.GetPassNodeInputs(passNode)) {
+				if (is_shared(input))
+					checker.EndRead(physical(frame, input));
+			}
+			for (auto output : fg.GetPassNodeOutputs(passNode)) {
+				if (is_shared(output))
+					checker.EndWrite(physical(frame, output));
+			}
+
+			{
+				std::lock_guard<std::mutex> lk(m);
+				--running[frame];
+			}
+		});
+
+		cout << "max overlapped frames: " << max_overlap << endl;
+		assert(max_overlap <= framesInFlight);
+	}
+
+	cout << "------------------------[imported move]------------------------" << endl;
+	{
+		// a move into or out of an imported resource writes the physical resource
+		UFG::FrameGraph movefg("imported move");
+		size_t scene = movefg.RegisterResourceNode("Scene");
+		size_t backbuffer = movefg.RegisterResourceNode("Backbuffer");
+		size_t swapchain = movefg.RegisterResourceNode("Swapchain");
+		size_t target = movefg.RegisterResourceNode("Target");
+		[[maybe_unused]] size_t render = movefg.RegisterGeneralPassNode("Render", {}, { scene });
+		[[maybe_unused]] size_t present = movefg.RegisterGeneralPassNode("Present", { backbuffer }, {});
+		[[maybe_unused]] size_t clear = movefg.RegisterGeneralPassNode("Clear", { swapchain }, {});
+		[[maybe_unused]] size_t blit = movefg.RegisterGeneralPassNode("Blit", { target }, {});
+		movefg.RegisterMoveNode(backbuffer, scene);
+		movefg.RegisterMoveNode(target, swapchain);
+
+		auto movecrst = compiler.Compile(movefg);
+		const size_t moveimporteds[] = { backbuffer, swapchain };
+		UFG::FramePipeline pipeline(movefg, movecrst, moveimporteds, 2);
+
+		[[maybe_unused]] auto waits_for = [&](size_t pass, size_t waited_pass) {
+			for (const auto& wait : pipeline.GetWaits(pass)) {
+				if (wait.pass == waited_pass && wait.distance == 1)
+					return true;
+			}
+			return false;
+		};
+		// the render of frame f moves into the backbuffer presented by frame f - 1
+		assert(waits_for(render, present));
+		// the blit of frame f - 1 reads the swapchain moved out, before the clear of frame f
+		assert(waits_for(clear, blit));
+		for (size_t pass = 0; pass < movefg.GetPassNodes().size(); pass++) {
+			for (const auto& wait : pipeline.GetWaits(pass)) {
+				cout << movefg.GetPassNodes()[pass].Name() << " waits " << movefg.GetPassNodes()[wait.pass].Name()
+					<< " of frame -" << wait.distance << endl;
+			}
+		}
+	}
+
+	return 0;
+}
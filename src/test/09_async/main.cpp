@@ -0,0 +1,134 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+
+using namespace std;
+using namespace Ubpa;
+
+UFG::FrameGraph BuildFrameGraph(size_t postNum) {
+	UFG::FrameGraph fg("test 09 async");
+
+	size_t gbuffer = fg.RegisterResourceNode("GBuffer");
+	size_t lightingbuffer = fg.RegisterResourceNode("Lighting Buffer");
+
+	fg.RegisterGeneralPassNode(
+		"GBuffer pass",
+		{ },
+		{ gbuffer }
+	);
+	fg.RegisterGeneralPassNode(
+		"Lighting",
+		{ gbuffer },
+		{ lightingbuffer }
+	);
+
+	size_t input = lightingbuffer;
+	for (size_t i = 0; i < postNum; i++) {
+		size_t output = fg.RegisterResourceNode("Post Buffer " + std::to_string(i));
+		fg.RegisterGeneralPassNode(
+			"Post " + std::to_string(i),
+			{ input },
+			{ output }
+		);
+		input = output;
+	}
+
+	fg.RegisterGeneralPassNode(
+		"Present",
+		{ input },
+		{ }
+	);
+
+	return fg;
+}
+
+int main() {
+	UFG::AsyncCompiler compiler;
+	assert(compiler.Acquire() == nullptr);
+
+	// frame loop with the last good result
+	auto frame = [&]() {
+		auto snapshot = compiler.Acquire();
+		if (!snapshot) {
+			cout << "[Frame]   no result" << endl;
+			return;
+		}
+		cout << "[Frame]   generation " << snapshot->generation << " :";
+		for (auto pass : snapshot->result.sorted_passes)
+			cout << " " << snapshot->fg.GetPassNodes()[pass].Name() << ",";
+		cout << endl;
+	};
+
+	size_t callbackCnt = 0;
+	auto future = compiler.Submit(BuildFrameGraph(1), [&](const auto&) {
+		++callbackCnt;
+	});
+	frame();
+	auto snapshot = future.get();
+	assert(snapshot && snapshot == compiler.Acquire());
+	assert(snapshot->result.sorted_passes.size() == 4);
+	assert(callbackCnt == 1);
+	frame();
+
+	// burst of edits, only the last one must be published
+	std::vector<UFG::AsyncCompiler::Future> futures;
+	for (size_t i = 2; i < 10; i++)
+		futures.push_back(compiler.Submit(BuildFrameGraph(i)));
+	for (auto& f : futures)
+		f.wait();
+	snapshot = futures.back().get();
+	assert(snapshot && snapshot == compiler.Acquire());
+	assert(snapshot->result.sorted_passes.size() == 3 + 9);
+	for (size_t i = 0; i + 1 < futures.size(); i++) {
+		auto stale = futures[i].get();
+		assert(!stale || stale->generation < snapshot->generation);
+	}
+	frame();
+
+	// failed compilation keeps the last good result
+	auto invalid = BuildFrameGraph(1);
+	invalid.RegisterGeneralPassNode(
+		"Invalid",
+		{ },
+		{ invalid.GetResourceNodeIndex("GBuffer") }
+	);
+	auto failed = compiler.Submit(std::move(invalid));
+	[[maybe_unused]] bool thrown = false;
+	try {
+		failed.get();
+	}
+	catch (const std::logic_error& e) {
+		cout << "[Error]   " << e.what() << endl;
+		thrown = true;
+	}
+	assert(thrown);
+	assert(compiler.Acquire() == snapshot);
+	frame();
+
+	// a throwing callback fails the future, the snapshot is published anyway
+	auto throwing = compiler.Submit(BuildFrameGraph(2), [](const auto&) {
+		throw std::runtime_error("callback failed");
+	});
+	[[maybe_unused]] bool callback_thrown = false;
+	try {
+		throwing.get();
+	}
+	catch (const std::runtime_error& e) {
+		cout << "[Error]   " << e.what() << endl;
+		callback_thrown = true;
+	}
+	assert(callback_thrown);
+	assert(compiler.Acquire() != snapshot && compiler.Acquire()->result.sorted_passes.size() == 5);
+	snapshot = compiler.Acquire();
+	frame();
+
+	// cancel, the compilation may be published before the cancellation
+	auto cancelled = compiler.Submit(BuildFrameGraph(3));
+	compiler.Cancel();
+	auto cancelled_snapshot = cancelled.get();
+	assert(cancelled_snapshot ? compiler.Acquire() == cancelled_snapshot : compiler.Acquire() == snapshot);
+
+	return 0;
+}
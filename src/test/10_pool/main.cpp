@@ -0,0 +1,258 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <random>
+
+using namespace std;
+using namespace Ubpa;
+
+void PrintStats(const UFG::TransientPool& pool) {
+	const auto& stats = pool.GetStats();
+	cout << "[Stats]     frame " << pool.GetFrame()
+		<< " | allocated " << stats.allocated_bytes << " B (" << stats.page_num << " pages, " << stats.block_num << " blocks)"
+		<< " | live " << stats.live_bytes << " B | waste " << stats.waste_bytes << " B"
+		<< " | retired " << stats.retired_bytes << " B | cached " << stats.cached_bytes << " B | free " << stats.free_bytes << " B"
+		<< " | fragmentation " << pool.GetFragmentation() << endl;
+	cout << "            hit " << stats.hit_num << " | miss " << stats.miss_num
+		<< " | aged " << stats.aged_num << " | evicted " << stats.evicted_num
+		<< " | over budget " << stats.over_budget_num << endl;
+	assert(stats.allocated_bytes == stats.live_bytes + stats.waste_bytes + stats.retired_bytes + stats.cached_bytes + stats.free_bytes);
+}
+
+int main() {
+	cout << "------------------------[reuse]------------------------" << endl;
+	{
+		UFG::TransientPool pool;
+		auto a = pool.Acquire({ 1024 });
+		auto b = pool.Acquire({ 1024 });
+		assert(pool.GetData(a) != pool.GetData(b));
+		[[maybe_unused]] void* data_a = pool.GetData(a);
+		pool.Release(a);
+		auto c = pool.Acquire({ 1024 });
+		assert(pool.GetData(c) == data_a);
+		auto d = pool.Acquire({ 1024, 256 });
+		assert(reinterpret_cast<uintptr_t>(pool.GetData(d)) % 256 == 0);
+		pool.Release(b);
+		pool.Release(c);
+		pool.Release(d);
+		PrintStats(pool);
+		assert(pool.GetStats().hit_num == 1);
+		assert(pool.GetStats().miss_num == 3);
+	}
+
+	cout << "------------------------[size class]------------------------" << endl;
+	{
+		UFG::TransientPool pool;
+		// a 32-float buffer hosts a 16-float and a 20-float one
+		auto a = pool.Acquire({ 32 * sizeof(float) });
+		[[maybe_unused]] void* data_a = pool.GetData(a);
+		pool.Release(a);
+		auto b = pool.Acquire({ 16 * sizeof(float) });
+		assert(pool.GetData(b) == data_a);
+		pool.Release(b);
+		auto c = pool.Acquire({ 20 * sizeof(float) });
+		assert(pool.GetData(c) == data_a);
+		assert(pool.GetBlockSize(c) == 32 * sizeof(float));
+		pool.Release(c);
+		// but not a 8-float one
+		auto d = pool.Acquire({ 8 * sizeof(float) });
+		assert(pool.GetData(d) != data_a);
+		pool.Release(d);
+		PrintStats(pool);
+
+		UFG::TransientPool pool2({ .class_num_per_octave = 1 });
+		assert(pool2.GetClassSize(1000) == 1024);
+		assert(pool2.GetClassSize(1025) == 2048);
+		assert(pool.GetClassSize(1025) == 1280);
+		assert(pool.GetClassSize(1) == alignof(std::max_align_t));
+	}
+
+	cout << "------------------------[slightly different sizes]------------------------" << endl;
+	{
+		// thousands of slightly different sizes every frame
+		UFG::TransientPool pool;
+		std::mt19937 rng(0);
+		std::uniform_int_distribution<size_t> size_dist(1000, 4000);
+		std::vector<UFG::TransientPool::Handle> handles;
+		for (size_t frame = 0; frame < 16; frame++) {
+			for (size_t i = 0; i < 2000; i++) {
+				handles.push_back(pool.Acquire({ size_dist(rng) }));
+				if (i % 4 == 3) {
+					for (size_t j = 0; j < 3; j++) {
+						pool.Release(handles.back());
+						handles.pop_back();
+					}
+				}
+			}
+			for (auto handle : handles)
+				pool.Release(handle);
+			handles.clear();
+			pool.NextFrame();
+		}
+		PrintStats(pool);
+		[[maybe_unused]] const auto& stats = pool.GetStats();
+		assert(stats.hit_num > 10 * stats.miss_num);
+	}
+
+	cout << "------------------------[coalescing]------------------------" << endl;
+	{
+		UFG::TransientPool pool({ .max_age = 0, .page_size = 4096 });
+		std::vector<UFG::TransientPool::Handle> handles;
+		for (size_t i = 0; i < 8; i++)
+			handles.push_back(pool.Acquire({ 512 }));
+		assert(pool.GetStats().page_num == 1);
+		// release every other block, the free ranges are fragmented
+		for (size_t i = 0; i < 8; i += 2)
+			pool.Release(handles[i]);
+		pool.NextFrame();
+		PrintStats(pool);
+		assert(pool.GetLargestFreeRange() == 512);
+		assert(pool.GetFragmentation() == 0.75);
+		// a large block doesn't fit
+		auto large = pool.Acquire({ 2048 });
+		assert(pool.GetStats().page_num == 2);
+		pool.Release(large);
+		// release the others, the ranges are coalesced and the pages are freed
+		for (size_t i = 1; i < 8; i += 2)
+			pool.Release(handles[i]);
+		pool.NextFrame();
+		PrintStats(pool);
+		assert(pool.GetStats().allocated_bytes == 0);
+	}
+
+	cout << "------------------------[aging]------------------------" << endl;
+	{
+		// the resolution changes every 4 frames, the memory of the old resolution is released
+		UFG::TransientPool pool({ .max_age = 2, .page_size = 16 * 1024 });
+		size_t max_allocated = 0;
+		size_t max_block_num = 0;
+		for (size_t frame = 0; frame < 32; frame++) {
+			size_t size = 1024 * (1 + frame / 4);
+			std::vector<UFG::TransientPool::Handle> handles;
+			for (size_t i = 0; i < 4; i++)
+				handles.push_back(pool.Acquire({ size }));
+			for (auto handle : handles)
+				pool.Release(handle);
+			pool.NextFrame();
+			max_allocated = std::max(max_allocated, pool.GetStats().allocated_bytes);
+			max_block_num = std::max(max_block_num, pool.GetStats().block_num);
+			if (frame % 4 == 3)
+				PrintStats(pool);
+		}
+		// at most the current and the previous resolutions
+		assert(max_block_num <= 4 + 4);
+		assert(max_allocated <= 2 * 4 * 1024 * (8 + 8));
+		assert(pool.GetStats().aged_num > 0);
+	}
+
+	cout << "------------------------[retire]------------------------" << endl;
+	{
+		// 2 frames in flight, the blocks of frame f are reused at frame f + 2
+		constexpr size_t frames_in_flight = 2;
+		UFG::TransientPool pool;
+		std::vector<void*> frame2data;
+		for (size_t frame = 0; frame < 8; frame++) {
+			if (frame >= frames_in_flight)
+				pool.Reclaim(frame - frames_in_flight);
+
+			auto handle = pool.Acquire({ 1024 });
+			frame2data.push_back(pool.GetData(handle));
+			// the previous frame may still use its block
+			assert(frame == 0 || frame2data[frame] != frame2data[frame - 1]);
+			if (frame >= frames_in_flight)
+				assert(frame2data[frame] == frame2data[frame - frames_in_flight]);
+
+			pool.Retire(handle);
+			pool.NextFrame();
+		}
+		PrintStats(pool);
+		assert(pool.GetStats().miss_num == frames_in_flight);
+		assert(pool.GetStats().retired_bytes == frames_in_flight * 1024);
+	}
+
+	cout << "------------------------[compact]------------------------" << endl;
+	{
+		UFG::TransientPool pool({ .max_age = 0, .page_size = 4096 });
+		std::vector<UFG::TransientPool::Handle> handles;
+		for (size_t i = 0; i < 64; i++)
+			handles.push_back(pool.Acquire({ 256 }));
+		assert(pool.GetStats().page_num == 4);
+
+		// keep every 4th block, the pages are used by a quarter
+		std::vector<UFG::TransientPool::Handle> lives;
+		for (size_t i = 0; i < 64; i++) {
+			if (i % 4 == 0) {
+				*static_cast<size_t*>(pool.GetData(handles[i])) = i;
+				lives.push_back(handles[i]);
+			}
+			else
+				pool.Release(handles[i]);
+		}
+		pool.NextFrame();
+		PrintStats(pool);
+		assert(pool.GetStats().page_num == 4);
+
+		// the live blocks stay
+		[[maybe_unused]] size_t compacted = pool.Compact(std::chrono::seconds(1));
+		assert(compacted == 0);
+
+		size_t reclaimed = pool.Compact(std::chrono::seconds(1), true);
+		PrintStats(pool);
+		cout << "[Compact]   reclaimed " << reclaimed << " B | relocated " << pool.GetStats().relocated_bytes << " B" << endl;
+		assert(reclaimed == 3 * 4096);
+		assert(pool.GetStats().page_num == 1);
+		for (size_t i = 0; i < lives.size(); i++)
+			assert(*static_cast<size_t*>(pool.GetData(lives[i])) == 4 * i);
+
+		for (auto handle : lives)
+			pool.Release(handle);
+		pool.NextFrame();
+		assert(pool.GetStats().allocated_bytes == 0);
+	}
+	{
+		// the cached blocks are relocated without relocateLive
+		UFG::TransientPool pool({ .max_age = 1, .page_size = 4096 });
+		std::vector<UFG::TransientPool::Handle> handles;
+		for (size_t i = 0; i < 64; i++)
+			handles.push_back(pool.Acquire({ 256 }));
+		for (size_t i = 0; i < 64; i++) {
+			if (i % 4 != 0)
+				pool.Release(handles[i]);
+		}
+		pool.NextFrame();
+		for (size_t i = 0; i < 64; i += 4)
+			pool.Release(handles[i]);
+		pool.NextFrame();
+		// the blocks released at frame 0 are aged
+		assert(pool.GetStats().page_num == 4);
+		assert(pool.GetStats().cached_bytes == 16 * 256);
+
+		[[maybe_unused]] size_t reclaimed = pool.Compact(std::chrono::seconds(1));
+		PrintStats(pool);
+		assert(reclaimed == 3 * 4096);
+		assert(pool.GetStats().cached_bytes == 16 * 256);
+		auto handle = pool.Acquire({ 256 });
+		assert(pool.GetStats().miss_num == 64);
+		pool.Release(handle);
+	}
+
+	cout << "------------------------[budget]------------------------" << endl;
+	{
+		UFG::TransientPool pool({ .budget = 4096, .page_size = 512 });
+		auto a = pool.Acquire({ 2048 });
+		auto b = pool.Acquire({ 1024 });
+		pool.Release(a);
+		pool.Release(b);
+		// evict the least recently released (a) first
+		auto c = pool.Acquire({ 3072 });
+		PrintStats(pool);
+		assert(pool.GetStats().evicted_num == 1);
+		assert(pool.GetStats().allocated_bytes == 1024 + 3072);
+		pool.Release(c);
+		pool.Clear();
+		assert(pool.GetStats().allocated_bytes == 0);
+	}
+
+	return 0;
+}
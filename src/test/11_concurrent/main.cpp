@@ -0,0 +1,119 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Ubpa;
+
+constexpr size_t size_num = 8;
+constexpr size_t live_num = 4;
+
+size_t GetSize(size_t i) {
+	return 256 * (1 + i % size_num);
+}
+
+// each thread acquires a few blocks, writes them as a pass would and releases them
+template<typename Acquire, typename Release, typename GetData>
+double Run(size_t thread_num, size_t iteration_num, Acquire&& acquire, Release&& release, GetData&& get_data) {
+	auto begin = chrono::steady_clock::now();
+	vector<thread> threads;
+	for (size_t t = 0; t < thread_num; t++) {
+		threads.emplace_back([&, t]() {
+			using Handle = decltype(acquire(size_t{ 0 }));
+			Handle handles[live_num];
+			for (size_t i = 0; i < iteration_num; i++) {
+				for (size_t j = 0; j < live_num; j++) {
+					handles[j] = acquire(GetSize(t + i + j));
+					*static_cast<size_t*>(get_data(handles[j])) = t;
+				}
+				for (size_t j = 0; j < live_num; j++) {
+					// no block is shared by two threads
+					assert(*static_cast<size_t*>(get_data(handles[j])) == t);
+					release(handles[j]);
+				}
+			}
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+	auto end = chrono::steady_clock::now();
+	double seconds = chrono::duration<double>(end - begin).count();
+	return static_cast<double>(thread_num * iteration_num * live_num * 2) / seconds;
+}
+
+int main() {
+	constexpr size_t iteration_num = 20000;
+
+	cout << "------------------------[correctness]------------------------" << endl;
+	{
+		UFG::ConcurrentPool pool;
+		Run(8, iteration_num,
+			[&](size_t size) { return pool.Acquire({ size }); },
+			[&](UFG::ConcurrentPool::Handle handle) { pool.Release(handle); },
+			[&](UFG::ConcurrentPool::Handle handle) { return pool.GetData(handle); });
+		auto stats = pool.GetStats();
+		cout << "[Stats]     hit " << stats.hit_num << " | miss " << stats.miss_num << " | cached " << stats.cached_num << endl;
+		assert(stats.hit_num + stats.miss_num == 8 * iteration_num * live_num);
+		assert(stats.cached_num == stats.miss_num);
+		// at most live_num blocks per thread
+		assert(stats.miss_num <= 8 * live_num * size_num);
+
+		// aging
+		for (size_t i = 0; i <= pool.GetTransientPool().GetConfig().max_age; i++)
+			pool.NextFrame();
+		assert(pool.GetStats().cached_num == 0);
+		pool.Clear();
+		assert(pool.GetTransientPool().GetStats().allocated_bytes == 0);
+	}
+
+	cout << "------------------------[retire]------------------------" << endl;
+	{
+		// the workers retire the blocks of frame f, they are reusable once frame f completes
+		UFG::ConcurrentPool pool;
+		for (size_t frame = 0; frame < 4; frame++) {
+			vector<thread> threads;
+			for (size_t t = 0; t < 4; t++) {
+				threads.emplace_back([&pool, frame]() {
+					for (size_t i = 0; i < 16; i++)
+						pool.Retire(pool.Acquire({ 1024 }), frame);
+				});
+			}
+			for (auto& thread : threads)
+				thread.join();
+			if (frame > 0)
+				pool.Reclaim(frame - 1);
+		}
+		auto stats = pool.GetStats();
+		cout << "[Stats]     hit " << stats.hit_num << " | miss " << stats.miss_num << " | cached " << stats.cached_num << endl;
+		// the frames 2 and 3 reuse the blocks of the frames 0 and 1, the ones of the frame 3 are still retired
+		assert(stats.miss_num == 2 * 4 * 16);
+		assert(stats.hit_num == 2 * 4 * 16);
+		assert(stats.cached_num == 4 * 16);
+	}
+
+	cout << "------------------------[scaling]------------------------" << endl;
+	cout << "threads, concurrent pool (ops/s), mutex + transient pool (ops/s)" << endl;
+	for (size_t thread_num = 1; thread_num <= 64; thread_num *= 2) {
+		UFG::ConcurrentPool concurrent_pool;
+		double concurrent = Run(thread_num, iteration_num,
+			[&](size_t size) { return concurrent_pool.Acquire({ size }); },
+			[&](UFG::ConcurrentPool::Handle handle) { concurrent_pool.Release(handle); },
+			[&](UFG::ConcurrentPool::Handle handle) { return concurrent_pool.GetData(handle); });
+
+		UFG::TransientPool transient_pool;
+		std::mutex mutex;
+		double locked = Run(thread_num, iteration_num,
+			[&](size_t size) { std::lock_guard<std::mutex> lk(mutex); return transient_pool.Acquire({ size }); },
+			[&](UFG::TransientPool::Handle handle) { std::lock_guard<std::mutex> lk(mutex); transient_pool.Release(handle); },
+			[&](UFG::TransientPool::Handle handle) { std::lock_guard<std::mutex> lk(mutex); return transient_pool.GetData(handle); });
+
+		cout << thread_num << ", " << concurrent << ", " << locked << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+using namespace Ubpa;
+
+constexpr size_t buffer_size = 16 * 1024 * 1024;
+
+// serial executor, every frame starts cold (the pool is cleared),
+// returns the time spent on constructing the outputs and their first writes
+double Execute(
+	const UFG::FrameGraph& fg,
+	const UFG::Compiler::Result& crst,
+	UFG::ConcurrentPool& pool,
+	UFG::Prefetcher* prefetcher)
+{
+	chrono::duration<double> stall{ 0 };
+	std::vector<UFG::ConcurrentPool::Handle> actives(fg.GetResourceNodes().size());
+
+	if (prefetcher)
+		prefetcher->Begin();
+
+	for (auto pass : crst.sorted_passes) {
+		if (prefetcher)
+			prefetcher->Advance(pass);
+
+		auto begin = chrono::steady_clock::now();
+		for (auto rsrc : crst.pass2info.at(pass).construct_resources) {
+			auto handle = prefetcher ? prefetcher->Take(rsrc) : UFG::ConcurrentPool::Handle{};
+			if (!handle.IsValid())
+				handle = pool.Acquire({ buffer_size });
+			actives[rsrc] = handle;
+			std::memset(pool.GetData(handle), 0, buffer_size);
+		}
+		stall += chrono::steady_clock::now() - begin;
+
+		// the work of the pass
+		this_thread::sleep_for(chrono::milliseconds(5));
+
+		for (auto rsrc : crst.pass2info.at(pass).destruct_resources)
+			pool.Release(actives[rsrc]);
+	}
+
+	if (prefetcher)
+		prefetcher->End();
+	pool.Clear();
+
+	return stall.count();
+}
+
+int main() {
+	UFG::FrameGraph fg("test 12 prefetch");
+
+	constexpr size_t pass_num = 8;
+	std::vector<size_t> rsrcs;
+	for (size_t i = 0; i < pass_num; i++)
+		rsrcs.push_back(fg.RegisterResourceNode("Buffer" + std::to_string(i)));
+	for (size_t i = 0; i < pass_num; i++) {
+		std::vector<size_t> inputs;
+		if (i > 0)
+			inputs.push_back(rsrcs[i - 1]);
+		fg.RegisterGeneralPassNode("Pass" + std::to_string(i), inputs, std::array{ rsrcs[i] });
+	}
+	fg.RegisterGeneralPassNode("Present", { rsrcs.back() }, {});
+
+	UFG::Compiler compiler;
+	auto crst = compiler.Compile(fg);
+
+	// the pages of the buffers are returned to the system every frame
+	UFG::ConcurrentPool pool({ .max_age = 0 });
+
+	constexpr size_t frame_num = 4;
+
+	double stall = 0;
+	for (size_t i = 0; i < frame_num; i++)
+		stall += Execute(fg, crst, pool, nullptr);
+	cout << "[No Prefetch] stall " << stall * 1000 / frame_num << " ms/frame" << endl;
+
+	for (auto unit : { UFG::Prefetcher::Unit::Order, UFG::Prefetcher::Unit::Level }) {
+		UFG::Prefetcher prefetcher(fg, crst, pool,
+			[](size_t) { return UFG::ConcurrentPool::Desc{ buffer_size }; },
+			{ .distance = 2, .unit = unit });
+		double prefetch_stall = 0;
+		for (size_t i = 0; i < frame_num; i++)
+			prefetch_stall += Execute(fg, crst, pool, &prefetcher);
+
+		auto stats = prefetcher.GetStats();
+		cout << "[Prefetch " << (unit == UFG::Prefetcher::Unit::Order ? "Order" : "Level") << "] stall "
+			<< prefetch_stall * 1000 / frame_num << " ms/frame"
+			<< " | prefetched " << stats.prefetched_num << " | taken " << stats.taken_num
+			<< " | late " << stats.late_num << " | touched " << stats.touched_bytes / (1024 * 1024) << " MB" << endl;
+		assert(stats.taken_num + stats.late_num == frame_num * pass_num);
+		assert(stats.taken_num > 0);
+	}
+
+	return 0;
+}
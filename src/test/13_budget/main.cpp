@@ -0,0 +1,197 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace Ubpa;
+
+// maximum live bytes when every ready pass runs at once (one level of the pass graph per step)
+size_t ParallelPeak(const UFG::FrameGraph& fg, const UFG::Compiler::Result& crst) {
+	vector<size_t> levels(fg.GetPassNodes().size(), 0);
+	size_t level_num = 0;
+	for (auto pass : crst.sorted_passes) {
+		level_num = max(level_num, levels[pass] + 1);
+		for (auto next : crst.passgraph.adjList.at(pass))
+			levels[next] = max(levels[next], levels[pass] + 1);
+	}
+
+	size_t peak = 0;
+	for (size_t level = 0; level < level_num; level++) {
+		size_t live = 0;
+		for (size_t rsrc = 0; rsrc < crst.rsrcinfos.size(); rsrc++) {
+			const auto& info = crst.rsrcinfos[rsrc];
+			if (info.first == static_cast<size_t>(-1))
+				continue;
+			size_t first = levels[crst.sorted_passes[info.first]];
+			size_t last = levels[crst.sorted_passes[info.last]];
+			if (first <= level && level <= last)
+				live += fg.GetResourceNodes()[rsrc].GetSize();
+		}
+		peak = max(peak, live);
+	}
+	return peak;
+}
+
+int main() {
+	constexpr size_t branch_num = 6;
+	constexpr size_t big = 16 << 20;
+	constexpr size_t small = 1 << 20;
+
+	UFG::FrameGraph fg("test 13 budget");
+
+	// branch i : Produce i -> Big i -> Reduce i -> Small i -> Combine -> Final Target
+	vector<size_t> bigs, smalls;
+	for (size_t i = 0; i < branch_num; i++) {
+		bigs.push_back(fg.RegisterResourceNode("Big " + to_string(i)));
+		smalls.push_back(fg.RegisterResourceNode("Small " + to_string(i)));
+		fg.SetResourceNodeSize(bigs.back(), big);
+		fg.SetResourceNodeSize(smalls.back(), small);
+	}
+	size_t finaltarget = fg.RegisterResourceNode("Final Target"); // imported, size unknown
+
+	for (size_t i = 0; i < branch_num; i++) {
+		fg.RegisterGeneralPassNode("Produce " + to_string(i), {}, { bigs[i] });
+		fg.RegisterGeneralPassNode("Reduce " + to_string(i), { bigs[i] }, { smalls[i] });
+	}
+	fg.RegisterGeneralPassNode("Combine", smalls, std::array{ finaltarget });
+
+	UFG::Compiler compiler;
+
+	cout << "------------------------[unlimited]------------------------" << endl;
+	auto crst = compiler.Compile(fg);
+	cout << "peak " << crst.memory.peak_bytes << " bytes, parallel peak " << ParallelPeak(fg, crst) << " bytes, "
+		<< crst.memory.level_num << " levels" << endl;
+	assert(crst.memory.serialized_edge_num == 0);
+	assert(crst.memory.level_num == 3);
+	assert(crst.memory.level_num == crst.memory.level_num_before);
+	assert(ParallelPeak(fg, crst) == branch_num * (big + small));
+
+	cout << "------------------------[budget]------------------------" << endl;
+	UFG::Compiler::Options options;
+	options.memory_budget = big + branch_num * small;
+	auto crst_budget = compiler.Compile(fg, options);
+	cout << "peak " << crst_budget.memory.peak_bytes << " bytes, parallel peak " << ParallelPeak(fg, crst_budget) << " bytes, "
+		<< crst_budget.memory.serialized_edge_num << " edges, "
+		<< crst_budget.memory.level_num_before << " -> " << crst_budget.memory.level_num << " levels" << endl;
+	for (auto pass : crst_budget.sorted_passes)
+		cout << "  - " << fg.GetPassNodes()[pass].Name() << endl;
+	assert(crst_budget.memory.peak_bytes <= options.memory_budget);
+	assert(ParallelPeak(fg, crst_budget) <= options.memory_budget);
+	assert(crst_budget.memory.serialized_edge_num > 0);
+	assert(crst_budget.memory.level_num > crst_budget.memory.level_num_before);
+	assert(crst_budget.passgraph.TopoSort().has_value());
+
+	cout << "------------------------[loose budget]------------------------" << endl;
+	options.memory_budget = branch_num * (big + small);
+	auto crst_loose = compiler.Compile(fg, options);
+	assert(crst_loose.memory.serialized_edge_num == 0);
+	assert(crst_loose.memory.level_num == crst_loose.memory.level_num_before);
+	cout << "no serialization" << endl;
+
+	cout << "------------------------[variants]------------------------" << endl;
+	{
+		// the budget applies to every compiled variant
+		UFG::Compiler::Options variant_options;
+		variant_options.memory_budget = big + branch_num * small;
+		uint64_t masks[] = { 0 };
+		auto table = compiler.CompileVariants(fg, masks, variant_options);
+		const auto& variant = table.Select(0);
+		assert(variant.memory.peak_bytes == crst_budget.memory.peak_bytes);
+		assert(variant.memory.serialized_edge_num == crst_budget.memory.serialized_edge_num);
+		assert(variant.sorted_passes == crst_budget.sorted_passes);
+		cout << "peak " << variant.memory.peak_bytes << " bytes" << endl;
+	}
+
+	cout << "------------------------[report]------------------------" << endl;
+	{
+		auto report = crst_budget.GetMemoryReport(fg);
+		assert(report.live_bytes.size() == crst_budget.sorted_passes.size());
+		assert(report.peak_bytes == crst_budget.memory.peak_bytes);
+		assert(*max_element(report.live_bytes.begin(), report.live_bytes.end()) == report.peak_bytes);
+		assert(report.live_bytes[crst_budget.pass2order[report.peak_pass]] == report.peak_bytes);
+		assert(report.naive_bytes == branch_num * (big + small));
+		size_t peak_sum = 0;
+		for (auto rsrc : report.peak_resources)
+			peak_sum += fg.GetResourceNodes()[rsrc].GetSize();
+		assert(peak_sum == report.peak_bytes);
+		assert(report.GetAliasingRatio() < 0.25);
+
+		cout << "peak " << report.peak_bytes << " bytes at " << fg.GetPassNodes()[report.peak_pass].Name()
+			<< ", aliased / naive " << report.GetAliasingRatio() << endl;
+		for (auto rsrc : report.peak_resources)
+			cout << "  - " << fg.GetResourceNodes()[rsrc].Name() << endl;
+
+		auto svg = crst_budget.ToLifetimeSVG(fg);
+		assert(svg.find("<svg") == 0);
+#ifndef UFG_STRIP_NAMES
+		assert(svg.find("Big 0 (16.00 MiB)") != string::npos);
+#endif
+		cout << svg;
+	}
+
+	cout << "------------------------[peak chains]------------------------" << endl;
+	{
+		// serial : P0 -> A -> P1 -> B -> P2 -> C -> P3 -> T, T is moved from Pool (constructed before the passes)
+		UFG::FrameGraph line("peak chains");
+		size_t a = line.RegisterResourceNode("A");
+		size_t b = line.RegisterResourceNode("B");
+		size_t c = line.RegisterResourceNode("C");
+		size_t pool = line.RegisterResourceNode("Pool");
+		size_t t = line.RegisterResourceNode("T");
+		line.SetResourceNodeSize(a, 4);
+		line.SetResourceNodeSize(b, 2);
+		line.SetResourceNodeSize(c, 8);
+		line.SetResourceNodeSize(pool, 1);
+		line.RegisterMoveNode(t, pool);
+		line.RegisterGeneralPassNode("P0", {}, { a });
+		line.RegisterGeneralPassNode("P1", { a }, { b });
+		[[maybe_unused]] size_t p2 = line.RegisterGeneralPassNode("P2", { b }, { c });
+		line.RegisterGeneralPassNode("P3", { c }, { t });
+
+		auto crst_line = compiler.Compile(line);
+		auto report = crst_line.GetMemoryReport(line);
+		// P0 : A + Pool, P1 : A + B + Pool, P2 : B + C + Pool, P3 : C + T
+		assert(report.live_bytes == (vector<size_t>{ 5, 7, 11, 9 }));
+		assert(report.peak_pass == p2 && report.peak_bytes == 11);
+		// A is freed before the peak, B is freed at it, C is allocated at it, the pool chain is held by T at the peak
+		auto peak_resources = report.peak_resources;
+		sort(peak_resources.begin(), peak_resources.end());
+		assert(peak_resources == (vector<size_t>{ b, c, t }));
+		assert(crst_line.memory.peak_bytes == 11);
+
+		// the live chains at the peak are listed when the budget is exceeded
+		UFG::Compiler::Options line_options;
+		line_options.memory_budget = 10;
+		try {
+			compiler.Compile(line, line_options);
+			assert(false);
+		}
+		catch (const std::logic_error& e) {
+			cout << e.what() << endl;
+#ifndef UFG_STRIP_NAMES
+			string msg = e.what();
+			assert(msg.find("B (2 bytes)") != string::npos && msg.find("C (8 bytes)") != string::npos
+				&& msg.find("Pool (1 bytes)") != string::npos && msg.find("A (") == string::npos);
+#endif
+		}
+	}
+
+	cout << "------------------------[infeasible]------------------------" << endl;
+	options.memory_budget = big;
+	try {
+		compiler.Compile(fg, options);
+		assert(false);
+	}
+	catch (const std::logic_error& e) {
+		cout << e.what() << endl;
+#ifndef UFG_STRIP_NAMES
+		assert(string{ e.what() }.find("Big") != string::npos);
+#endif
+	}
+
+	return 0;
+}
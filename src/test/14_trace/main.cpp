@@ -0,0 +1,144 @@
+#ifndef UFG_ENABLE_TRACE
+#define UFG_ENABLE_TRACE
+#endif
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Ubpa;
+
+class Executor {
+public:
+	Executor(UFG::TraceRecorder& recorder) : recorder{ recorder } {}
+
+	virtual void Execute(
+		const UFG::FrameGraph&,
+		const UFG::Compiler::Result& crst)
+	{
+		for (auto pass : crst.sorted_passes) {
+			const auto& passInfo = crst.pass2info.at(pass);
+			for (auto rsrc : passInfo.construct_resources)
+				UFG_TRACE(recorder, Construct, rsrc);
+
+			UFG_TRACE(recorder, PassBegin, pass);
+			this_thread::sleep_for(chrono::microseconds(10));
+			UFG_TRACE(recorder, PassEnd, pass);
+
+			for (auto rsrc : passInfo.move_resources)
+				UFG_TRACE(recorder, Move, crst.moves_src2dst.at(rsrc), rsrc);
+			for (auto rsrc : passInfo.destruct_resources)
+				UFG_TRACE(recorder, Destruct, rsrc);
+		}
+	}
+
+private:
+	UFG::TraceRecorder& recorder;
+};
+
+int main() {
+	UFG::FrameGraph fg("test 14 trace");
+
+	size_t depthbuffer = fg.RegisterResourceNode("Depth Buffer");
+	size_t depthbuffer2 = fg.RegisterResourceNode("Depth Buffer 2");
+	size_t gbuffer = fg.RegisterResourceNode("GBuffer\t0");
+	size_t finaltarget = fg.RegisterResourceNode("Final \"Target\"");
+
+	fg.RegisterGeneralPassNode("Depth pass", {}, { depthbuffer });
+	fg.RegisterMoveNode(depthbuffer2, depthbuffer);
+	fg.RegisterGeneralPassNode("GBuffer pass", {}, { depthbuffer2, gbuffer });
+	fg.RegisterGeneralPassNode("Lighting", { depthbuffer2, gbuffer }, { finaltarget });
+	fg.RegisterGeneralPassNode("Present", { finaltarget }, {});
+
+	UFG::Compiler compiler;
+	auto crst = compiler.Compile(fg);
+
+	cout << "------------------------[execute]------------------------" << endl;
+	{
+		UFG::TraceRecorder recorder;
+		Executor executor(recorder);
+		executor.Execute(fg, crst);
+		UFG_TRACE(recorder, Transition, finaltarget, 1, 2);
+
+		auto events = recorder.GetEvents();
+		size_t begin_num = 0, end_num = 0;
+		for (size_t i = 0; i < events.size(); i++) {
+			if (i > 0)
+				assert(events[i - 1].time <= events[i].time);
+			begin_num += events[i].type == UFG::TraceRecorder::EventType::PassBegin;
+			end_num += events[i].type == UFG::TraceRecorder::EventType::PassEnd;
+		}
+		assert(begin_num == fg.GetPassNodes().size() && end_num == begin_num);
+
+		auto json = recorder.ToChromeTrace(fg);
+		cout << json;
+		assert(json.find("\"traceEvents\"") != string::npos);
+#ifndef UFG_STRIP_NAMES
+		assert(json.find("\"Lighting\"") != string::npos);
+		assert(json.find("Final \\\"Target\\\"") != string::npos);
+		assert(json.find("GBuffer\\u00090") != string::npos);
+#endif
+		assert(json.find("\"before\":1,\"after\":2") != string::npos);
+
+		auto path = (filesystem::temp_directory_path() / "ufg_test_14_trace.json").string();
+		[[maybe_unused]] bool written = recorder.WriteChromeTrace(fg, path);
+		assert(written);
+		assert(filesystem::file_size(path) == json.size());
+		filesystem::remove(path);
+	}
+
+	cout << "------------------------[ring]------------------------" << endl;
+	{
+		UFG::TraceRecorder recorder(5); // rounded up to 8
+		assert(recorder.GetCapacity() == 8);
+		for (size_t i = 0; i < 20; i++)
+			UFG_TRACE(recorder, PassBegin, i);
+		auto events = recorder.GetEvents();
+		assert(recorder.GetRecordedNum() == 20);
+		assert(events.size() == 8);
+		for (size_t i = 0; i < 8; i++)
+			assert(events[i].index == 12 + i);
+		recorder.Clear();
+		assert(recorder.GetEvents().empty());
+		cout << "kept the last " << events.size() << " events" << endl;
+	}
+
+	cout << "------------------------[overhead]------------------------" << endl;
+	{
+		constexpr size_t event_num = 1 << 20;
+		UFG::TraceRecorder recorder(event_num);
+		for (size_t thread_num : { 1, 4 }) {
+			recorder.Clear();
+			auto begin = chrono::steady_clock::now();
+			vector<thread> threads;
+			for (size_t t = 0; t < thread_num; t++) {
+				threads.emplace_back([&recorder, thread_num]() {
+					for (size_t i = 0; i < event_num / thread_num; i++)
+						UFG_TRACE(recorder, PassBegin, i);
+				});
+			}
+			for (auto& t : threads)
+				t.join();
+			auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+			assert(recorder.GetRecordedNum() == event_num);
+
+			// every thread has its own id
+			vector<uint32_t> ids;
+			for (const auto& event : recorder.GetEvents()) {
+				if (find(ids.begin(), ids.end(), event.thread) == ids.end())
+					ids.push_back(event.thread);
+			}
+			assert(ids.size() == thread_num);
+
+			cout << thread_num << " thread(s) : " << double(ns) / event_num << " ns/event" << endl;
+		}
+	}
+
+	return 0;
+}
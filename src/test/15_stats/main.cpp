@@ -0,0 +1,94 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace std;
+using namespace Ubpa;
+
+// opt-in allocation counting of the compilations
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size) {
+	UFG::Compiler::CompileStats::CountAllocation(size);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size))
+		return ptr;
+	throw std::bad_alloc{};
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+int main() {
+	constexpr size_t chain_num = 64;
+	constexpr size_t chain_length = 32;
+
+	UFG::FrameGraph fg("test 15 stats");
+
+	// chain i : Pass i-0 -> R i-0 -> Pass i-1 -> R i-1 ... the last resource of a chain is moved into M i
+	for (size_t i = 0; i < chain_num; i++) {
+		for (size_t j = 0; j < chain_length; j++)
+			fg.RegisterResourceNode("R " + to_string(i) + "-" + to_string(j));
+		fg.RegisterResourceNode("M " + to_string(i));
+	}
+	for (size_t i = 0; i < chain_num; i++) {
+		size_t base = i * (chain_length + 1);
+		fg.RegisterGeneralPassNode("Pass " + to_string(i) + "-0", {}, { base });
+		for (size_t j = 1; j < chain_length; j++)
+			fg.RegisterGeneralPassNode("Pass " + to_string(i) + "-" + to_string(j), { base + j - 1 }, { base + j });
+		fg.RegisterMoveNode(base + chain_length, base + chain_length - 1);
+		fg.RegisterGeneralPassNode("Read " + to_string(i), { base + chain_length }, {});
+	}
+
+	UFG::Compiler compiler;
+	UFG::Compiler::CompileStats stats;
+	auto crst = compiler.Compile(fg, {}, &stats);
+
+	cout << "------------------------[stats]------------------------" << endl;
+	for (size_t i = 0; i < UFG::Compiler::CompileStats::PhaseNum; i++) {
+		cout << UFG::Compiler::CompileStats::phase_names[i] << " : " << stats.phase_times[i].count() << " ns, "
+			<< stats.phase_allocation_nums[i] << " allocations, " << stats.phase_allocated_bytes[i] << " bytes" << endl;
+	}
+	cout << "total : " << stats.GetTotalTime().count() << " ns" << endl;
+	cout << "passes : " << stats.pass_num << endl
+		<< "resources : " << stats.resource_num << endl
+		<< "moves : " << stats.move_num << endl
+		<< "copies : " << stats.copy_num << endl
+		<< "edges : " << stats.edge_num << endl
+		<< "allocations : " << stats.GetAllocationNum() << endl
+		<< "allocated bytes : " << stats.GetAllocatedBytes() << endl
+		<< "result bytes : " << stats.result_bytes << endl;
+
+	assert(stats.compile_num == 1);
+	assert(stats.pass_num == chain_num * (chain_length + 1));
+	assert(stats.resource_num == chain_num * (chain_length + 1));
+	assert(stats.move_num == chain_num);
+	assert(stats.copy_num == 0);
+	// chain_length - 1 writer -> reader edges and a move edge per chain
+	assert(stats.edge_num == chain_num * chain_length);
+	assert(stats.GetAllocationNum() > 0 && stats.GetAllocatedBytes() > stats.GetAllocationNum());
+	// the accessors, the maps, the pass graph and the lifetimes allocate
+	for ([[maybe_unused]] auto phase : { UFG::Compiler::CompileStats::Analyze, UFG::Compiler::CompileStats::MoveCopyMaps,
+		UFG::Compiler::CompileStats::Edges, UFG::Compiler::CompileStats::Lifetimes })
+	{
+		assert(stats.phase_allocation_nums[phase] > 0);
+	}
+	// the result is a part of the allocations
+	assert(stats.result_bytes > 0 && stats.result_bytes < stats.GetAllocatedBytes());
+	assert(stats.GetTotalTime().count() > 0);
+
+	// accumulated
+	[[maybe_unused]] auto phase_times = stats.phase_times;
+	[[maybe_unused]] size_t allocation_num = stats.GetAllocationNum();
+	compiler.Compile(fg, {}, &stats);
+	assert(stats.GetAllocationNum() > allocation_num);
+	assert(stats.compile_num == 2);
+	assert(stats.pass_num == 2 * chain_num * (chain_length + 1));
+	for (size_t i = 0; i < UFG::Compiler::CompileStats::PhaseNum; i++)
+		assert(stats.phase_times[i] >= phase_times[i]);
+
+	return 0;
+}
@@ -0,0 +1,244 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+using namespace std;
+using namespace Ubpa;
+
+using Simulator = UFG::ScheduleSimulator;
+
+void Print(const Simulator::Result& rst) {
+	cout << "makespan " << rst.makespan << ", critical path " << rst.critical_path << ", work " << rst.work
+		<< ", peak " << rst.peak_bytes << " bytes at " << rst.peak_time << endl;
+	for (size_t i = 0; i < rst.workers.size(); i++) {
+		cout << "  worker " << i << " (queue " << rst.workers[i].queue << ") : "
+			<< rst.workers[i].pass_num << " passes, occupancy " << rst.GetOccupancy(i) << endl;
+	}
+}
+
+int main() {
+	constexpr size_t branch_num = 6;
+	constexpr size_t big = 16 << 20;
+	constexpr size_t small = 1 << 20;
+
+	UFG::FrameGraph fg("test 16 simulate");
+
+	// branch i : Produce i -> Big i -> Reduce i -> Small i -> Combine -> Final Target
+	vector<size_t> bigs, smalls;
+	for (size_t i = 0; i < branch_num; i++) {
+		bigs.push_back(fg.RegisterResourceNode("Big " + to_string(i)));
+		smalls.push_back(fg.RegisterResourceNode("Small " + to_string(i)));
+		fg.SetResourceNodeSize(bigs.back(), big);
+		fg.SetResourceNodeSize(smalls.back(), small);
+	}
+	size_t finaltarget = fg.RegisterResourceNode("Final Target");
+
+	vector<size_t> produces;
+	for (size_t i = 0; i < branch_num; i++) {
+		produces.push_back(fg.RegisterGeneralPassNode("Produce " + to_string(i), {}, { bigs[i] }));
+		fg.RegisterGeneralPassNode("Reduce " + to_string(i), { bigs[i] }, { smalls[i] });
+	}
+	fg.RegisterGeneralPassNode("Combine", smalls, std::array{ finaltarget });
+
+	UFG::Compiler compiler;
+	auto crst = compiler.Compile(fg);
+	Simulator simulator(fg, crst);
+	vector<double> costs(fg.GetPassNodes().size(), 1.);
+
+	cout << "------------------------[serial]------------------------" << endl;
+	{
+		Simulator::Config config;
+		config.policy = Simulator::Policy::Order;
+		auto rst = simulator.Simulate(costs, config);
+		Print(rst);
+		assert(rst.makespan == rst.work);
+		assert(rst.GetOccupancy(0) == 1.);
+		// the serial schedule is the compiled order
+		for (size_t i = 1; i < crst.sorted_passes.size(); i++)
+			assert(rst.pass2start[crst.sorted_passes[i]] == rst.pass2finish[crst.sorted_passes[i - 1]]);
+		assert(rst.peak_bytes == crst.memory.peak_bytes);
+		assert(rst.memory.back().bytes == 0);
+	}
+
+	cout << "------------------------[wide]------------------------" << endl;
+	{
+		Simulator::Config config;
+		config.queue_worker_nums = { branch_num };
+		auto rst = simulator.Simulate(costs, config);
+		Print(rst);
+		assert(rst.makespan == 3.);
+		assert(rst.makespan == rst.critical_path);
+		assert(rst.peak_bytes == branch_num * (big + small));
+	}
+
+	cout << "------------------------[budget]------------------------" << endl;
+	{
+		UFG::Compiler::Options options;
+		options.memory_budget = big + branch_num * small;
+		auto crst_budget = compiler.Compile(fg, options);
+		Simulator simulator_budget(fg, crst_budget);
+		Simulator::Config config;
+		config.queue_worker_nums = { branch_num };
+		auto rst = simulator_budget.Simulate(costs, config);
+		Print(rst);
+		assert(rst.peak_bytes <= options.memory_budget);
+		assert(rst.makespan > 3.);
+	}
+
+	cout << "------------------------[async queue]------------------------" << endl;
+	{
+		// the producers on an async queue, the edges to the graphics queue pay the latency
+		Simulator::Config config;
+		config.queue_worker_nums = { branch_num, branch_num };
+		config.pass2queue.assign(fg.GetPassNodes().size(), 0);
+		for (auto pass : produces)
+			config.pass2queue[pass] = 1;
+		config.cross_queue_latency = 0.5;
+		config.dispatch_cost = 0.25;
+		auto rst = simulator.Simulate(costs, config);
+		Print(rst);
+		assert(rst.makespan == 3 * 1.25 + 0.5);
+		assert(rst.makespan == rst.critical_path);
+		for ([[maybe_unused]] auto pass : produces)
+			assert(rst.workers[rst.pass2worker[pass]].queue == 1);
+	}
+
+	cout << "------------------------[policy]------------------------" << endl;
+	{
+		// a long producer, the critical path policy starts it first
+		auto costs_skewed = costs;
+		costs_skewed[produces.back()] = 4.;
+		Simulator::Config config;
+		config.queue_worker_nums = { 2 };
+		config.policy = Simulator::Policy::Order;
+		auto rst_order = simulator.Simulate(costs_skewed, config);
+		config.policy = Simulator::Policy::CriticalPath;
+		auto rst_cp = simulator.Simulate(costs_skewed, config);
+		config.policy = Simulator::Policy::Fifo;
+		auto rst_fifo = simulator.Simulate(costs_skewed, config);
+		cout << "order " << rst_order.makespan << ", critical path " << rst_cp.makespan << ", fifo " << rst_fifo.makespan << endl;
+		assert(rst_cp.makespan <= rst_order.makespan);
+		assert(rst_cp.pass2start[produces.back()] == 0.);
+		for ([[maybe_unused]] const auto* rst : { &rst_order, &rst_cp, &rst_fifo })
+			assert(rst->makespan >= max(rst->critical_path, rst->work / 2));
+	}
+
+	cout << "------------------------[sweep]------------------------" << endl;
+	{
+		// layered graph, every pass reads two resources of the previous layer
+		constexpr size_t layer_num = 64;
+		constexpr size_t width = 32;
+		UFG::FrameGraph fg_large("sweep");
+		vector<size_t> prev, cur;
+		for (size_t layer = 0; layer < layer_num; layer++) {
+			cur.clear();
+			for (size_t i = 0; i < width; i++) {
+				size_t rsrc = fg_large.RegisterResourceNode("R " + to_string(layer) + " " + to_string(i));
+				fg_large.SetResourceNodeSize(rsrc, (i % 4 + 1) << 20);
+				cur.push_back(rsrc);
+				vector<size_t> inputs;
+				if (!prev.empty())
+					inputs = { prev[i], prev[(i * 7 + 1) % width] };
+				fg_large.RegisterGeneralPassNode("P " + to_string(layer) + " " + to_string(i), inputs, std::array{ rsrc });
+			}
+			swap(prev, cur);
+		}
+		fg_large.RegisterGeneralPassNode("Present", prev, std::array{ fg_large.RegisterResourceNode("Final Target") });
+
+		auto crst_large = compiler.Compile(fg_large);
+		Simulator simulator_large(fg_large, crst_large);
+		vector<double> costs_large(fg_large.GetPassNodes().size());
+		for (size_t i = 0; i < costs_large.size(); i++)
+			costs_large[i] = 1. + static_cast<double>(i * 2654435761u % 97) / 25.;
+
+		size_t run_num = 0;
+		auto t0 = chrono::steady_clock::now();
+		for (auto policy : { Simulator::Policy::Order, Simulator::Policy::Fifo, Simulator::Policy::CriticalPath }) {
+			for (size_t worker_num = 1; worker_num <= 16; worker_num++) {
+				Simulator::Config config;
+				config.queue_worker_nums = { worker_num };
+				config.policy = policy;
+				auto rst = simulator_large.Simulate(costs_large, config);
+				assert(rst.makespan >= max(rst.critical_path, rst.work / worker_num) - 1e-9);
+				if (worker_num == 1)
+					assert(abs(rst.makespan - rst.work) < 1e-9);
+				if (policy == Simulator::Policy::CriticalPath && worker_num % 4 == 0)
+					cout << worker_num << " workers : makespan " << rst.makespan << ", peak " << rst.peak_bytes << " bytes" << endl;
+				++run_num;
+			}
+		}
+		auto t1 = chrono::steady_clock::now();
+		cout << run_num << " simulations of " << fg_large.GetPassNodes().size() << " passes in "
+			<< chrono::duration<double, milli>(t1 - t0).count() << " ms" << endl;
+	}
+
+	cout << "------------------------[preallocated]------------------------" << endl;
+	{
+		// the root of the move chain isn't accessed, the chain is live from the start as in the memory report
+		UFG::FrameGraph fg_move("preallocated");
+		size_t pool = fg_move.RegisterResourceNode("Pool");
+		size_t target = fg_move.RegisterResourceNode("Target");
+		size_t other = fg_move.RegisterResourceNode("Other");
+		size_t token = fg_move.RegisterResourceNode("Token");
+		fg_move.SetResourceNodeSize(pool, big);
+		fg_move.SetResourceNodeSize(other, small);
+		fg_move.RegisterMoveNode(target, pool);
+		// Other is freed before Write, the preallocated chain overlaps it
+		fg_move.RegisterGeneralPassNode("Other", {}, { other });
+		fg_move.RegisterGeneralPassNode("Consume", { other }, { token });
+		fg_move.RegisterGeneralPassNode("Write", { token }, { target });
+		fg_move.RegisterGeneralPassNode("Read", { target }, {});
+
+		auto crst_move = compiler.Compile(fg_move);
+		auto report = crst_move.GetMemoryReport(fg_move);
+		Simulator simulator_move(fg_move, crst_move);
+		Simulator::Config config;
+		config.policy = Simulator::Policy::Order;
+		auto rst = simulator_move.Simulate(vector<double>(fg_move.GetPassNodes().size(), 1.), config);
+		Print(rst);
+		assert(rst.peak_bytes == report.peak_bytes);
+		assert(rst.peak_bytes == big + small);
+	}
+
+	cout << "------------------------[invalid config]------------------------" << endl;
+	{
+		auto rejects = [&](const Simulator::Config& config) {
+			try {
+				simulator.Simulate(costs, config);
+				return false;
+			}
+			catch (const std::logic_error& e) {
+				cout << e.what() << endl;
+				return true;
+			}
+		};
+
+		Simulator::Config no_worker;
+		no_worker.queue_worker_nums = { 2, 0 };
+		no_worker.pass2queue.assign(fg.GetPassNodes().size(), 0);
+		no_worker.pass2queue[produces[0]] = 1;
+		[[maybe_unused]] bool rejected_no_worker = rejects(no_worker);
+		assert(rejected_no_worker);
+		no_worker.pass2queue[produces[0]] = 0; // the empty queue is unused
+		simulator.Simulate(costs, no_worker);
+
+		Simulator::Config out_of_queues;
+		out_of_queues.pass2queue.assign(fg.GetPassNodes().size(), 0);
+		out_of_queues.pass2queue[produces[0]] = 1;
+		[[maybe_unused]] bool rejected_out_of_queues = rejects(out_of_queues);
+		assert(rejected_out_of_queues);
+
+		Simulator::Config short_pass2queue;
+		short_pass2queue.pass2queue.assign(1, 0);
+		[[maybe_unused]] bool rejected_short_pass2queue = rejects(short_pass2queue);
+		assert(rejected_short_pass2queue);
+	}
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <string>
+
+using namespace std;
+using namespace Ubpa;
+
+// the durations have 1% noise
+bool Near(double lhs, double rhs) { return abs(lhs - rhs) < 0.02 * rhs; }
+
+int main() {
+	UFG::FrameGraph fg("test 17 profile");
+	size_t ao = fg.RegisterResourceNode("AO");
+	size_t bloom = fg.RegisterResourceNode("Bloom");
+	size_t shadowmap = fg.RegisterResourceNode("Shadow Map");
+	size_t finaltarget = fg.RegisterResourceNode("Final Target");
+	size_t ssaoPass = fg.RegisterGeneralPassNode("SSAO", {}, { ao });
+	fg.RegisterGeneralPassNode("Bloom", {}, { bloom });
+	size_t shadowPass = fg.RegisterGeneralPassNode("Shadows", {}, { shadowmap });
+	size_t compositePass = fg.RegisterGeneralPassNode("Composite", { ao, bloom, shadowmap }, { finaltarget });
+
+	UFG::PassCostModel model;
+	UFG::Compiler compiler;
+	constexpr size_t worker_num = 2;
+
+	// measured durations of a frame, the executor records them after the frame
+	auto run_frames = [&](vector<double> truth, size_t frame_num) {
+		vector<double> durations(truth.size());
+		for (size_t frame = 0; frame < frame_num; frame++) {
+			for (size_t i = 0; i < truth.size(); i++)
+				durations[i] = truth[i] * (1. + 0.01 * static_cast<double>(frame % 3) - 0.01); // noise
+			model.Record(fg, durations);
+		}
+	};
+	auto compile = [&]() {
+		UFG::Compiler::Options options;
+		options.pass_costs = model.GetCosts(fg);
+		options.worker_num = worker_num;
+		return compiler.Compile(fg, options);
+	};
+	auto simulate = [&](const UFG::Compiler::Result& crst, const vector<double>& truth) {
+		UFG::ScheduleSimulator::Config config;
+		config.queue_worker_nums = { worker_num };
+		config.policy = UFG::ScheduleSimulator::Policy::Order;
+		return UFG::ScheduleSimulator(fg, crst).Simulate(truth, config).makespan;
+	};
+	auto print = [&](const UFG::Compiler::Result& crst) {
+		for (auto pass : crst.sorted_passes) {
+			cout << "  - " << fg.GetPassNodes()[pass].Name() << " : cost " << model.GetCost(fg.GetPassNodes()[pass].Name())
+				<< ", priority " << crst.pass2priority[pass] << ", worker " << crst.list_schedule.pass2worker[pass] << endl;
+		}
+		cout << "  estimated makespan " << crst.list_schedule.makespan << endl;
+	};
+
+	cout << "------------------------[unknown]------------------------" << endl;
+	{
+		assert(model.GetPassNum() == 0);
+		for ([[maybe_unused]] auto cost : model.GetCosts(fg))
+			assert(cost == 1.);
+		auto crst = compile();
+		print(crst);
+		// ties keep the order of the topological sort
+		assert(crst.sorted_passes == compiler.Compile(fg).sorted_passes);
+	}
+
+	cout << "------------------------[shadows heavy]------------------------" << endl;
+	vector<double> truth_shadows(fg.GetPassNodes().size(), 1.);
+	truth_shadows[shadowPass] = 2.;
+	truth_shadows[compositePass] = 0.5;
+	run_frames(truth_shadows, 30);
+	auto crst_shadows = compile();
+	print(crst_shadows);
+	assert(model.GetSampleNum("Shadows") == 30);
+	assert(Near(model.GetCost("Shadows"), 2.));
+	assert(crst_shadows.sorted_passes.front() == shadowPass);
+	assert(crst_shadows.sorted_passes.back() == compositePass);
+	assert(Near(crst_shadows.pass2priority[shadowPass], 2.5));
+	assert(Near(crst_shadows.pass2priority[compositePass], 0.5));
+	assert(Near(crst_shadows.list_schedule.makespan, 2.5));
+	assert(crst_shadows.list_schedule.worker2passes[crst_shadows.list_schedule.pass2worker[shadowPass]].size() <= 2);
+	assert(Near(simulate(crst_shadows, truth_shadows), 2.5));
+
+	cout << "------------------------[ssao heavy]------------------------" << endl;
+	vector<double> truth_ssao(fg.GetPassNodes().size(), 1.);
+	truth_ssao[ssaoPass] = 2.;
+	truth_ssao[compositePass] = 0.5;
+	run_frames(truth_ssao, 1);
+	assert(model.GetCost("Shadows") > model.GetCost("SSAO")); // smoothed, one frame doesn't flip the order
+	run_frames(truth_ssao, 30);
+	auto crst_ssao = compile();
+	print(crst_ssao);
+	assert(crst_ssao.sorted_passes.front() == ssaoPass);
+	assert(Near(crst_ssao.list_schedule.makespan, 2.5));
+	cout << "stale schedule " << simulate(crst_shadows, truth_ssao)
+		<< ", adapted schedule " << simulate(crst_ssao, truth_ssao) << endl;
+	assert(Near(simulate(crst_ssao, truth_ssao), 2.5));
+	assert(simulate(crst_shadows, truth_ssao) > simulate(crst_ssao, truth_ssao));
+
+	cout << "------------------------[new pass]------------------------" << endl;
+	{
+		UFG::FrameGraph fg2("new pass");
+		size_t rsrc = fg2.RegisterResourceNode("Final Target");
+		fg2.RegisterGeneralPassNode("Shadows", {}, {});
+		fg2.RegisterGeneralPassNode("Tonemap", {}, { rsrc });
+		auto costs = model.GetCosts(fg2);
+		assert(costs[0] == model.GetCost("Shadows"));
+		assert(!model.Contains("Tonemap"));
+		[[maybe_unused]] double mean = (model.GetCost("SSAO") + model.GetCost("Bloom") + model.GetCost("Shadows") + model.GetCost("Composite")) / 4;
+		assert(Near(costs[1], mean));
+		cout << "Tonemap : " << costs[1] << " (mean)" << endl;
+	}
+
+	cout << "------------------------[entry points]------------------------" << endl;
+	{
+		UFG::Compiler::Options options;
+		options.pass_costs = model.GetCosts(fg);
+		options.worker_num = worker_num;
+
+		// variants
+		const uint64_t masks[] = { 0 };
+		auto table = compiler.CompileVariants(fg, masks, options);
+		assert(table.Select(0).sorted_passes == crst_ssao.sorted_passes);
+		assert(table.Select(0).pass2priority == crst_ssao.pass2priority);
+		assert(Near(table.Select(0).list_schedule.makespan, 2.5));
+
+		// pruned : the cone of the AO keeps SSAO only
+		const size_t requested[] = { ao };
+		auto prst = compiler.Prune(fg, crst_ssao, requested, options);
+		assert(prst.sorted_passes == vector<size_t>{ ssaoPass });
+		assert(Near(prst.pass2priority[ssaoPass], 2.));
+		assert(prst.list_schedule.pass2worker[ssaoPass] == 0);
+		assert(prst.list_schedule.pass2worker[compositePass] == static_cast<size_t>(-1));
+		assert(Near(prst.list_schedule.makespan, 2.));
+		assert(prst.memory.level_num == 1);
+		assert(compiler.Prune(fg, crst_ssao, requested).list_schedule.worker2passes.empty());
+
+		// async
+		UFG::AsyncCompiler async;
+		auto snapshot = async.Submit(fg, options).get();
+		assert(snapshot && snapshot->result.sorted_passes == crst_ssao.sorted_passes);
+		assert(Near(snapshot->result.list_schedule.makespan, 2.5));
+	}
+
+	cout << "------------------------[mismatch]------------------------" << endl;
+	try {
+		UFG::Compiler::Options options;
+		options.pass_costs = { 1., 2. };
+		compiler.Compile(fg, options);
+		assert(false);
+	}
+	catch (const std::logic_error& e) {
+		cout << e.what() << endl;
+	}
+
+	return 0;
+}
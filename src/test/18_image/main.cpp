@@ -0,0 +1,287 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Ubpa;
+
+// unlike assert, kept in release builds (NDEBUG) : the checked calls write files and validate images
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			cerr << "check failed : " #cond " (line " << __LINE__ << ")" << endl; \
+			abort(); \
+		} \
+	} while (0)
+
+bool Equal(const UFG::FrameGraph& lhs, const UFG::FrameGraph& rhs) {
+	if (lhs.Name() != rhs.Name() || lhs.GetResourceNodes().size() != rhs.GetResourceNodes().size()
+		|| lhs.GetPassNodes().size() != rhs.GetPassNodes().size() || lhs.GetMoveNodes().size() != rhs.GetMoveNodes().size())
+		return false;
+	for (size_t i = 0; i < lhs.GetResourceNodes().size(); i++) {
+		const auto& l = lhs.GetResourceNodes()[i];
+		const auto& r = rhs.GetResourceNodes()[i];
+		if (l.Name() != r.Name() || l.GetSize() != r.GetSize() || l.GetHistoryVersions() != r.GetHistoryVersions()
+			|| l.GetHistoryNodeIndex() != r.GetHistoryNodeIndex() || l.GetHistoryAge() != r.GetHistoryAge()
+			|| rhs.GetResourceNodeIndex(l.Name()) != i)
+			return false;
+	}
+	for (size_t i = 0; i < lhs.GetPassNodes().size(); i++) {
+		const auto& l = lhs.GetPassNodes()[i];
+		const auto& r = rhs.GetPassNodes()[i];
+		if (l.Name() != r.Name() || l.GetType() != r.GetType() || l.GetCondition() != r.GetCondition() || l.IsPure() != r.IsPure()
+			|| !ranges::equal(lhs.GetPassNodeInputs(i), rhs.GetPassNodeInputs(i))
+			|| !ranges::equal(lhs.GetPassNodeOutputs(i), rhs.GetPassNodeOutputs(i))
+			|| rhs.GetPassNodeIndex(l.Name()) != i)
+			return false;
+	}
+	for (size_t i = 0; i < lhs.GetMoveNodes().size(); i++) {
+		const auto& l = lhs.GetMoveNodes()[i];
+		if (!rhs.IsRegisteredMoveNode(l.GetDestinationNodeIndex(), l.GetSourceNodeIndex()))
+			return false;
+	}
+	return true;
+}
+
+bool Equal(const UFG::Compiler::Result& lhs, const UFG::Compiler::Result& rhs) {
+	if (lhs.rsrcinfos.size() != rhs.rsrcinfos.size())
+		return false;
+	for (size_t i = 0; i < lhs.rsrcinfos.size(); i++) {
+		const auto& l = lhs.rsrcinfos[i];
+		const auto& r = rhs.rsrcinfos[i];
+		if (l.first != r.first || l.last != r.last || l.writer != r.writer || l.copy_in != r.copy_in || l.readers != r.readers)
+			return false;
+	}
+	if (lhs.pass2info.size() != rhs.pass2info.size())
+		return false;
+	for (const auto& [pass, l] : lhs.pass2info) {
+		auto target = rhs.pass2info.find(pass);
+		if (target == rhs.pass2info.end())
+			return false;
+		const auto& r = target->second;
+		if (l.construct_resources != r.construct_resources || l.destruct_resources != r.destruct_resources
+			|| l.move_resources != r.move_resources)
+			return false;
+	}
+	return lhs.passgraph.adjList == rhs.passgraph.adjList
+		&& lhs.sorted_passes == rhs.sorted_passes
+		&& lhs.pass2order == rhs.pass2order
+		&& lhs.moves_src2dst == rhs.moves_src2dst && lhs.moves_dst2src == rhs.moves_dst2src
+		&& lhs.copys_src2dst == rhs.copys_src2dst && lhs.copys_dst2src == rhs.copys_dst2src
+		&& lhs.memory.peak_bytes == rhs.memory.peak_bytes
+		&& lhs.memory.serialized_edge_num == rhs.memory.serialized_edge_num
+		&& lhs.memory.level_num_before == rhs.memory.level_num_before
+		&& lhs.memory.level_num == rhs.memory.level_num
+		&& lhs.pass2priority == rhs.pass2priority
+		&& lhs.list_schedule.worker2passes == rhs.list_schedule.worker2passes
+		&& lhs.list_schedule.pass2worker == rhs.list_schedule.pass2worker
+		&& lhs.list_schedule.makespan == rhs.list_schedule.makespan;
+}
+
+template<typename T>
+T& Record(vector<std::byte>& bytes, UFG::GraphImage::Section section, size_t idx) {
+	const auto& header = *reinterpret_cast<const UFG::GraphImage::Header*>(bytes.data());
+	return reinterpret_cast<T*>(bytes.data() + header.sections[section].offset)[idx];
+}
+
+int main() {
+#ifdef UFG_STRIP_NAMES
+	cout << "no image writer without the names, skipped (UFG_STRIP_NAMES)" << endl;
+#else
+	UFG::FrameGraph fg("test 18 image");
+
+	size_t depthbuffer = fg.RegisterResourceNode("Depth Buffer");
+	size_t depthbuffer2 = fg.RegisterResourceNode("Depth Buffer 2");
+	size_t gbuffer1 = fg.RegisterResourceNode("GBuffer1");
+	size_t gbuffer2 = fg.RegisterResourceNode("GBuffer2");
+	size_t lightingbuffer = fg.RegisterResourceNode("Lighting Buffer");
+	size_t exposure = fg.RegisterHistoryResourceNode("Exposure", 2);
+	size_t prevexposure = fg.RegisterPreviousResourceNode(exposure);
+	size_t acclightingbuffer = fg.RegisterResourceNode("Acc Lighting Buffer");
+	size_t copiedbuffer = fg.RegisterResourceNode("Copied Buffer");
+	size_t finaltarget = fg.RegisterResourceNode("Final Target");
+	size_t debugoutput = fg.RegisterResourceNode("Debug Output");
+	for (auto rsrc : { depthbuffer, gbuffer1, gbuffer2, lightingbuffer, acclightingbuffer, copiedbuffer })
+		fg.SetResourceNodeSize(rsrc, 4 << 20);
+
+	fg.RegisterGeneralPassNode("Depth pass", {}, { depthbuffer });
+	fg.RegisterMoveNode(depthbuffer2, depthbuffer);
+	fg.RegisterGeneralPassNode("GBuffer pass", {}, { depthbuffer2, gbuffer1, gbuffer2 });
+	size_t lighting = fg.RegisterGeneralPassNode("Lighting", { depthbuffer2, gbuffer1, gbuffer2 }, { lightingbuffer });
+	fg.RegisterGeneralPassNode("Exposure", { lightingbuffer, prevexposure }, { exposure });
+	fg.RegisterGeneralPassNode("TAA", { lightingbuffer, exposure }, { acclightingbuffer });
+	fg.RegisterCopyPassNode({ acclightingbuffer }, { copiedbuffer });
+	fg.RegisterGeneralPassNode("Post", { copiedbuffer }, { finaltarget });
+	size_t debug = fg.RegisterGeneralPassNode("Debug View", { gbuffer2 }, { debugoutput });
+	fg.SetPassNodeCondition(debug, 0);
+	fg.SetPassNodePure(lighting);
+
+	UFG::Compiler compiler;
+	UFG::Compiler::Options options;
+	options.pass_costs.assign(fg.GetPassNodes().size(), 1.);
+	options.pass_costs[lighting] = 3.;
+	options.worker_num = 2;
+	auto crst = compiler.Compile(fg, options);
+
+	cout << "------------------------[serialize]------------------------" << endl;
+	auto bytes = UFG::GraphImage::Serialize(fg, crst);
+	cout << bytes.size() << " bytes" << endl;
+	CHECK(bytes == UFG::GraphImage::Serialize(fg, crst)); // deterministic
+	{
+		auto image = UFG::GraphImage::View(bytes);
+		CHECK(image);
+		CHECK(image->Name() == fg.Name());
+		CHECK(image->GetResourceRecords().size() == fg.GetResourceNodes().size());
+		CHECK(image->GetPassRecords().size() == fg.GetPassNodes().size());
+
+		// views in place
+		const auto& record = image->GetPassRecords()[lighting];
+		CHECK(image->GetString(record.name) == "Lighting");
+		CHECK(image->GetPassResources(record.inputs).size() == 3);
+		CHECK(image->GetPassResources(record.outputs)[0] == lightingbuffer);
+		CHECK(image->GetSortedPasses().size() == crst.sorted_passes.size());
+		CHECK(image->GetSuccessors(lighting).size() == crst.passgraph.adjList.at(lighting).size());
+
+		auto fg2 = image->ToFrameGraph();
+		auto crst2 = image->ToResult();
+		CHECK(Equal(fg, fg2));
+		CHECK(Equal(crst, crst2));
+		// the same result as compiling the loaded graph
+		CHECK(Equal(compiler.Compile(fg2, options), crst2));
+		cout << "round trip" << endl;
+	}
+
+	cout << "------------------------[invalid]------------------------" << endl;
+	{
+		string error;
+		auto corrupted = bytes;
+		corrupted[corrupted.size() - 1] ^= std::byte{ 1 };
+		CHECK(!UFG::GraphImage::View(corrupted, true, &error));
+		cout << error << endl;
+
+		auto old_version = bytes;
+		reinterpret_cast<UFG::GraphImage::Header*>(old_version.data())->version = UFG::GraphImage::version + 1;
+		CHECK(!UFG::GraphImage::View(old_version, false, &error));
+		cout << error << endl;
+
+		// an index out of bounds is rejected even without the checksum
+		auto out_of_bounds = bytes;
+		auto& header = *reinterpret_cast<UFG::GraphImage::Header*>(out_of_bounds.data());
+		reinterpret_cast<uint32_t*>(out_of_bounds.data() + header.sections[UFG::GraphImage::SortedPasses].offset)[0] = 1000;
+		CHECK(!UFG::GraphImage::View(out_of_bounds, false, &error));
+		cout << error << endl;
+
+		// the header is covered by the checksum
+		auto corrupted_header = bytes;
+		reinterpret_cast<UFG::GraphImage::Header*>(corrupted_header.data())->peak_bytes++;
+		CHECK(!UFG::GraphImage::View(corrupted_header, true, &error));
+		cout << error << endl;
+		CHECK(UFG::GraphImage::View(corrupted_header, false));
+
+		// graphs the frame graph rejects
+		auto duplicate = bytes;
+		Record<UFG::GraphImage::ResourceRecord>(duplicate, UFG::GraphImage::Resources, gbuffer2).name
+			= Record<UFG::GraphImage::ResourceRecord>(duplicate, UFG::GraphImage::Resources, gbuffer1).name;
+		CHECK(!UFG::GraphImage::View(duplicate, false, &error));
+		cout << error << endl;
+
+		auto duplicate_pass = bytes;
+		Record<UFG::GraphImage::PassRecord>(duplicate_pass, UFG::GraphImage::Passes, debug).name
+			= Record<UFG::GraphImage::PassRecord>(duplicate_pass, UFG::GraphImage::Passes, lighting).name;
+		CHECK(!UFG::GraphImage::View(duplicate_pass, false, &error));
+		cout << error << endl;
+
+		auto uneven_copy = bytes;
+		Record<UFG::GraphImage::PassRecord>(uneven_copy, UFG::GraphImage::Passes, lighting).type
+			= static_cast<uint32_t>(UFG::PassNode::Type::Copy);
+		CHECK(!UFG::GraphImage::View(uneven_copy, false, &error));
+		cout << error << endl;
+
+		auto too_old = bytes;
+		Record<UFG::GraphImage::ResourceRecord>(too_old, UFG::GraphImage::Resources, prevexposure).age = 2;
+		CHECK(!UFG::GraphImage::View(too_old, false, &error));
+		cout << error << endl;
+
+		auto not_history = bytes;
+		Record<UFG::GraphImage::ResourceRecord>(not_history, UFG::GraphImage::Resources, prevexposure).history
+			= static_cast<uint32_t>(depthbuffer);
+		CHECK(!UFG::GraphImage::View(not_history, false, &error));
+		cout << error << endl;
+
+		auto one_version = bytes;
+		Record<UFG::GraphImage::ResourceRecord>(one_version, UFG::GraphImage::Resources, exposure).versions = 1;
+		CHECK(!UFG::GraphImage::View(one_version, false, &error));
+		cout << error << endl;
+
+		auto self_move = bytes;
+		Record<UFG::GraphImage::MoveRecord>(self_move, UFG::GraphImage::Moves, 0).dst = static_cast<uint32_t>(depthbuffer);
+		CHECK(!UFG::GraphImage::View(self_move, false, &error));
+		cout << error << endl;
+
+		CHECK(!UFG::GraphImage::View(std::span{ bytes }.first(16), false, &error));
+		cout << error << endl;
+
+		CHECK(!UFG::GraphImage::Open("not_exist.ufgb", true, &error));
+		cout << error << endl;
+	}
+
+	cout << "------------------------[file]------------------------" << endl;
+	{
+		// large static pipeline : layers of passes reading two resources of the previous layer
+		constexpr size_t layer_num = 100;
+		constexpr size_t width = 40;
+		auto t0 = chrono::steady_clock::now();
+		UFG::FrameGraph fg_large("large");
+		vector<size_t> prev, cur;
+		for (size_t layer = 0; layer < layer_num; layer++) {
+			cur.clear();
+			for (size_t i = 0; i < width; i++) {
+				size_t rsrc = fg_large.RegisterResourceNode("Resource " + to_string(layer) + " " + to_string(i));
+				fg_large.SetResourceNodeSize(rsrc, 1 << 20);
+				cur.push_back(rsrc);
+				vector<size_t> inputs;
+				if (!prev.empty())
+					inputs = { prev[i], prev[(i * 7 + 1) % width] };
+				fg_large.RegisterGeneralPassNode("Pass " + to_string(layer) + " " + to_string(i), inputs, std::array{ rsrc });
+			}
+			swap(prev, cur);
+		}
+		fg_large.RegisterGeneralPassNode("Present", prev, {});
+		auto crst_large = compiler.Compile(fg_large);
+		auto t1 = chrono::steady_clock::now();
+
+		const string path = "test_18_image.ufgb";
+		bool saved = UFG::GraphImage::Save(fg_large, crst_large, path);
+		CHECK(saved);
+
+		auto t2 = chrono::steady_clock::now();
+		string error;
+		auto image = UFG::GraphImage::Open(path, true, &error);
+		CHECK(image);
+		auto t3 = chrono::steady_clock::now();
+		auto crst_loaded = image->ToResult();
+		auto t4 = chrono::steady_clock::now();
+		auto fg_loaded = image->ToFrameGraph();
+		auto t5 = chrono::steady_clock::now();
+
+		CHECK(Equal(crst_large, crst_loaded));
+		CHECK(Equal(fg_large, fg_loaded));
+		cout << fg_large.GetPassNodes().size() << " passes, " << image->GetBytes().size() << " bytes" << endl
+			<< "register + compile : " << chrono::duration<double, micro>(t1 - t0).count() << " us" << endl
+			<< "open (map + checksum) : " << chrono::duration<double, micro>(t3 - t2).count() << " us" << endl
+			<< "to result : " << chrono::duration<double, micro>(t4 - t3).count() << " us" << endl
+			<< "to frame graph : " << chrono::duration<double, micro>(t5 - t4).count() << " us" << endl;
+
+		image.reset(); // unmap
+		remove(path.c_str());
+	}
+#endif // UFG_STRIP_NAMES
+
+	return 0;
+}
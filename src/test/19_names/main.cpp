@@ -0,0 +1,161 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Ubpa;
+
+int main() {
+	auto& table = UFG::NameTable::Instance();
+
+	cout << "------------------------[intern]------------------------" << endl;
+	{
+		[[maybe_unused]] auto id = table.Intern("GBuffer");
+		assert(id != UFG::NameTable::invalid_id);
+		[[maybe_unused]] auto reinterned = table.Intern(string{ "GBuffer" });
+		assert(reinterned == id);
+		assert(table.Find("GBuffer") == id);
+		assert(table.Find("not interned") == UFG::NameTable::invalid_id);
+#ifndef UFG_STRIP_NAMES
+		assert(table.GetName(id) == "GBuffer");
+		assert(table.GetLabel(id) == "GBuffer");
+#else
+		// the outputs (graphviz, svg, trace, errors) still tell the names apart
+		char hash[17];
+		snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(UFG::NameTable::Hash("GBuffer")));
+		assert(table.GetLabel(id) == "#" + string{ hash });
+		[[maybe_unused]] auto other = table.Intern("GBuffer pass");
+		assert(table.GetLabel(other) != table.GetLabel(id));
+#endif
+		assert(table.GetHash(id) == UFG::NameTable::Hash("GBuffer"));
+	}
+
+	cout << "------------------------[derived]------------------------" << endl;
+	{
+		// a derived name is the same name as the concatenation, also without the strings (UFG_STRIP_NAMES)
+		auto prefix = table.Intern("Exposure");
+		[[maybe_unused]] auto derived = table.Intern(prefix, "#Prev1");
+		assert(table.Find("Exposure#Prev1") == derived);
+		assert(table.GetHash(derived) == UFG::NameTable::Hash("Exposure#Prev1"));
+
+		UFG::FrameGraph fg("history");
+		size_t exposure = fg.RegisterHistoryResourceNode("Exposure", 3);
+		size_t luminance = fg.RegisterHistoryResourceNode("Luminance", 3);
+		[[maybe_unused]] size_t prevexposure = fg.RegisterPreviousResourceNode(exposure);
+		[[maybe_unused]] size_t prevluminance = fg.RegisterPreviousResourceNode(luminance);
+		[[maybe_unused]] size_t prev2luminance = fg.RegisterPreviousResourceNode(luminance, 2);
+		assert(fg.GetResourceNodeIndex("Exposure#Prev1") == prevexposure);
+		assert(fg.GetResourceNodeIndex("Luminance#Prev1") == prevluminance);
+		assert(fg.GetResourceNodeIndex("Luminance#Prev2") == prev2luminance);
+	}
+
+	cout << "------------------------[frame graph]------------------------" << endl;
+	UFG::FrameGraph fg("test 19 names");
+	[[maybe_unused]] size_t depthbuffer = fg.RegisterResourceNode("Depth Buffer");
+	[[maybe_unused]] size_t gbuffer = fg.RegisterResourceNode("GBuffer");
+	[[maybe_unused]] size_t lightingbuffer = fg.RegisterResourceNode("Lighting Buffer");
+	[[maybe_unused]] size_t copiedbuffer = fg.RegisterResourceNode("Copied Buffer");
+	[[maybe_unused]] size_t finaltarget = fg.RegisterResourceNode("Final Target");
+
+	// the name overloads
+	[[maybe_unused]] size_t gbufferPass = fg.RegisterGeneralPassNode("GBuffer pass",
+		array<string_view, 0>{}, array<string_view, 2>{ "Depth Buffer", "GBuffer" });
+	[[maybe_unused]] size_t lightingPass = fg.RegisterGeneralPassNode("Lighting",
+		array<string_view, 2>{ "Depth Buffer", "GBuffer" }, array<string_view, 1>{ "Lighting Buffer" });
+	[[maybe_unused]] size_t copyPass = fg.RegisterCopyPassNode(
+		array<string_view, 1>{ "Lighting Buffer" }, array<string_view, 1>{ "Copied Buffer" });
+	[[maybe_unused]] size_t postPass = fg.RegisterPassNode(UFG::PassNode::Type::General, "Post",
+		array<string_view, 1>{ "Copied Buffer" }, array<string_view, 1>{ "Final Target" });
+
+	assert(fg.GetPassNodeOutputs(gbufferPass)[1] == gbuffer);
+	assert(fg.GetPassNodeInputs(lightingPass)[0] == depthbuffer);
+	assert(fg.GetPassNodeOutputs(lightingPass)[0] == lightingbuffer);
+	assert(fg.GetPassNodes()[copyPass].GetType() == UFG::PassNode::Type::Copy);
+	assert(fg.GetPassNodeIndex("Copy#2") == copyPass);
+	assert(fg.GetPassNodeOutputs(copyPass)[0] == copiedbuffer);
+	assert(fg.GetPassNodeOutputs(postPass)[0] == finaltarget);
+	assert(fg.GetPassNodeIndex("Lighting") == lightingPass);
+	assert(fg.IsRegisteredResourceNode("GBuffer") && !fg.IsRegisteredResourceNode("GBuffer2"));
+	assert(!fg.IsRegisteredPassNode("GBuffer")); // separate indices of the resources and the passes
+
+	// the nodes of the same name share the interned ID across the graphs
+	assert(fg.GetResourceNodes()[gbuffer].GetNameID() == table.Find("GBuffer"));
+	UFG::FrameGraph fg2("other");
+	[[maybe_unused]] size_t othergbuffer = fg2.RegisterResourceNode("GBuffer");
+	assert(fg2.GetResourceNodes()[othergbuffer].GetNameID() == fg.GetResourceNodes()[gbuffer].GetNameID());
+
+	UFG::Compiler compiler;
+	auto crst = compiler.Compile(fg);
+	for (auto pass : crst.sorted_passes)
+		cout << "  - " << fg.GetPassNodes()[pass].Name() << endl;
+
+	fg.Clear();
+	assert(!fg.IsRegisteredResourceNode("GBuffer"));
+
+	cout << "------------------------[concurrent]------------------------" << endl;
+	{
+		// graphs built on several threads intern the same names
+		constexpr size_t thread_num = 4;
+		constexpr size_t name_num = 2000;
+		vector<vector<UFG::NameTable::ID>> ids(thread_num);
+		vector<thread> threads;
+		for (size_t t = 0; t < thread_num; t++) {
+			threads.emplace_back([&, t]() {
+				UFG::FrameGraph local("thread " + to_string(t));
+				for (size_t i = 0; i < name_num; i++) {
+					size_t rsrc = local.RegisterResourceNode("Shared " + to_string(i));
+					ids[t].push_back(local.GetResourceNodes()[rsrc].GetNameID());
+					assert(local.GetResourceNodeIndex("Shared " + to_string(i)) == rsrc);
+				}
+			});
+		}
+		for (auto& t : threads)
+			t.join();
+		for (size_t t = 1; t < thread_num; t++)
+			assert(ids[t] == ids[0]);
+		for (size_t i = 0; i < name_num; i++) {
+			assert(table.Find("Shared " + to_string(i)) == ids[0][i]);
+#ifndef UFG_STRIP_NAMES
+			assert(table.GetName(ids[0][i]) == "Shared " + to_string(i));
+#endif
+		}
+		cout << "consistent IDs" << endl;
+	}
+
+	cout << "------------------------[lookup]------------------------" << endl;
+	{
+		constexpr size_t rsrc_num = 10000;
+		UFG::FrameGraph large("large");
+		vector<string> names;
+		for (size_t i = 0; i < rsrc_num; i++)
+			names.push_back("Resource " + to_string(i));
+
+		auto t0 = chrono::steady_clock::now();
+		for (const auto& name : names)
+			large.RegisterResourceNode(name);
+		auto t1 = chrono::steady_clock::now();
+		size_t sum = 0;
+		for (size_t round = 0; round < 10; round++) {
+			for (const auto& name : names)
+				sum += large.GetResourceNodeIndex(name);
+		}
+		auto t2 = chrono::steady_clock::now();
+		assert(sum == 10 * rsrc_num * (rsrc_num - 1) / 2);
+
+		auto stats = table.GetStats();
+		cout << "register : " << chrono::duration<double, nano>(t1 - t0).count() / rsrc_num << " ns per node" << endl
+			<< "lookup : " << chrono::duration<double, nano>(t2 - t1).count() / (10 * rsrc_num) << " ns per name" << endl
+			<< "interned : " << stats.name_num << " names, " << stats.string_bytes << " string bytes, "
+			<< stats.table_bytes << " table bytes" << endl;
+		assert(stats.name_num >= rsrc_num);
+	}
+
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Ubpa;
+
+UFG::FrameGraph BuildChain(size_t pass_num) {
+	UFG::FrameGraph fg("chain");
+	vector<size_t> rsrcs;
+	for (size_t i = 0; i <= pass_num; i++)
+		rsrcs.push_back(fg.RegisterResourceNode("Buffer " + to_string(i)));
+	for (size_t i = 0; i < pass_num; i++)
+		fg.RegisterGeneralPassNode("Pass " + to_string(i), { rsrcs[i] }, { rsrcs[i + 1] });
+	return fg;
+}
+
+bool IsChain(const UFG::FrameGraph& fg) {
+	for (size_t i = 0; i < fg.GetPassNodes().size(); i++) {
+		if (fg.GetPassNodeInputs(i).size() != 1 || fg.GetPassNodeInputs(i)[0] != i
+			|| fg.GetPassNodeOutputs(i).size() != 1 || fg.GetPassNodeOutputs(i)[0] != i + 1)
+			return false;
+	}
+	return true;
+}
+
+int main() {
+	cout << "------------------------[packed]------------------------" << endl;
+	{
+		UFG::FrameGraph fg("test 20 edges");
+		size_t a = fg.RegisterResourceNode("A");
+		size_t b = fg.RegisterResourceNode("B");
+		size_t c = fg.RegisterResourceNode("C");
+		[[maybe_unused]] size_t p0 = fg.RegisterGeneralPassNode("P0", {}, { a, b });
+		[[maybe_unused]] size_t p1 = fg.RegisterGeneralPassNode("P1", { a, b }, { c });
+		[[maybe_unused]] size_t p2 = fg.RegisterCopyPassNode({ c }, { a });
+
+		assert(fg.GetPassNodeInputs(p0).empty() && fg.GetPassNodeOutputs(p0).size() == 2);
+		// [inputs..., outputs...] of the passes in order
+		assert(fg.GetPassNodeOutputs(p0).data() + 2 == fg.GetPassNodeInputs(p1).data());
+		assert(fg.GetPassNodeInputs(p1).data() + 2 == fg.GetPassNodeOutputs(p1).data());
+		assert(fg.GetPassNodeOutputs(p1).data() + 1 == fg.GetPassNodeInputs(p2).data());
+		assert(fg.GetPassNodeOutputs(p2)[0] == a);
+	}
+
+	cout << "------------------------[copy]------------------------" << endl;
+	{
+		// the edges reallocate many times while building
+		UFG::FrameGraph fg = BuildChain(1000);
+		assert(IsChain(fg));
+
+		UFG::FrameGraph copied = fg;
+		UFG::FrameGraph assigned("assigned");
+		assigned = copied;
+		fg.Clear();
+		copied.Clear();
+		assert(IsChain(assigned) && assigned.GetPassNodes().size() == 1000);
+
+		UFG::FrameGraph moved = std::move(assigned);
+		assert(IsChain(moved));
+
+		UFG::Compiler compiler;
+		auto crst = compiler.Compile(moved);
+		assert(crst.sorted_passes.size() == 1000);
+	}
+
+	cout << "------------------------[build]------------------------" << endl;
+	{
+		constexpr size_t pass_num = 100000;
+		auto t0 = chrono::steady_clock::now();
+		auto fg = BuildChain(pass_num);
+		auto t1 = chrono::steady_clock::now();
+		UFG::Compiler compiler;
+		auto crst = compiler.Compile(fg);
+		auto t2 = chrono::steady_clock::now();
+		assert(crst.sorted_passes.size() == pass_num);
+		cout << "build : " << chrono::duration<double, nano>(t1 - t0).count() / pass_num << " ns per pass" << endl
+			<< "compile : " << chrono::duration<double, nano>(t2 - t1).count() / pass_num << " ns per pass" << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include <UFG/UFG.hpp>
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Ubpa;
+
+int main() {
+	cout << "------------------------[unaccessed moves]------------------------" << endl;
+	{
+		// Source -> Moved 0 -> ... -> Moved n-1 -> Destination, nobody accesses the moved ones
+		for (size_t move_num = 2; move_num <= 6; move_num++) {
+			UFG::FrameGraph fg("test 21 moves");
+			size_t src = fg.RegisterResourceNode("Source");
+			vector<size_t> moveds;
+			for (size_t i = 0; i + 1 < move_num; i++)
+				moveds.push_back(fg.RegisterResourceNode("Moved " + to_string(i)));
+			size_t dst = fg.RegisterResourceNode("Destination");
+			[[maybe_unused]] size_t write = fg.RegisterGeneralPassNode("Write", {}, { src });
+			[[maybe_unused]] size_t read = fg.RegisterGeneralPassNode("Read", { dst }, {});
+
+			// registered in reverse, the pruning must not depend on the order of the moves
+			size_t prev = src;
+			vector<pair<size_t, size_t>> moves;
+			for (auto moved : moveds) {
+				moves.emplace_back(moved, prev);
+				prev = moved;
+			}
+			moves.emplace_back(dst, prev);
+			for (auto iter = moves.rbegin(); iter != moves.rend(); ++iter)
+				fg.RegisterMoveNode(iter->first, iter->second);
+
+			UFG::Compiler compiler;
+			auto crst = compiler.Compile(fg);
+
+			// one move into the final destination
+			assert(crst.moves_src2dst.size() == 1);
+			assert(crst.moves_src2dst.at(src) == dst);
+			assert(crst.moves_dst2src.size() == 1);
+			assert(crst.moves_dst2src.at(dst) == src);
+			assert(crst.sorted_passes == (vector<size_t>{ write, read }));
+			assert(crst.pass2info.at(write).move_resources == vector<size_t>{ src });
+			assert(crst.pass2info.at(read).destruct_resources == vector<size_t>{ dst });
+			for ([[maybe_unused]] auto moved : moveds)
+				assert(crst.rsrcinfos[moved].first == static_cast<size_t>(-1));
+			cout << move_num << " moves : " << fg.GetResourceNodes()[src].Name() << " -> "
+				<< fg.GetResourceNodes()[crst.moves_src2dst.at(src)].Name() << endl;
+		}
+	}
+
+	cout << "------------------------[accessed moves]------------------------" << endl;
+	{
+		// a read in the middle of the chain keeps the moves around it
+		UFG::FrameGraph fg("accessed");
+		size_t a = fg.RegisterResourceNode("A");
+		size_t b = fg.RegisterResourceNode("B");
+		size_t c = fg.RegisterResourceNode("C");
+		size_t d = fg.RegisterResourceNode("D");
+		fg.RegisterGeneralPassNode("Write", {}, { a });
+		fg.RegisterGeneralPassNode("Read B", { b }, {});
+		fg.RegisterGeneralPassNode("Read D", { d }, {});
+		fg.RegisterMoveNode(b, a);
+		fg.RegisterMoveNode(c, b);
+		fg.RegisterMoveNode(d, c);
+
+		UFG::Compiler compiler;
+		auto crst = compiler.Compile(fg);
+		assert(crst.moves_src2dst.size() == 2);
+		assert(crst.moves_src2dst.at(a) == b);
+		assert(crst.moves_src2dst.at(b) == d);
+		assert(!crst.moves_dst2src.contains(c));
+	}
+
+	return 0;
+}